@@ -18,4 +18,17 @@
 #	endif
 #endif
 
+//storage class of per thread variables; plain data only
+#if defined ( VOX_MSVC )
+#	define VOX_THREAD_LOCAL __declspec(thread)
+#else
+#	define VOX_THREAD_LOCAL __thread
+#endif
+
+//profiling scopes cost a few ns each and stay in release builds; define
+//VOX_NO_PROFILE to compile them out entirely
+#if !defined( VOX_NO_PROFILE )
+#	define VOX_PROFILE
+#endif
+
 #endif //VOX_COMMON_CONFIG_HPP
@@ -0,0 +1,124 @@
+#include "common.hpp"
+#include "bufferHeap.hpp"
+
+namespace gl = ::vox::gl;
+
+gl::BufferHeap::BufferHeap(unsigned capacity, unsigned alignment)
+	: buffer_(new buffer_t())
+	, ranges_(capacity, alignment)
+	, generation_(0)
+{
+	detail::bindBuffer(BUFFER_TARGET_COPY_WRITE, buffer_->id());
+	detail::bufferData(BUFFER_TARGET_COPY_WRITE, ranges_.capacity(), nullptr, BUFFER_USAGE_STATIC_DRAW);
+}
+
+gl::BufferHeap::handle_t
+gl::BufferHeap::allocate(unsigned size, GLvoid const* data)
+{
+	size_t offset = 0;
+	while (!ranges_.allocate(size, offset)) {
+		replace_(std::max(capacity() * 2, capacity() + size), false);
+	}
+
+	handle_t handle;
+	if (freeHandles_.empty()) {
+		handle = static_cast<handle_t>(blocks_.size());
+		blocks_.push_back(Block());
+	} else {
+		handle = freeHandles_.back();
+		freeHandles_.pop_back();
+	}
+
+	Block& block = blocks_[handle];
+	block.offset = static_cast<unsigned>(offset);
+	block.size   = size;
+	block.live   = true;
+
+	if (data) {
+		setData(handle, size, data);
+	}
+
+	return handle;
+}
+
+void
+gl::BufferHeap::free(handle_t const handle)
+{
+	assert(handle < blocks_.size() && blocks_[handle].live);
+
+	ranges_.free(blocks_[handle].offset);
+	blocks_[handle].live = false;
+	freeHandles_.push_back(handle);
+}
+
+void
+gl::BufferHeap::setData(handle_t const handle, unsigned size, GLvoid const* data)
+{
+	assert(handle < blocks_.size() && blocks_[handle].live);
+	assert(size <= blocks_[handle].size);
+
+	detail::bindBuffer(BUFFER_TARGET_COPY_WRITE, id());
+	detail::bufferSubData(BUFFER_TARGET_COPY_WRITE, blocks_[handle].offset, size, data);
+}
+
+void
+gl::BufferHeap::defragment()
+{
+	replace_(capacity(), true);
+}
+
+void
+gl::BufferHeap::replace_(unsigned const capacity, bool const pack)
+{
+	std::unique_ptr<buffer_t> buffer(new buffer_t());
+
+	detail::bindBuffer(BUFFER_TARGET_COPY_READ, id());
+	detail::bindBuffer(BUFFER_TARGET_COPY_WRITE, buffer->id());
+	detail::bufferData(BUFFER_TARGET_COPY_WRITE, capacity, nullptr, BUFFER_USAGE_STATIC_DRAW);
+
+	if (pack) {
+		//the moves are planned for a copy in place, but here every block goes
+		//to a different buffer so blocks that stay put are copied too
+		std::vector<unsigned> oldOffsets(blocks_.size());
+		for (size_t i = 0; i < blocks_.size(); ++i) {
+			oldOffsets[i] = blocks_[i].offset;
+		}
+
+		auto const moves = ranges_.compact();
+
+		std::map<size_t, size_t> moved; //old offset -> new offset
+		for (auto it = moves.begin(); it != moves.end(); ++it) {
+			moved[it->from] = it->to;
+		}
+
+		for (size_t i = 0; i < blocks_.size(); ++i) {
+			if (!blocks_[i].live) {
+				continue;
+			}
+
+			auto const it = moved.find(oldOffsets[i]);
+			unsigned const to = it == moved.end() ? oldOffsets[i] : static_cast<unsigned>(it->second);
+
+			detail::copyBufferSubData(
+				BUFFER_TARGET_COPY_READ, BUFFER_TARGET_COPY_WRITE,
+				oldOffsets[i], to, ranges_.sizeOf(to)
+			);
+
+			blocks_[i].offset = to;
+		}
+	} else {
+		if (ranges_.used() > 0) {
+			detail::copyBufferSubData(
+				BUFFER_TARGET_COPY_READ, BUFFER_TARGET_COPY_WRITE,
+				0, 0, ranges_.capacity()
+			);
+		}
+
+		ranges_.grow(capacity);
+	}
+
+	detail::unbindBuffer(BUFFER_TARGET_COPY_READ);
+
+	buffer_ = std::move(buffer);
+	++generation_;
+}
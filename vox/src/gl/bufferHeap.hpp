@@ -0,0 +1,77 @@
+#pragma once
+#ifndef BKENTEL_VOX_GL_BUFFER_HEAP_HPP
+#define BKENTEL_VOX_GL_BUFFER_HEAP_HPP
+
+#include <vector>
+#include <boost/utility.hpp>
+
+#include "vgl.hpp"
+#include "../util/rangeAllocator.hpp"
+
+namespace vox {
+	namespace gl {
+
+		////////////////////////////////////////////////////////////////////////////////
+		// Many variable sized blocks packed into one static draw buffer, so
+		// everything in the heap can be drawn from a single vertex array with
+		// the block's offset as the first vertex.
+		//
+		// When nothing fits, the buffer is replaced by one twice the size and
+		// the blocks are copied across on the GPU; defragment() does the same
+		// into a buffer of the same size with the blocks packed to the front.
+		// Either way offsets change and buffer() returns a new buffer, which
+		// generation() reports so vertex arrays can be pointed at it again.
+		// Blocks are named by handles that stay valid across both.
+		//
+		// All data moves go through the copy read and copy write targets and
+		// leave the array buffer binding alone.
+		////////////////////////////////////////////////////////////////////////////////
+		class BufferHeap : private ::boost::noncopyable {
+		public:
+			typedef unsigned handle_t;
+
+			//capacity and block sizes are in bytes, offsets multiples of alignment
+			explicit BufferHeap(unsigned capacity, unsigned alignment = 1);
+
+			//a block of size bytes holding data; data may be nullptr
+			handle_t allocate(unsigned size, GLvoid const* data);
+			void free(handle_t block);
+
+			//replace size bytes at the start of the block
+			void setData(handle_t block, unsigned size, GLvoid const* data);
+
+			unsigned offset(handle_t block) const { return blocks_[block].offset; }
+			unsigned size(handle_t block)   const { return blocks_[block].size; }
+
+			//pack every block to the front of a new buffer
+			void defragment();
+
+			//free bytes that can't be used for the biggest request that fits
+			unsigned wasted()   const { return static_cast<unsigned>(ranges_.wasted()); }
+			unsigned used()     const { return static_cast<unsigned>(ranges_.used()); }
+			unsigned capacity() const { return static_cast<unsigned>(ranges_.capacity()); }
+
+			BufferId id()         const { return buffer_->id(); }
+			unsigned generation() const { return generation_; }
+		private:
+			typedef Buffer<BUFFER_USAGE_STATIC_DRAW> buffer_t;
+
+			struct Block {
+				unsigned offset;
+				unsigned size;
+				bool     live;
+			};
+
+			void replace_(unsigned capacity, bool pack);
+
+			::std::unique_ptr<buffer_t>	buffer_;
+			util::RangeAllocator		ranges_;
+			::std::vector<Block>		blocks_;
+			::std::vector<handle_t>		freeHandles_;
+			unsigned					generation_;
+		};
+
+	} //namespace gl
+} //namespace vox
+
+#endif //BKENTEL_VOX_GL_BUFFER_HEAP_HPP
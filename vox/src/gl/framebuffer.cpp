@@ -0,0 +1,58 @@
+#include "common.hpp"
+#include "framebuffer.hpp"
+
+namespace gl = ::vox::gl;
+
+gl::RenderTarget::RenderTarget(unsigned width, unsigned height)
+	: framebuffer_()
+	, color_()
+	, depth_(TEXTURE_FORMAT_DEPTH24_STENCIL8, width, height)
+{
+	color_.setStorage(TEXTURE_FORMAT_RGBA8, width, height, 1, 1);
+	attach_();
+}
+
+void
+gl::RenderTarget::resize(unsigned width, unsigned height)
+{
+	if (width == this->width() && height == this->height()) {
+		return;
+	}
+
+	//storage is immutable, so the size comes with new objects
+	Texture2D color;
+	color.setStorage(TEXTURE_FORMAT_RGBA8, width, height, 1, 1);
+
+	color_ = std::move(color);
+	depth_ = Renderbuffer(TEXTURE_FORMAT_DEPTH24_STENCIL8, width, height);
+
+	attach_();
+}
+
+void
+gl::RenderTarget::present(unsigned width, unsigned height) const
+{
+	framebuffer_.bind(FRAMEBUFFER_TARGET_READ);
+	Framebuffer::bindDefault(FRAMEBUFFER_TARGET_DRAW);
+
+	bool const scaled = width != this->width() || height != this->height();
+
+	detail::blitFramebuffer(
+		0, 0, this->width(), this->height(),
+		0, 0, width, height,
+		GL_COLOR_BUFFER_BIT, scaled ? TEXTURE_FILTER_LINEAR : TEXTURE_FILTER_NEAREST
+	);
+
+	Framebuffer::bindDefault();
+}
+
+void
+gl::RenderTarget::attach_()
+{
+	color_.setFilter(TEXTURE_FILTER_LINEAR, TEXTURE_FILTER_LINEAR);
+	color_.setWrap(TEXTURE_WRAP_CLAMP_TO_EDGE, TEXTURE_WRAP_CLAMP_TO_EDGE);
+
+	framebuffer_.attach(ATTACHMENT_COLOR0, color_);
+	framebuffer_.attach(ATTACHMENT_DEPTH_STENCIL, depth_);
+	framebuffer_.validate();
+}
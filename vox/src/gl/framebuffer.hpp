@@ -0,0 +1,158 @@
+#pragma once
+#ifndef BKENTEL_VOX_GL_FRAMEBUFFER_HPP
+#define BKENTEL_VOX_GL_FRAMEBUFFER_HPP
+
+#include <boost/utility.hpp>
+
+#include "wrappedgl.hpp"
+#include "texture.hpp"
+
+namespace vox {
+	namespace gl {
+
+		////////////////////////////////////////////////////////////////////////////////
+		// Represents an opengl renderbuffer: storage for a framebuffer attachment
+		// that is only ever drawn to, never sampled.
+		////////////////////////////////////////////////////////////////////////////////
+		class Renderbuffer : private ::boost::noncopyable {
+		public:
+			Renderbuffer(TextureFormat format, unsigned width, unsigned height)
+				: id_(detail::genRenderbuffer())
+				, format_(format)
+				, width_(width)
+				, height_(height)
+			{
+				detail::bindRenderbuffer(id());
+				detail::renderbufferStorage(format, width, height);
+			}
+
+			Renderbuffer(Renderbuffer&& other)
+				: id_(std::move(other.id_))
+				, format_(other.format_)
+				, width_(other.width_)
+				, height_(other.height_)
+			{
+			}
+
+			Renderbuffer& operator=(Renderbuffer&& rhs) {
+				id_     = std::move(rhs.id_);
+				format_ = rhs.format_;
+				width_  = rhs.width_;
+				height_ = rhs.height_;
+				return *this;
+			}
+
+			TextureFormat	format() const { return format_; }
+			unsigned		width()  const { return width_; }
+			unsigned		height() const { return height_; }
+
+			RenderbufferId id() const { return id_.get(); }
+		private:
+			RenderbufferId::unique_t	id_;
+			TextureFormat				format_;
+			unsigned					width_;
+			unsigned					height_;
+		};
+
+		////////////////////////////////////////////////////////////////////////////////
+		// Represents an opengl framebuffer object. Attachments aren't owned; they
+		// must outlive their use through the framebuffer.
+		////////////////////////////////////////////////////////////////////////////////
+		class Framebuffer : private ::boost::noncopyable {
+		public:
+			Framebuffer()
+				: id_(detail::genFramebuffer())
+			{
+			}
+
+			Framebuffer(Framebuffer&& other)
+				: id_(std::move(other.id_))
+			{
+			}
+
+			Framebuffer& operator=(Framebuffer&& rhs) {
+				id_ = std::move(rhs.id_);
+				return *this;
+			}
+
+			//leaves the framebuffer bound
+			void attach(FramebufferAttachment attachment, Texture2D const& texture, unsigned level = 0) {
+				bind();
+				detail::framebufferTexture(FRAMEBUFFER_TARGET_BOTH, attachment, texture.id(), level);
+			}
+
+			//leaves the framebuffer bound
+			void attach(FramebufferAttachment attachment, Renderbuffer const& renderbuffer) {
+				bind();
+				detail::framebufferRenderbuffer(FRAMEBUFFER_TARGET_BOTH, attachment, renderbuffer.id());
+			}
+
+			//GL_FRAMEBUFFER_COMPLETE or the reason it can't be drawn to
+			GLenum status() const {
+				bind();
+				return detail::checkFramebufferStatus(FRAMEBUFFER_TARGET_BOTH);
+			}
+
+			//throws error::incomplete_framebuffer unless it can be drawn to
+			void validate() const {
+				GLenum const result = status();
+
+				if (result != GL_FRAMEBUFFER_COMPLETE) {
+					BOOST_THROW_EXCEPTION(error::incomplete_framebuffer()
+						<< error::framebuffer_id(id())
+						<< error::framebuffer_status(result)
+					);
+				}
+			}
+
+			void bind(FramebufferTarget target = FRAMEBUFFER_TARGET_BOTH) const {
+				detail::bindFramebuffer(target, id());
+			}
+
+			//back to the window's framebuffer
+			static void bindDefault(FramebufferTarget target = FRAMEBUFFER_TARGET_BOTH) {
+				detail::bindFramebuffer(target);
+			}
+
+			FramebufferId id() const { return id_.get(); }
+		private:
+			FramebufferId::unique_t id_;
+		};
+
+		////////////////////////////////////////////////////////////////////////////////
+		// An offscreen place to draw a frame: an RGBA8 color texture and a
+		// depth/stencil renderbuffer behind one framebuffer. The color texture
+		// can be sampled for post-processing or blitted, scaled, to the window.
+		////////////////////////////////////////////////////////////////////////////////
+		class RenderTarget : private ::boost::noncopyable {
+		public:
+			//throws error::incomplete_framebuffer if the driver can't draw to it
+			RenderTarget(unsigned width, unsigned height);
+
+			//replace the attachments with ones of the new size; the contents are lost
+			void resize(unsigned width, unsigned height);
+
+			void bind(FramebufferTarget target = FRAMEBUFFER_TARGET_BOTH) const {
+				framebuffer_.bind(target);
+			}
+
+			//copy the color to (0, 0)-(width, height) of the window's back buffer,
+			//filtered if the sizes differ; leaves the window's framebuffer bound
+			void present(unsigned width, unsigned height) const;
+
+			Texture2D const& color() const { return color_; }
+
+			unsigned width()  const { return color_.width(); }
+			unsigned height() const { return color_.height(); }
+		private:
+			void attach_();
+
+			Framebuffer		framebuffer_;
+			Texture2D		color_;
+			Renderbuffer	depth_;
+		};
+
+	} //namespace gl
+} //namespace vox
+
+#endif //BKENTEL_VOX_GL_FRAMEBUFFER_HPP
@@ -437,6 +437,24 @@ namespace vox {
 				static gl::BufferUsage const	usage	= usage_t;
 			};
 
+			///////////////////////////////////////////////////////////////////
+			// texture object traits
+			///////////////////////////////////////////////////////////////////
+			template <gl::TextureTarget target_t>
+			struct texture {
+				static_assert(
+					target_t != gl::TEXTURE_2DM && target_t != gl::TEXTURE_2DMA,
+					"multisample textures have no mip levels or sub image upload"
+				);
+
+				static gl::TextureTarget const	target		= target_t;
+
+				//dimensions of the storage, array layers included
+				static unsigned const			dimensions	=
+					target_t == gl::TEXTURE_1D ? 1 :
+					target_t == gl::TEXTURE_3D || target_t == gl::TEXTURE_2DA ? 3 : 2;
+			};
+
 			///////////////////////////////////////////////////////////////////
 			// element<> specializations
 			///////////////////////////////////////////////////////////////////
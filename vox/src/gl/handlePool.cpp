@@ -0,0 +1,100 @@
+#include "common.hpp"
+#include "handlePool.hpp"
+
+namespace detail	= ::vox::gl::detail;
+namespace gl		= ::vox::gl;
+
+namespace {
+	//the context a thread has current is per thread, so are its pools
+	VOX_THREAD_LOCAL gl::HandlePools* currentPools = nullptr;
+} //namespace anon
+
+gl::HandlePools::HandlePools(unsigned batchSize)
+	: buffers(batchSize)
+	, arrays(batchSize)
+	, textures(batchSize)
+{
+}
+
+gl::HandlePools::~HandlePools()
+{
+	if (currentPools == this) {
+		currentPools = nullptr;
+	}
+}
+
+gl::HandlePools*
+gl::HandlePools::current()
+{
+	return currentPools;
+}
+
+void
+gl::HandlePools::makeCurrent(HandlePools* pools)
+{
+	currentPools = pools;
+}
+
+void
+gl::HandlePools::flush()
+{
+	buffers.flush();
+	arrays.flush();
+	textures.flush();
+}
+
+void
+gl::HandlePools::clear()
+{
+	buffers.clear();
+	arrays.clear();
+	textures.clear();
+}
+
+gl::BufferId
+detail::acquireBuffer()
+{
+	return currentPools ? currentPools->buffers.acquire() : genBuffer();
+}
+
+gl::ArrayId
+detail::acquireVertexArray()
+{
+	return currentPools ? currentPools->arrays.acquire() : genVertexArray();
+}
+
+gl::TextureId
+detail::acquireTexture()
+{
+	return currentPools ? currentPools->textures.acquire() : genTexture();
+}
+
+void
+detail::releaseBuffer(gl::BufferId buffer)
+{
+	if (currentPools) {
+		currentPools->buffers.release(buffer);
+	} else {
+		deleteBuffer(buffer);
+	}
+}
+
+void
+detail::releaseVertexArray(gl::ArrayId array)
+{
+	if (currentPools) {
+		currentPools->arrays.release(array);
+	} else {
+		deleteVertexArray(array);
+	}
+}
+
+void
+detail::releaseTexture(gl::TextureId texture)
+{
+	if (currentPools) {
+		currentPools->textures.release(texture);
+	} else {
+		deleteTexture(texture);
+	}
+}
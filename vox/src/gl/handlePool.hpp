@@ -0,0 +1,140 @@
+#pragma once
+#ifndef BKENTEL_VOX_GL_HANDLE_POOL_HPP
+#define BKENTEL_VOX_GL_HANDLE_POOL_HPP
+
+#include <vector>
+#include <boost/utility.hpp>
+
+#include "wrappedgl.hpp"
+
+namespace vox {
+	namespace gl {
+
+		namespace detail {
+			//batched generation and deletion of one type of name
+			template <typename handle_t> struct handle_batch;
+
+			template <> struct handle_batch<BufferId> {
+				static ::std::vector<BufferId> gen(unsigned n)			{ return genBuffers(n); }
+				static void del(::std::vector<BufferId> const& ids)		{ deleteBuffers(ids); }
+			};
+
+			template <> struct handle_batch<ArrayId> {
+				static ::std::vector<ArrayId> gen(unsigned n)			{ return genVertexArrays(n); }
+				static void del(::std::vector<ArrayId> const& ids)		{ deleteVertexArrays(ids); }
+			};
+
+			template <> struct handle_batch<TextureId> {
+				static ::std::vector<TextureId> gen(unsigned n)			{ return genTextures(n); }
+				static void del(::std::vector<TextureId> const& ids)	{ deleteTextures(ids); }
+			};
+		} //namespace detail
+
+		////////////////////////////////////////////////////////////////////////////////
+		// Names of one type generated batch at a time ahead of use, with deletes
+		// held back until flush() deletes them all in one call. Released names
+		// aren't reused: the driver may still be using the object behind them.
+		////////////////////////////////////////////////////////////////////////////////
+		template <typename handle_t>
+		class HandlePool : private ::boost::noncopyable {
+		public:
+			typedef detail::handle_batch<handle_t> batch;
+
+			explicit HandlePool(unsigned batchSize = 32)
+				: batchSize_(batchSize)
+				, driverCalls_(0)
+			{
+				assert(batchSize > 0);
+			}
+
+			//names still held are left to the context; clear() first to
+			//delete them
+			~HandlePool() {
+			}
+
+			handle_t acquire() {
+				if (free_.empty()) {
+					free_ = batch::gen(batchSize_);
+					::std::reverse(free_.begin(), free_.end());
+					++driverCalls_;
+				}
+
+				handle_t const result = free_.back();
+				free_.pop_back();
+
+				return result;
+			}
+
+			void release(handle_t handle) {
+				if (handle != handle_t()) {
+					pending_.push_back(handle);
+				}
+			}
+
+			//delete everything released since the last flush
+			void flush() {
+				if (pending_.empty()) {
+					return;
+				}
+
+				batch::del(pending_);
+				pending_.clear();
+				++driverCalls_;
+			}
+
+			//delete everything released and everything not yet acquired
+			void clear() {
+				flush();
+
+				if (!free_.empty()) {
+					batch::del(free_);
+					free_.clear();
+					++driverCalls_;
+				}
+			}
+
+			//gen and delete calls made so far
+			unsigned driverCalls() const { return driverCalls_; }
+			unsigned pending()     const { return static_cast<unsigned>(pending_.size()); }
+		private:
+			unsigned				batchSize_;
+			unsigned				driverCalls_;
+			::std::vector<handle_t>	free_;
+			::std::vector<handle_t>	pending_;
+		};
+
+		////////////////////////////////////////////////////////////////////////////////
+		// Buffer, vertex array and texture pools for one context. Once made
+		// current on the context's thread, every Buffer and VertexArray made
+		// or destroyed there goes through the pools; call flush() at the end
+		// of each frame.
+		////////////////////////////////////////////////////////////////////////////////
+		class HandlePools : private ::boost::noncopyable {
+		public:
+			explicit HandlePools(unsigned batchSize = 32);
+			//stops being current. Makes no GL calls: clear() first to delete
+			//the names still held
+			~HandlePools();
+
+			//the pools of the calling thread, or nullptr
+			static HandlePools* current();
+			//pools may be nullptr
+			static void makeCurrent(HandlePools* pools);
+
+			void flush();
+			//delete every name held; the context must be current
+			void clear();
+
+			unsigned driverCalls() const {
+				return buffers.driverCalls() + arrays.driverCalls() + textures.driverCalls();
+			}
+
+			HandlePool<BufferId>	buffers;
+			HandlePool<ArrayId>		arrays;
+			HandlePool<TextureId>	textures;
+		};
+
+	} //namespace gl
+} //namespace vox
+
+#endif //BKENTEL_VOX_GL_HANDLE_POOL_HPP
@@ -0,0 +1,154 @@
+#pragma once
+#ifndef BKENTEL_VOX_GL_QUERY_HPP
+#define BKENTEL_VOX_GL_QUERY_HPP
+
+#include <deque>
+#include <vector>
+#include <memory>
+#include <boost/utility.hpp>
+
+#include "wrappedgl.hpp"
+
+namespace vox {
+	namespace gl {
+
+		////////////////////////////////////////////////////////////////////////////////
+		// Represents an opengl query object. Results arrive some frames after
+		// end(); poll isAvailable() rather than wait on result().
+		////////////////////////////////////////////////////////////////////////////////
+		class Query : private ::boost::noncopyable {
+		public:
+			Query()
+				: id_(detail::genQuery())
+			{
+			}
+
+			Query(Query&& other)
+				: id_(std::move(other.id_))
+			{
+			}
+
+			Query& operator=(Query&& rhs) {
+				id_ = std::move(rhs.id_);
+				return *this;
+			}
+
+			void begin(QueryTarget target) { detail::beginQuery(target, id()); }
+			static void end(QueryTarget target) { detail::endQuery(target); }
+
+			//the result becomes the GPU time in ns at this point in the commands
+			void timestamp() { detail::queryCounter(id()); }
+
+			bool     isAvailable() const { return detail::isQueryResultAvailable(id()); }
+			GLuint64 result()      const { return detail::getQueryResult(id()); }
+
+			QueryId id() const { return id_.get(); }
+		private:
+			QueryId::unique_t id_;
+		};
+
+		////////////////////////////////////////////////////////////////////////////////
+		// Query objects kept for reuse, so per frame queries don't generate
+		// and delete names every frame. Release a query only once its result
+		// has been read.
+		////////////////////////////////////////////////////////////////////////////////
+		class QueryPool : private ::boost::noncopyable {
+		public:
+			Query* acquire() {
+				if (free_.empty()) {
+					queries_.push_back(::std::unique_ptr<Query>(new Query()));
+					return queries_.back().get();
+				}
+
+				Query* const result = free_.back();
+				free_.pop_back();
+
+				return result;
+			}
+
+			void release(Query* query) {
+				assert(query);
+				free_.push_back(query);
+			}
+
+			//queries made so far
+			unsigned size() const { return static_cast<unsigned>(queries_.size()); }
+		private:
+			::std::vector< ::std::unique_ptr<Query> >	queries_;
+			::std::vector<Query*>					free_;
+		};
+
+		////////////////////////////////////////////////////////////////////////////////
+		// GPU time of a span of commands, once per frame, read back without
+		// stalling: a ring of time elapsed queries, of which poll() reads the
+		// oldest once the GPU is done with it. Spans can't nest.
+		////////////////////////////////////////////////////////////////////////////////
+		class FrameTimer : private ::boost::noncopyable {
+		public:
+			//at most frames spans in flight; more are skipped until one finishes
+			explicit FrameTimer(unsigned frames = 4)
+				: timing_(false)
+			{
+				queries_.reserve(frames);
+
+				for (unsigned i = 0; i < frames; ++i) {
+					queries_.push_back(Query());
+					free_.push_back(i);
+				}
+			}
+
+			//start timing; false if every query is still in flight
+			bool begin() {
+				assert(!timing_);
+
+				if (free_.empty()) {
+					return false;
+				}
+
+				unsigned const i = free_.back();
+				free_.pop_back();
+
+				queries_[i].begin(QUERY_TIME_ELAPSED);
+				pending_.push_back(i);
+				timing_ = true;
+
+				return true;
+			}
+
+			//stop timing; does nothing if begin() skipped the span
+			void end() {
+				if (timing_) {
+					Query::end(QUERY_TIME_ELAPSED);
+					timing_ = false;
+				}
+			}
+
+			//the oldest finished span in ms, if there is one
+			bool poll(float& ms) {
+				if (pending_.empty() || (timing_ && pending_.size() == 1)) {
+					return false;
+				}
+
+				unsigned const i = pending_.front();
+				if (!queries_[i].isAvailable()) {
+					return false;
+				}
+
+				ms = static_cast<float>(queries_[i].result()) / 1000000.0f;
+
+				pending_.pop_front();
+				free_.push_back(i);
+
+				return true;
+			}
+		private:
+			::std::vector<Query>	queries_;
+			::std::vector<unsigned>	free_;
+			::std::deque<unsigned>	pending_; //oldest first
+			bool					timing_;
+		};
+
+	} //namespace gl
+} //namespace vox
+
+#endif //BKENTEL_VOX_GL_QUERY_HPP
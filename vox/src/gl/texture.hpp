@@ -0,0 +1,192 @@
+#pragma once
+#ifndef BKENTEL_VOX_GL_TEXTURE_HPP
+#define BKENTEL_VOX_GL_TEXTURE_HPP
+
+#include <algorithm>
+#include <boost/utility.hpp>
+
+#include "wrappedgl.hpp"
+#include "gltraits.hpp"
+
+namespace vox {
+	namespace gl {
+
+		////////////////////////////////////////////////////////////////////////////////
+		// Represents an opengl texture object bound to target_t.
+		//
+		// Storage is immutable: setStorage() fixes the format, size and mip
+		// levels once, after which only the contents change. Every call that
+		// needs the texture bound binds it to unit 0 through the texture
+		// binding cache, so binding again for drawing costs nothing when it's
+		// already there.
+		//
+		// 2D sizes and offsets are (width, height); 3D targets and 2D arrays
+		// add depth or layers. Only 2D, 2D array and 3D targets are supported.
+		////////////////////////////////////////////////////////////////////////////////
+		template <gl::TextureTarget target_t>
+		class Texture : private ::boost::noncopyable {
+			//any other target would quietly take the 2D paths
+			static_assert(
+				target_t == TEXTURE_2D || target_t == TEXTURE_2DA || target_t == TEXTURE_3D,
+				"unsupported texture target"
+			);
+		public:
+			typedef traits::texture<target_t> traits;
+
+			Texture()
+				: id_(detail::acquireTexture())
+				, format_(TEXTURE_FORMAT_RGBA8)
+				, levels_(0)
+				, width_(0)
+				, height_(0)
+				, depth_(0)
+			{
+			}
+
+			Texture(Texture&& other)
+				: id_(std::move(other.id_))
+				, format_(other.format_)
+				, levels_(other.levels_)
+				, width_(other.width_)
+				, height_(other.height_)
+				, depth_(other.depth_)
+			{
+			}
+
+			Texture& operator=(Texture&& rhs) {
+				id_     = std::move(rhs.id_);
+				format_ = rhs.format_;
+				levels_ = rhs.levels_;
+				width_  = rhs.width_;
+				height_ = rhs.height_;
+				depth_  = rhs.depth_;
+				return *this;
+			}
+
+			//number of levels in a full mip chain for the size
+			static unsigned mipLevels(unsigned width, unsigned height, unsigned depth = 1) {
+				unsigned size   = std::max(width, std::max(height, depth));
+				unsigned levels = 1;
+
+				while (size > 1) {
+					size /= 2;
+					++levels;
+				}
+
+				return levels;
+			}
+
+			//levels == 0 allocates a full mip chain; depth is ignored for 2D targets
+			void setStorage(TextureFormat format, unsigned width, unsigned height, unsigned depth = 1, unsigned levels = 0) {
+				assert(levels_ == 0 && "texture storage is immutable");
+
+				if (traits::dimensions < 3) {
+					depth = 1;
+				}
+
+				if (levels == 0) {
+					//array layers aren't mipmapped
+					levels = mipLevels(width, height, target_t == TEXTURE_3D ? depth : 1);
+				}
+
+				bind();
+
+				if (traits::dimensions == 3) {
+					detail::texStorage3D(traits::target, levels, format, width, height, depth);
+				} else {
+					detail::texStorage2D(traits::target, levels, format, width, height);
+				}
+
+				format_ = format;
+				levels_ = levels;
+				width_  = width;
+				height_ = height;
+				depth_  = depth;
+			}
+
+			//replace a width x height region of level at (x, y)
+			void setImage(
+				unsigned level, unsigned x, unsigned y, unsigned width, unsigned height,
+				PixelFormat format, DataType type, GLvoid const* data
+			) {
+				setImage(level, x, y, 0, width, height, 1, format, type, data);
+			}
+
+			//replace a width x height x depth region of level at (x, y, z); data
+			//is an offset into the bound pixel unpack buffer if there is one
+			void setImage(
+				unsigned level, unsigned x, unsigned y, unsigned z,
+				unsigned width, unsigned height, unsigned depth,
+				PixelFormat format, DataType type, GLvoid const* data
+			) {
+				assert(level < levels_);
+				bind();
+
+				if (traits::dimensions == 3) {
+					detail::texSubImage3D(traits::target, level, x, y, z, width, height, depth, format, type, data);
+				} else {
+					assert(z == 0 && depth == 1);
+					detail::texSubImage2D(traits::target, level, x, y, width, height, format, type, data);
+				}
+			}
+
+			//fill levels 1 and up from level 0
+			void generateMipmaps() {
+				assert(levels_ > 0);
+				bind();
+				detail::generateMipmap(traits::target);
+			}
+
+			void setFilter(TextureFilter minFilter, TextureFilter magFilter) {
+				bind();
+				detail::texParameter(traits::target, GL_TEXTURE_MIN_FILTER, static_cast<GLint>(minFilter));
+				detail::texParameter(traits::target, GL_TEXTURE_MAG_FILTER, static_cast<GLint>(magFilter));
+			}
+
+			void setWrap(TextureWrap s, TextureWrap t) {
+				bind();
+				detail::texParameter(traits::target, GL_TEXTURE_WRAP_S, static_cast<GLint>(s));
+				detail::texParameter(traits::target, GL_TEXTURE_WRAP_T, static_cast<GLint>(t));
+			}
+
+			//1 turns anisotropic filtering off
+			void setAnisotropy(float anisotropy) {
+				bind();
+				detail::texParameter(traits::target, GL_TEXTURE_MAX_ANISOTROPY_EXT, anisotropy);
+			}
+
+			//sample only levels [base, max]
+			void setLevelRange(unsigned base, unsigned max) {
+				bind();
+				detail::texParameter(traits::target, GL_TEXTURE_BASE_LEVEL, static_cast<GLint>(base));
+				detail::texParameter(traits::target, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(max));
+			}
+
+			void bind(unsigned unit = 0) const {
+				detail::bindTexture(unit, traits::target, id());
+			}
+
+			TextureFormat	format() const { return format_; }
+			unsigned		levels() const { return levels_; }
+			unsigned		width()  const { return width_; }
+			unsigned		height() const { return height_; }
+			unsigned		depth()  const { return depth_; }
+
+			TextureId id() const { return id_.get(); }
+		private:
+			TextureId::unique_t	id_;
+			TextureFormat		format_;
+			unsigned			levels_;
+			unsigned			width_;
+			unsigned			height_;
+			unsigned			depth_;
+		};
+
+		typedef Texture<TEXTURE_2D>  Texture2D;
+		typedef Texture<TEXTURE_2DA> Texture2DArray;
+		typedef Texture<TEXTURE_3D>  Texture3D;
+
+	} //namespace gl
+} //namespace vox
+
+#endif //BKENTEL_VOX_GL_TEXTURE_HPP
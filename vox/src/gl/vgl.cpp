@@ -20,14 +20,156 @@ namespace {
 
 	    return result;
     }
+
+	//written ahead of a cached program binary
+	struct ProgramCacheHeader {
+		unsigned			magic;
+		unsigned			format;		//the driver's, for glProgramBinary
+		unsigned long long	sources;	//hash of the shaders' types and sources
+		unsigned long long	driver;		//hash of the vendor, renderer and version
+		unsigned			size;		//bytes of binary after the header
+		unsigned			reserved;
+	};
+
+	unsigned const PROGRAM_CACHE_MAGIC = 0x50584F56; //"VOXP"
+
+	unsigned long long const HASH_BASIS = 0xCBF29CE484222325ULL;
+
+	//64 bit FNV-1a
+	unsigned long long
+	hashBytes(unsigned long long hash, void const* data, size_t size)
+	{
+		unsigned char const* const bytes = static_cast<unsigned char const*>(data);
+
+		for (size_t i = 0; i < size; ++i) {
+			hash ^= bytes[i];
+			hash *= 0x100000001B3ULL;
+		}
+
+		return hash;
+	}
+
+	unsigned long long
+	hashString(unsigned long long hash, gl::String const& string)
+	{
+		//the length as well, so "ab" + "c" differs from "a" + "bc"
+		unsigned const length = static_cast<unsigned>(string.size());
+
+		hash = hashBytes(hash, &length, sizeof(length));
+		return hashBytes(hash, string.data(), string.size());
+	}
+
+	unsigned long long
+	hashSources(std::vector<gl::ShaderSource> const& sources)
+	{
+		unsigned long long hash = HASH_BASIS;
+
+		for (auto it = sources.begin(); it != sources.end(); ++it) {
+			unsigned const type = it->type;
+
+			hash = hashBytes(hash, &type, sizeof(type));
+			hash = hashString(hash, it->source);
+		}
+
+		return hash;
+	}
+
+	//a driver update can change what binaries it accepts, or produces
+	unsigned long long
+	hashDriver()
+	{
+		unsigned long long hash = HASH_BASIS;
+
+		hash = hashString(hash, gl::detail::getString(GL_VENDOR));
+		hash = hashString(hash, gl::detail::getString(GL_RENDERER));
+		hash = hashString(hash, gl::detail::getString(GL_VERSION));
+
+		return hash;
+	}
+
+	//false if fileName doesn't exist, can't be read, or was written for
+	//other sources or another driver
+	bool
+	readProgramCache(
+		gl::FileName const&			fileName,
+		ProgramCacheHeader const&	expected,
+		GLenum&						format,
+		std::vector<GLubyte>&		binary
+	) {
+		std::ifstream in(fileName, std::ios::binary);
+
+		ProgramCacheHeader header;
+		if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+			return false;
+		}
+
+		if (header.magic	!= expected.magic	||
+			header.sources	!= expected.sources	||
+			header.driver	!= expected.driver	||
+			header.size		== 0
+		) {
+			return false;
+		}
+
+		binary.resize(header.size);
+		if (!in.read(reinterpret_cast<char*>(&binary[0]), header.size)) {
+			return false;
+		}
+
+		format = header.format;
+		return true;
+	}
+
+	//the cache only saves time, so failing to write it isn't an error
+	void
+	writeProgramCache(
+		gl::FileName const&			fileName,
+		ProgramCacheHeader const&	header,
+		std::vector<GLubyte> const&	binary
+	) {
+		if (binary.empty()) {
+			return;
+		}
+
+		std::ofstream out(fileName, std::ios::binary | std::ios::trunc);
+
+		out.write(reinterpret_cast<char const*>(&header), sizeof(header));
+		out.write(reinterpret_cast<char const*>(&binary[0]), binary.size());
+	}
 } //namespace anon
 
+gl::ShaderSource
+gl::loadShaderSource(
+	FileName const& filename,
+	ShaderType shaderType
+) {
+	ShaderSource result;
+	result.type		= shaderType;
+	result.filename	= filename;
+	result.source	= &readFile(filename)[0];
+
+	return result;
+}
+
+bool
+gl::enableParallelShaderCompile()
+{
+	if (!GLEW_KHR_parallel_shader_compile) {
+		return false;
+	}
+
+	//as many threads as the driver likes
+	detail::maxShaderCompilerThreads(0xFFFFFFFF);
+	return true;
+}
+
 gl::Shader::Shader(
 	FileName const& filename,
 	ShaderType shaderType
 )
 	: id_(detail::createShader(shaderType))
 	, type_(shaderType)
+	, filename_(filename)
 {	
 	//translate the exception
 	try {
@@ -39,15 +181,36 @@ gl::Shader::Shader(
 		//);
 	}
 
+	detail::compileShader(id());
+	check();
+}
+
+gl::Shader::Shader(
+	ShaderSource const& source,
+	CompileMode mode
+)
+	: id_(detail::createShader(source.type))
+	, type_(source.type)
+	, filename_(source.filename)
+{
+	detail::shaderSource(id(), source.source);
 	detail::compileShader(id());
 
+	if (mode == COMPILE_WAIT) {
+		check();
+	}
+}
+
+void
+gl::Shader::check() const
+{
 	if (!detail::get::shader::isCompiled(id())) {
 		auto const log = detail::get::shader::infoLog(id());
 
 		BOOST_THROW_EXCEPTION(error::compilation_error()
-			<< error::shader_type(shaderType)
+			<< error::shader_type(type_)
 			<< error::info_log(log)
-			<< error::file_name(filename)
+			<< error::file_name(filename_)
 		);
 	}
 }
@@ -61,6 +224,10 @@ try {
 gl::Program::Program()
 	: program_(detail::createProgram())
 	, shaders_()
+	, pending_(false)
+	, cacheFile_()
+	, cacheSources_(0)
+	, cacheDriver_(0)
 {
 }
 
@@ -116,7 +283,12 @@ void
 gl::Program::link()
 {
 	detail::linkProgram(id());
+	linked_();
+}
 
+void
+gl::Program::linked_()
+{
 	if (!detail::get::program::isLinked(id())) {
 		auto const log = detail::get::program::infoLog(id());
 
@@ -129,9 +301,108 @@ gl::Program::link()
 	vars_.enumerate(id());
 }
 
+bool
+gl::Program::link(
+	std::vector<ShaderSource> const&	sources,
+	FileName const&						cacheFile
+) {
+	bool const cached = linkAsync(sources, cacheFile);
+	finish();
+
+	return cached;
+}
+
+bool
+gl::Program::linkAsync(
+	std::vector<ShaderSource> const&	sources,
+	FileName const&						cacheFile
+) {
+	//binaries need GL 4.1 or ARB_get_program_binary, and a driver that
+	//supports at least one format
+	GLint formats = 0;
+	if (!cacheFile.empty() && GLEW_ARB_get_program_binary) {
+		::glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+	}
+
+	cacheFile_.clear();
+
+	if (formats > 0) {
+		ProgramCacheHeader header = {PROGRAM_CACHE_MAGIC, 0, hashSources(sources), hashDriver(), 0, 0};
+
+		GLenum					format = 0;
+		std::vector<GLubyte>	binary;
+
+		if (readProgramCache(cacheFile, header, format, binary)) {
+			try {
+				detail::programBinary(id(), format, binary);
+
+				if (detail::get::program::isLinked(id())) {
+					vars_.enumerate(id());
+					pending_ = false;
+					return true;
+				}
+			} catch (error::gl_error&) {
+				//a format the driver no longer takes; compile instead
+			}
+		}
+
+		detail::programParameter(id(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+		cacheFile_		= cacheFile;
+		cacheSources_	= header.sources;
+		cacheDriver_	= header.driver;
+	}
+
+	//every compile is issued before anything waits on one
+	for (auto it = sources.begin(); it != sources.end(); ++it) {
+		attachShader(std::make_shared<Shader>(*it, COMPILE_ASYNC));
+	}
+
+	detail::linkProgram(id());
+	pending_ = true;
+
+	return false;
+}
+
+bool
+gl::Program::ready() const
+{
+	return !pending_ || !GLEW_KHR_parallel_shader_compile || detail::get::program::isComplete(id());
+}
+
+void
+gl::Program::finish()
+{
+	if (!pending_) {
+		return;
+	}
+
+	//a shader that failed to compile says more than the link that followed
+	for (auto it = shaders_.begin(); it != shaders_.end(); ++it) {
+		(*it)->check();
+	}
+
+	linked_();
+	pending_ = false;
+
+	if (!cacheFile_.empty()) {
+		GLenum format = 0;
+		auto const binary = detail::getProgramBinary(id(), format);
+
+		ProgramCacheHeader const header = {
+			PROGRAM_CACHE_MAGIC, format, cacheSources_, cacheDriver_,
+			static_cast<unsigned>(binary.size()), 0
+		};
+
+		writeProgramCache(cacheFile_, header, binary);
+		cacheFile_.clear();
+	}
+}
+
 void
 gl::Program::use()
 {
+	finish();
 	detail::useProgram(id());
 }
 
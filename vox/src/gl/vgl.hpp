@@ -4,6 +4,9 @@
 
 #include "wrappedgl.hpp"
 #include "gltraits.hpp"
+#include "texture.hpp"
+#include "framebuffer.hpp"
+#include "query.hpp"
 
 namespace vox {
 	namespace gl {
@@ -27,9 +30,6 @@ namespace vox {
 		> class Buffer;
 
 
-        class Texture {
-        };
-
         template <
             typename qualifier_t,
             typename category_t,
@@ -130,6 +130,25 @@ namespace vox {
 			typedef Variable<traits::attribute, traits::vec3f> vec3f;
 		} //namespace uniform
 
+		//a shader's source, read ahead of compiling it
+		struct ShaderSource {
+			ShaderType	type;
+			FileName	filename;
+			String		source;
+		};
+
+		//read the source of a shader of type [shaderType] from file [filename]
+		ShaderSource loadShaderSource(FileName const& filename, ShaderType shaderType);
+
+		//let the driver compile shaders and link programs on threads of its
+		//own, so issuing them doesn't wait; false if it can't
+		bool enableParallelShaderCompile();
+
+		enum CompileMode {
+			COMPILE_WAIT,	//check the result at once
+			COMPILE_ASYNC,	//check it later, with Shader::check()
+		};
+
 		////////////////////////////////////////////////////////////////////////////////
 		// Represents an opengl Shader object
 		////////////////////////////////////////////////////////////////////////////////
@@ -137,13 +156,18 @@ namespace vox {
 		public:
 			//Load a shader of type [shaderType] from file [filename]
 			Shader(FileName const& filename, ShaderType shaderType);
+			explicit Shader(ShaderSource const& source, CompileMode mode = COMPILE_WAIT);
 			~Shader();
 
+			//wait for the compile to finish; throws compilation_error if it failed
+			void check() const;
+
 			ShaderId	id()	const { return id_.get(); }
 			ShaderType	type()	const { return type_; }
 		private:
 			unique_handle<ShaderId>::type	id_;
 			ShaderType						type_;
+			FileName						filename_;
 		};
 	
 		////////////////////////////////////////////////////////////////////////////////
@@ -156,7 +180,7 @@ namespace vox {
 			typedef traits::buffer<target_t, usage_t> traits;
 
 			Buffer()
-				: id_(detail::genBuffer())
+				: id_(detail::acquireBuffer())
 			{
 			}
 
@@ -205,7 +229,18 @@ namespace vox {
 				detail::getBufferSubData(traits::target, offset, size, out);
 			};
 
-			void mapData();
+			//map length bytes at offset into client memory; access is a
+			//combination of the GL_MAP_* bits
+			GLvoid* map(unsigned offset, unsigned length, GLbitfield access) {
+				assert(isBound());
+				return detail::mapBufferRange(traits::target, offset, length, access);
+			}
+
+			//false if the contents were lost while mapped
+			bool unmap() {
+				assert(isBound());
+				return detail::unmapBuffer(traits::target);
+			}
 
 			bool isBound() const {
 				return detail::get::global::bufferBinding<traits::target>() == id();
@@ -284,6 +319,21 @@ namespace vox {
 			~Program();
 
 			void link();
+			//compile and link sources, unless cacheFile holds the binary of an
+			//earlier link of the same sources by the same driver; then that is
+			//loaded instead. After compiling the binary is written to cacheFile.
+			//True if the cached binary was used
+			bool link(::std::vector<ShaderSource> const& sources, FileName const& cacheFile);
+			//as link(sources, cacheFile), but only issues the compile and link;
+			//they're checked by finish(), which use() calls. No variables can
+			//be looked up until then. An empty cacheFile doesn't cache
+			bool linkAsync(::std::vector<ShaderSource> const& sources, FileName const& cacheFile);
+			//true if finish() won't wait; without parallel compiles there's no
+			//telling, so also true then
+			bool ready() const;
+			//wait for linkAsync's compile and link; throws compilation_error
+			//or linker_error if they failed
+			void finish();
 			void use();
 
 			void attachShader(std::shared_ptr<Shader> shader);
@@ -300,9 +350,17 @@ namespace vox {
 			};
 			typedef ::std::set<shaders_key_t, shaders_less_t> shaders_container_t;
 			
+			//check the link and find the variables
+			void linked_();
+
 			ProgramId::unique_t	program_;
 			shaders_container_t	shaders_; //shaders attached to the program
 			VariableSet			vars_;		//set of all variables
+
+			bool				pending_;		//linkAsync not yet finished
+			FileName			cacheFile_;		//where finish() writes the binary; empty for nowhere
+			unsigned long long	cacheSources_;	//keys of the binary, see link
+			unsigned long long	cacheDriver_;
 		};
 
 		////////////////////////////////////////////////////////////////////////////////
@@ -317,7 +375,7 @@ namespace vox {
 			};
 
 			VertexArray()
-				: array_(detail::genVertexArray())
+				: array_(detail::acquireVertexArray())
 			{
 			}
 
@@ -34,12 +34,19 @@ detail::genVertexArrays(unsigned n)
 {
 	assert(n > 0);
 			
-	std::vector<ArrayId> result;
+	std::vector<GLuint> ids(n);
 			
-	::glGenVertexArrays(
-		n,
-		reinterpret_cast<GLuint*>(&result[0])
-	);
+	::glGenVertexArrays(n, &ids[0]);
+
+	onError([] (error::ErrorType e) {
+		THROW_GL_ERROR("glGenVertexArrays", e);
+	});
+
+	std::vector<ArrayId> result;
+	result.reserve(n);
+	std::transform(ids.begin(), ids.end(), std::back_inserter(result), [](GLuint id) {
+		return ArrayId(id);
+	});
 
 	return result;
 }
@@ -54,12 +61,19 @@ detail::genVertexArray()
 }
 
 void
-detail::deleteVertexArrays(std::vector<gl::ArrayId>& arrays)
+detail::deleteVertexArrays(std::vector<gl::ArrayId> const& arrays)
 {
-	::glDeleteVertexArrays(
-		arrays.size(),
-		reinterpret_cast<GLuint const*>(&arrays[0])
-	);
+	if (arrays.empty()) {
+		return;
+	}
+
+	std::vector<GLuint> ids;
+	ids.reserve(arrays.size());
+	std::transform(arrays.begin(), arrays.end(), std::back_inserter(ids), [](ArrayId id) {
+		return id.value;
+	});
+
+	::glDeleteVertexArrays(static_cast<GLsizei>(ids.size()), &ids[0]);
 
 	onError([] (error::ErrorType e) {
 		THROW_GL_ERROR("glDeleteVertexArrays", e);
@@ -102,6 +116,57 @@ detail::drawArrays(gl::DrawMode mode, GLint first, GLsizei count)
 	});
 }
 
+void
+detail::readPixels(
+	GLint			x,
+	GLint			y,
+	GLsizei			width,
+	GLsizei			height,
+	gl::PixelFormat	format,
+	gl::DataType	type,
+	GLvoid*			data
+) {
+	::glReadPixels(x, y, width, height, format, type, data);
+
+	onError([] (error::ErrorType e) {
+		THROW_GL_ERROR("glReadPixels", e);
+	});
+}
+
+GLsync
+detail::fenceSync()
+{
+	GLsync const result = ::glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	onError([] (error::ErrorType e) {
+		THROW_GL_ERROR("glFenceSync", e);
+	});
+
+	return result;
+}
+
+bool
+detail::isSignaled(GLsync fence)
+{
+	GLenum const result = ::glClientWaitSync(fence, 0, 0);
+
+	onError([] (error::ErrorType e) {
+		THROW_GL_ERROR("glClientWaitSync", e);
+	});
+
+	return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+}
+
+void
+detail::deleteSync(GLsync fence)
+{
+	::glDeleteSync(fence);
+
+	onError([] (error::ErrorType e) {
+		THROW_GL_ERROR("glDeleteSync", e);
+	});
+}
+
 void
 detail::vertexAttribPointer(
 	gl::AttributeLocation	index,
@@ -139,26 +204,498 @@ detail::disableVertexAttribArray(gl::AttributeLocation index)
 	});
 }
 
+namespace {
+	//texture units and targets the binding cache tracks
+	unsigned const CACHED_TEXTURE_UNITS		= 32;
+	unsigned const CACHED_TEXTURE_TARGETS	= 9;
+
+	//what the calling thread's context has bound; zero initialized to match
+	//a new context
+	struct TextureBindings {
+		unsigned	activeUnit;
+		GLuint		bound[CACHED_TEXTURE_UNITS][CACHED_TEXTURE_TARGETS];
+	};
+
+	VOX_THREAD_LOCAL TextureBindings textureBindings;
+
+	unsigned targetIndex(gl::TextureTarget target) {
+		switch (target) {
+		case gl::TEXTURE_1D :	return 0;
+		case gl::TEXTURE_2D :	return 1;
+		case gl::TEXTURE_3D :	return 2;
+		case gl::TEXTURE_1DA :	return 3;
+		case gl::TEXTURE_2DA :	return 4;
+		case gl::TEXTURE_RECT :	return 5;
+		case gl::TEXTURE_CUBE :	return 6;
+		case gl::TEXTURE_2DM :	return 7;
+		case gl::TEXTURE_2DMA :	return 8;
+		}
+
+		assert(0 && "unknown texture target");
+		return 0;
+	}
+
+	//deleting a texture unbinds it everywhere in the context
+	void forgetTexture(GLuint texture) {
+		for (unsigned unit = 0; unit < CACHED_TEXTURE_UNITS; ++unit) {
+			GLuint* const bound = textureBindings.bound[unit];
+			std::replace(bound, bound + CACHED_TEXTURE_TARGETS, texture, 0u);
+		}
+	}
+} //namespace anon
+
+std::vector<gl::TextureId>
+detail::genTextures(unsigned n)
+{
+	assert(n > 0);
+
+	std::vector<GLuint> ids(n);
+
+	::glGenTextures(n, &ids[0]);
+
+	onError([] (error::ErrorType e) {
+		THROW_GL_ERROR("glGenTextures", e);
+	});
+
+	std::vector<gl::TextureId> result;
+	result.reserve(n);
+	std::transform(ids.begin(), ids.end(), std::back_inserter(result), [](GLuint id) {
+		return TextureId(id);
+	});
+
+	return result;
+}
+
+void
+detail::deleteTextures(std::vector<gl::TextureId> const& textures)
+{
+	if (textures.empty()) {
+		return;
+	}
+
+	std::vector<GLuint> ids;
+	ids.reserve(textures.size());
+	std::transform(textures.begin(), textures.end(), std::back_inserter(ids), [](TextureId id) {
+		return id.value;
+	});
+
+	::glDeleteTextures(static_cast<GLsizei>(ids.size()), &ids[0]);
+
+	onError([] (error::ErrorType e) {
+		THROW_GL_ERROR("glDeleteTextures", e);
+	});
+
+	std::for_each(ids.begin(), ids.end(), forgetTexture);
+}
+
 void
 detail::deleteTexture(gl::TextureId texture)
 {
-    ::glDeleteTextures(1, &texture.value);
-    //TODO
+	::glDeleteTextures(1, &texture.value);
+
+	onError([&texture] (error::ErrorType e) {
+		THROW_GL_ERROR_INFO("glDeleteTextures", e, error::texture_id(texture));
+	});
+
+	forgetTexture(texture.value);
+}
+
+gl::FramebufferId
+detail::genFramebuffer()
+{
+	GLuint id = 0;
+	::glGenFramebuffers(1, &id);
+
+	onError([] (error::ErrorType e) {
+		THROW_GL_ERROR("glGenFramebuffers", e);
+	});
+
+	return FramebufferId(id);
+}
+
+void
+detail::deleteFramebuffer(gl::FramebufferId framebuffer)
+{
+	::glDeleteFramebuffers(1, &framebuffer.value);
+
+	onError([&framebuffer] (error::ErrorType e) {
+		THROW_GL_ERROR_INFO("glDeleteFramebuffers", e, error::framebuffer_id(framebuffer));
+	});
+}
+
+void
+detail::bindFramebuffer(gl::FramebufferTarget target, gl::FramebufferId framebuffer)
+{
+	::glBindFramebuffer(target, framebuffer.value);
+
+	onError([&target, &framebuffer] (error::ErrorType e) {
+		THROW_GL_ERROR_INFO("glBindFramebuffer", e,
+			error::framebuffer_id(framebuffer) << error::framebuffer_target(target)
+		);
+	});
+}
+
+void
+detail::bindFramebuffer(gl::FramebufferTarget target)
+{
+	bindFramebuffer(target, FramebufferId());
+}
+
+void
+detail::framebufferTexture(
+	gl::FramebufferTarget		target,
+	gl::FramebufferAttachment	attachment,
+	gl::TextureId				texture,
+	GLint						level
+) {
+	::glFramebufferTexture(target, attachment, texture.value, level);
+
+	onError([&target, &texture] (error::ErrorType e) {
+		THROW_GL_ERROR_INFO("glFramebufferTexture", e,
+			error::texture_id(texture) << error::framebuffer_target(target)
+		);
+	});
+}
+
+void
+detail::framebufferRenderbuffer(
+	gl::FramebufferTarget		target,
+	gl::FramebufferAttachment	attachment,
+	gl::RenderbufferId			renderbuffer
+) {
+	::glFramebufferRenderbuffer(target, attachment, GL_RENDERBUFFER, renderbuffer.value);
+
+	onError([&target, &renderbuffer] (error::ErrorType e) {
+		THROW_GL_ERROR_INFO("glFramebufferRenderbuffer", e,
+			error::renderbuffer_id(renderbuffer) << error::framebuffer_target(target)
+		);
+	});
+}
+
+GLenum
+detail::checkFramebufferStatus(gl::FramebufferTarget target)
+{
+	GLenum const result = ::glCheckFramebufferStatus(target);
+
+	onError([&target] (error::ErrorType e) {
+		THROW_GL_ERROR_INFO("glCheckFramebufferStatus", e, error::framebuffer_target(target));
+	});
+
+	return result;
+}
+
+void
+detail::blitFramebuffer(
+	GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1,
+	GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1,
+	GLbitfield			mask,
+	gl::TextureFilter	filter
+) {
+	::glBlitFramebuffer(srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter);
+
+	onError([] (error::ErrorType e) {
+		THROW_GL_ERROR("glBlitFramebuffer", e);
+	});
+}
+
+gl::QueryId
+detail::genQuery()
+{
+	GLuint id = 0;
+	::glGenQueries(1, &id);
+
+	onError([] (error::ErrorType e) {
+		THROW_GL_ERROR("glGenQueries", e);
+	});
+
+	return QueryId(id);
+}
+
+void
+detail::deleteQuery(gl::QueryId query)
+{
+	::glDeleteQueries(1, &query.value);
+
+	onError([&query] (error::ErrorType e) {
+		THROW_GL_ERROR_INFO("glDeleteQueries", e, error::query_id(query));
+	});
+}
+
+void
+detail::beginQuery(gl::QueryTarget target, gl::QueryId query)
+{
+	::glBeginQuery(target, query.value);
+
+	onError([&target, &query] (error::ErrorType e) {
+		THROW_GL_ERROR_INFO("glBeginQuery", e,
+			error::query_id(query) << error::query_target(target)
+		);
+	});
+}
+
+void
+detail::endQuery(gl::QueryTarget target)
+{
+	::glEndQuery(target);
+
+	onError([&target] (error::ErrorType e) {
+		THROW_GL_ERROR_INFO("glEndQuery", e, error::query_target(target));
+	});
+}
+
+void
+detail::queryCounter(gl::QueryId query)
+{
+	::glQueryCounter(query.value, GL_TIMESTAMP);
+
+	onError([&query] (error::ErrorType e) {
+		THROW_GL_ERROR_INFO("glQueryCounter", e, error::query_id(query));
+	});
+}
+
+bool
+detail::isQueryResultAvailable(gl::QueryId query)
+{
+	GLuint result = GL_FALSE;
+	::glGetQueryObjectuiv(query.value, GL_QUERY_RESULT_AVAILABLE, &result);
+
+	onError([&query] (error::ErrorType e) {
+		THROW_GL_ERROR_INFO("glGetQueryObjectuiv", e, error::query_id(query));
+	});
+
+	return result == GL_TRUE;
+}
+
+GLuint64
+detail::getQueryResult(gl::QueryId query)
+{
+	GLuint64 result = 0;
+	::glGetQueryObjectui64v(query.value, GL_QUERY_RESULT, &result);
+
+	onError([&query] (error::ErrorType e) {
+		THROW_GL_ERROR_INFO("glGetQueryObjectui64v", e, error::query_id(query));
+	});
+
+	return result;
+}
+
+gl::RenderbufferId
+detail::genRenderbuffer()
+{
+	GLuint id = 0;
+	::glGenRenderbuffers(1, &id);
+
+	onError([] (error::ErrorType e) {
+		THROW_GL_ERROR("glGenRenderbuffers", e);
+	});
+
+	return RenderbufferId(id);
+}
+
+void
+detail::deleteRenderbuffer(gl::RenderbufferId renderbuffer)
+{
+	::glDeleteRenderbuffers(1, &renderbuffer.value);
+
+	onError([&renderbuffer] (error::ErrorType e) {
+		THROW_GL_ERROR_INFO("glDeleteRenderbuffers", e, error::renderbuffer_id(renderbuffer));
+	});
+}
+
+void
+detail::bindRenderbuffer(gl::RenderbufferId renderbuffer)
+{
+	::glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer.value);
+
+	onError([&renderbuffer] (error::ErrorType e) {
+		THROW_GL_ERROR_INFO("glBindRenderbuffer", e, error::renderbuffer_id(renderbuffer));
+	});
+}
+
+void
+detail::renderbufferStorage(gl::TextureFormat format, GLsizei width, GLsizei height)
+{
+	::glRenderbufferStorage(GL_RENDERBUFFER, format, width, height);
+
+	onError([] (error::ErrorType e) {
+		THROW_GL_ERROR("glRenderbufferStorage", e);
+	});
 }
 
 gl::TextureId
 detail::genTexture()
 {
-    TextureId result;
-    ::glGenTextures(1, &result.value); //TODO
+	GLuint id = 0;
+	::glGenTextures(1, &id);
 
-    return result;
+	onError([] (error::ErrorType e) {
+		THROW_GL_ERROR("glGenTextures", e);
+	});
+
+	return TextureId(id);
 }
 
 void
 detail::bindTexture(gl::TextureTarget target, gl::TextureId texture)
 {
-    ::glBindTexture(target, texture.value); //TODO
+	bindTexture(textureBindings.activeUnit, target, texture);
+}
+
+void
+detail::bindTexture(unsigned unit, gl::TextureTarget target, gl::TextureId texture)
+{
+	assert(unit < CACHED_TEXTURE_UNITS);
+
+	GLuint& bound = textureBindings.bound[unit][targetIndex(target)];
+	if (bound == texture.value && textureBindings.activeUnit == unit) {
+		return;
+	}
+
+	if (textureBindings.activeUnit != unit) {
+		::glActiveTexture(GL_TEXTURE0 + unit);
+		textureBindings.activeUnit = unit;
+	}
+
+	if (bound != texture.value) {
+		::glBindTexture(target, texture.value);
+		bound = texture.value;
+	}
+
+	onError([&texture, &target] (error::ErrorType e) {
+		THROW_GL_ERROR_INFO("glBindTexture", e,
+			error::texture_id(texture) << error::texture_target(target)
+		);
+	});
+}
+
+void
+detail::resetTextureBindings()
+{
+	GLint unit = GL_TEXTURE0;
+	::glGetIntegerv(GL_ACTIVE_TEXTURE, &unit);
+
+	std::memset(&textureBindings, 0, sizeof(textureBindings));
+	textureBindings.activeUnit = static_cast<unsigned>(unit - GL_TEXTURE0);
+
+	//the cache now says nothing is bound; make that true
+	for (unsigned i = 0; i < CACHED_TEXTURE_UNITS; ++i) {
+		::glActiveTexture(GL_TEXTURE0 + i);
+		for (unsigned t = 0; t < CACHED_TEXTURE_TARGETS; ++t) {
+			static gl::TextureTarget const targets[CACHED_TEXTURE_TARGETS] = {
+				gl::TEXTURE_1D, gl::TEXTURE_2D, gl::TEXTURE_3D, gl::TEXTURE_1DA, gl::TEXTURE_2DA,
+				gl::TEXTURE_RECT, gl::TEXTURE_CUBE, gl::TEXTURE_2DM, gl::TEXTURE_2DMA,
+			};
+
+			::glBindTexture(targets[t], 0);
+		}
+	}
+
+	::glActiveTexture(GL_TEXTURE0 + textureBindings.activeUnit);
+
+	onError([] (error::ErrorType e) {
+		THROW_GL_ERROR("glBindTexture", e);
+	});
+}
+
+void
+detail::texStorage2D(
+	gl::TextureTarget	target,
+	unsigned			levels,
+	gl::TextureFormat	format,
+	GLsizei				width,
+	GLsizei				height
+) {
+	::glTexStorage2D(target, levels, format, width, height);
+
+	onError([&target] (error::ErrorType e) {
+		THROW_GL_ERROR_INFO("glTexStorage2D", e, error::texture_target(target));
+	});
+}
+
+void
+detail::texStorage3D(
+	gl::TextureTarget	target,
+	unsigned			levels,
+	gl::TextureFormat	format,
+	GLsizei				width,
+	GLsizei				height,
+	GLsizei				depth
+) {
+	::glTexStorage3D(target, levels, format, width, height, depth);
+
+	onError([&target] (error::ErrorType e) {
+		THROW_GL_ERROR_INFO("glTexStorage3D", e, error::texture_target(target));
+	});
+}
+
+void
+detail::texSubImage2D(
+	gl::TextureTarget	target,
+	GLint				level,
+	GLint				x,
+	GLint				y,
+	GLsizei				width,
+	GLsizei				height,
+	gl::PixelFormat		format,
+	gl::DataType		type,
+	GLvoid const*		data
+) {
+	::glTexSubImage2D(target, level, x, y, width, height, format, type, data);
+
+	onError([&target] (error::ErrorType e) {
+		THROW_GL_ERROR_INFO("glTexSubImage2D", e, error::texture_target(target));
+	});
+}
+
+void
+detail::texSubImage3D(
+	gl::TextureTarget	target,
+	GLint				level,
+	GLint				x,
+	GLint				y,
+	GLint				z,
+	GLsizei				width,
+	GLsizei				height,
+	GLsizei				depth,
+	gl::PixelFormat		format,
+	gl::DataType		type,
+	GLvoid const*		data
+) {
+	::glTexSubImage3D(target, level, x, y, z, width, height, depth, format, type, data);
+
+	onError([&target] (error::ErrorType e) {
+		THROW_GL_ERROR_INFO("glTexSubImage3D", e, error::texture_target(target));
+	});
+}
+
+void
+detail::texParameter(gl::TextureTarget target, GLenum name, GLint value)
+{
+	::glTexParameteri(target, name, value);
+
+	onError([&target] (error::ErrorType e) {
+		THROW_GL_ERROR_INFO("glTexParameteri", e, error::texture_target(target));
+	});
+}
+
+void
+detail::texParameter(gl::TextureTarget target, GLenum name, GLfloat value)
+{
+	::glTexParameterf(target, name, value);
+
+	onError([&target] (error::ErrorType e) {
+		THROW_GL_ERROR_INFO("glTexParameterf", e, error::texture_target(target));
+	});
+}
+
+void
+detail::generateMipmap(gl::TextureTarget target)
+{
+	::glGenerateMipmap(target);
+
+	onError([&target] (error::ErrorType e) {
+		THROW_GL_ERROR_INFO("glGenerateMipmap", e, error::texture_target(target));
+	});
 }
 
 std::vector<gl::BufferId>
@@ -166,12 +703,19 @@ detail::genBuffers(unsigned n)
 {
 	assert(n > 0);
 
-	std::vector<gl::BufferId> result(n);
+	std::vector<GLuint> ids(n);
 	
-	::glGenBuffers(
-		n,
-		reinterpret_cast<GLuint*>(&result[0])
-	);
+	::glGenBuffers(n, &ids[0]);
+
+	onError([] (error::ErrorType e) {
+		THROW_GL_ERROR("glGenBuffers", e);
+	});
+
+	std::vector<gl::BufferId> result;
+	result.reserve(n);
+	std::transform(ids.begin(), ids.end(), std::back_inserter(result), [](GLuint id) {
+		return BufferId(id);
+	});
 
 	return result;
 }
@@ -188,10 +732,17 @@ detail::genBuffer()
 void
 detail::deleteBuffers(std::vector<gl::BufferId> const& buffers)
 {
-	::glDeleteBuffers(
-		buffers.size(),
-		reinterpret_cast<GLuint const*>(&buffers[0])
-	);
+	if (buffers.empty()) {
+		return;
+	}
+
+	std::vector<GLuint> ids;
+	ids.reserve(buffers.size());
+	std::transform(buffers.begin(), buffers.end(), std::back_inserter(ids), [](BufferId id) {
+		return id.value;
+	});
+
+	::glDeleteBuffers(static_cast<GLsizei>(ids.size()), &ids[0]);
 
 	onError([] (error::ErrorType e) {
 		THROW_GL_ERROR("glDeleteBuffers", e);
@@ -264,6 +815,51 @@ detail::getBufferSubData(
 	});
 }
 
+void
+detail::copyBufferSubData(
+	gl::BufferTarget	readTarget,
+	gl::BufferTarget	writeTarget,
+	GLintptr			readOffset,
+	GLintptr			writeOffset,
+	GLsizeiptr			size
+) {
+	::glCopyBufferSubData(readTarget, writeTarget, readOffset, writeOffset, size);
+
+	onError([&readTarget, &writeTarget] (error::ErrorType e) {
+		THROW_GL_ERROR_INFO("glCopyBufferSubData", e,
+			error::buffer_target(readTarget) << error::buffer_target(writeTarget)
+		);
+	});
+}
+
+GLvoid*
+detail::mapBufferRange(
+	gl::BufferTarget	target,
+	GLintptr			offset,
+	GLsizeiptr			length,
+	GLbitfield			access
+) {
+	GLvoid* const result = ::glMapBufferRange(target, offset, length, access);
+
+	onError([&target] (error::ErrorType e) {
+		THROW_GL_ERROR_INFO("glMapBufferRange", e, error::buffer_target(target));
+	});
+
+	return result;
+}
+
+bool
+detail::unmapBuffer(gl::BufferTarget target)
+{
+	GLboolean const result = ::glUnmapBuffer(target);
+
+	onError([&target] (error::ErrorType e) {
+		THROW_GL_ERROR_INFO("glUnmapBuffer", e, error::buffer_target(target));
+	});
+
+	return result == GL_TRUE;
+}
+
 void
 detail::shaderSource(
 	gl::ShaderId		shader,
@@ -316,6 +912,58 @@ detail::linkProgram(gl::ProgramId program)
 	});
 }
 
+void
+detail::programParameter(gl::ProgramId program, GLenum const pname, GLint const value)
+{
+	::glProgramParameteri(program.value, pname, value);
+
+	onError([&program] (error::ErrorType e) {
+		THROW_GL_ERROR_INFO("glProgramParameteri", e, error::program_id(program));
+	});
+}
+
+std::vector<GLubyte>
+detail::getProgramBinary(gl::ProgramId program, GLenum& format)
+{
+	std::vector<GLubyte> result(get::program::binaryLength(program));
+	GLsizei length = 0;
+
+	if (!result.empty()) {
+		::glGetProgramBinary(program.value, static_cast<GLsizei>(result.size()), &length, &format, &result[0]);
+	}
+
+	onError([&program] (error::ErrorType e) {
+		THROW_GL_ERROR_INFO("glGetProgramBinary", e, error::program_id(program));
+	});
+
+	result.resize(length);
+	return result;
+}
+
+void
+detail::programBinary(gl::ProgramId program, GLenum const format, std::vector<GLubyte> const& binary)
+{
+	::glProgramBinary(
+		program.value, format,
+		binary.empty() ? nullptr : &binary[0],
+		static_cast<GLsizei>(binary.size())
+	);
+
+	onError([&program] (error::ErrorType e) {
+		THROW_GL_ERROR_INFO("glProgramBinary", e, error::program_id(program));
+	});
+}
+
+void
+detail::maxShaderCompilerThreads(GLuint const count)
+{
+	::glMaxShaderCompilerThreadsKHR(count);
+
+	onError([] (error::ErrorType e) {
+		THROW_GL_ERROR("glMaxShaderCompilerThreadsKHR", e);
+	});
+}
+
 void
 detail::compileShader(gl::ShaderId shader)
 {
@@ -364,6 +1012,18 @@ detail::deleteShader(gl::ShaderId shader)
 	});
 }
 
+gl::String
+detail::getString(GLenum const name)
+{
+	GLubyte const* const result = ::glGetString(name);
+
+	onError([] (error::ErrorType e) {
+		THROW_GL_ERROR("glGetString", e);
+	});
+
+	return result ? String(reinterpret_cast<char const*>(result)) : String();
+}
+
 gl::AttributeLocation
 detail::getAttribLocation(
 	gl::ProgramId		program,
@@ -496,6 +1156,12 @@ detail::get::shader::isCompiled(gl::ShaderId shader)
 	return get_(shader, GL_COMPILE_STATUS) == GL_TRUE;
 }
 
+bool
+detail::get::shader::isComplete(gl::ShaderId shader)
+{
+	return get_(shader, GL_COMPLETION_STATUS_KHR) == GL_TRUE;
+}
+
 gl::String
 detail::get::shader::infoLog(gl::ShaderId shader)
 {
@@ -560,6 +1226,16 @@ detail::get::program::activeAttribsMaxLength(gl::ProgramId program) {
 	return get_(program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH);
 }
 
+unsigned
+detail::get::program::binaryLength(gl::ProgramId program) {
+	return get_(program, GL_PROGRAM_BINARY_LENGTH);
+}
+
+bool
+detail::get::program::isComplete(gl::ProgramId program) {
+	return get_(program, GL_COMPLETION_STATUS_KHR) == GL_TRUE;
+}
+
 gl::String
 detail::get::program::infoLog(gl::ProgramId program)
 {
@@ -51,6 +51,9 @@ namespace vox {
 		typedef Handle<struct tag_gl_buffer_id>  BufferId;
 		typedef Handle<struct tag_gl_array_id>   ArrayId;
         typedef Handle<struct tag_gl_texture_id> TextureId;
+		typedef Handle<struct tag_gl_framebuffer_id>	FramebufferId;
+		typedef Handle<struct tag_gl_renderbuffer_id>	RenderbufferId;
+		typedef Handle<struct tag_gl_query_id>			QueryId;
         
         typedef Handle<struct tag_gl_texture_unit, GLenum> TextureUnit;
 
@@ -173,6 +176,71 @@ namespace vox {
             TEXTURE_2DM  = GL_TEXTURE_2D_MULTISAMPLE,
             TEXTURE_2DMA = GL_TEXTURE_2D_MULTISAMPLE_ARRAY,
         };
+
+        //sized internal formats for immutable storage
+        enum TextureFormat {
+            TEXTURE_FORMAT_R8           = GL_R8,
+            TEXTURE_FORMAT_RG8          = GL_RG8,
+            TEXTURE_FORMAT_RGB8         = GL_RGB8,
+            TEXTURE_FORMAT_RGBA8        = GL_RGBA8,
+            TEXTURE_FORMAT_SRGB8_ALPHA8 = GL_SRGB8_ALPHA8,
+            TEXTURE_FORMAT_RGBA16F      = GL_RGBA16F,
+            TEXTURE_FORMAT_R32F         = GL_R32F,
+            TEXTURE_FORMAT_DEPTH24      = GL_DEPTH_COMPONENT24,
+            TEXTURE_FORMAT_DEPTH32F     = GL_DEPTH_COMPONENT32F,
+            TEXTURE_FORMAT_DEPTH24_STENCIL8 = GL_DEPTH24_STENCIL8,
+        };
+
+        //layout of pixel data passed to or read from a texture
+        enum PixelFormat {
+            PIXEL_FORMAT_RED   = GL_RED,
+            PIXEL_FORMAT_RG    = GL_RG,
+            PIXEL_FORMAT_RGB   = GL_RGB,
+            PIXEL_FORMAT_BGR   = GL_BGR,
+            PIXEL_FORMAT_RGBA  = GL_RGBA,
+            PIXEL_FORMAT_BGRA  = GL_BGRA,
+            PIXEL_FORMAT_DEPTH = GL_DEPTH_COMPONENT,
+        };
+
+        enum TextureFilter {
+            TEXTURE_FILTER_NEAREST                = GL_NEAREST,
+            TEXTURE_FILTER_LINEAR                 = GL_LINEAR,
+            TEXTURE_FILTER_NEAREST_MIPMAP_NEAREST = GL_NEAREST_MIPMAP_NEAREST,
+            TEXTURE_FILTER_LINEAR_MIPMAP_NEAREST  = GL_LINEAR_MIPMAP_NEAREST,
+            TEXTURE_FILTER_NEAREST_MIPMAP_LINEAR  = GL_NEAREST_MIPMAP_LINEAR,
+            TEXTURE_FILTER_LINEAR_MIPMAP_LINEAR   = GL_LINEAR_MIPMAP_LINEAR,
+        };
+
+        enum TextureWrap {
+            TEXTURE_WRAP_REPEAT          = GL_REPEAT,
+            TEXTURE_WRAP_MIRRORED_REPEAT = GL_MIRRORED_REPEAT,
+            TEXTURE_WRAP_CLAMP_TO_EDGE   = GL_CLAMP_TO_EDGE,
+            TEXTURE_WRAP_CLAMP_TO_BORDER = GL_CLAMP_TO_BORDER,
+        };
+
+        enum QueryTarget {
+            QUERY_TIME_ELAPSED         = GL_TIME_ELAPSED,
+            QUERY_SAMPLES_PASSED       = GL_SAMPLES_PASSED,
+            QUERY_ANY_SAMPLES_PASSED   = GL_ANY_SAMPLES_PASSED,
+            QUERY_PRIMITIVES_GENERATED = GL_PRIMITIVES_GENERATED,
+            QUERY_TIMESTAMP            = GL_TIMESTAMP, //queryCounter only
+        };
+
+        enum FramebufferTarget {
+            FRAMEBUFFER_TARGET_BOTH = GL_FRAMEBUFFER,
+            FRAMEBUFFER_TARGET_DRAW = GL_DRAW_FRAMEBUFFER,
+            FRAMEBUFFER_TARGET_READ = GL_READ_FRAMEBUFFER,
+        };
+
+        enum FramebufferAttachment {
+            ATTACHMENT_COLOR0        = GL_COLOR_ATTACHMENT0,
+            ATTACHMENT_COLOR1        = GL_COLOR_ATTACHMENT1,
+            ATTACHMENT_COLOR2        = GL_COLOR_ATTACHMENT2,
+            ATTACHMENT_COLOR3        = GL_COLOR_ATTACHMENT3,
+            ATTACHMENT_DEPTH         = GL_DEPTH_ATTACHMENT,
+            ATTACHMENT_STENCIL       = GL_STENCIL_ATTACHMENT,
+            ATTACHMENT_DEPTH_STENCIL = GL_DEPTH_STENCIL_ATTACHMENT,
+        };
                 
 
 		///////////////////////////////////////////////////////////////////////
@@ -195,6 +263,7 @@ namespace vox {
 			struct linker_error			: virtual gl_error {};
 			struct invalid_var			: virtual gl_error {};
 			struct type_mismatch		: virtual gl_error {};
+			struct incomplete_framebuffer	: virtual gl_error {};
 
 			typedef ::boost::error_info<struct tag_error_num, ErrorType>			error_num;
 			typedef ::boost::error_info<struct tag_program_id, ProgramId>			program_id;
@@ -213,6 +282,16 @@ namespace vox {
 
 			typedef ::boost::error_info<struct tag_array_id, ArrayId>				array_id;
 
+			typedef ::boost::error_info<struct tag_texture_id, TextureId>			texture_id;
+			typedef ::boost::error_info<struct tag_texture_target, TextureTarget>	texture_target;
+
+			typedef ::boost::error_info<struct tag_framebuffer_id, FramebufferId>			framebuffer_id;
+			typedef ::boost::error_info<struct tag_framebuffer_target, FramebufferTarget>	framebuffer_target;
+			typedef ::boost::error_info<struct tag_framebuffer_status, GLenum>				framebuffer_status;
+			typedef ::boost::error_info<struct tag_renderbuffer_id, RenderbufferId>			renderbuffer_id;
+			typedef ::boost::error_info<struct tag_query_id, QueryId>						query_id;
+			typedef ::boost::error_info<struct tag_query_target, QueryTarget>				query_target;
+
 			typedef ::boost::error_info<struct tag_info_log, String>				info_log;
 			typedef ::boost::error_info<struct tag_file_name, FileName>				file_name;
 
@@ -245,11 +324,60 @@ namespace vox {
 
 			void onError(::std::function<void (error::ErrorType glError)> errfunc);
 
+			::std::vector<TextureId> genTextures(unsigned n);
+			void deleteTextures(std::vector<TextureId> const& textures);
 			void deleteTexture(TextureId texture);
             TextureId genTexture();
             void bindTexture(TextureTarget target, TextureId texture);
 
+			//bind texture to target on unit, skipping the call if the calling
+			//thread's context already has it bound there; every texture bind
+			//must go through here or be followed by resetTextureBindings
+			void bindTexture(unsigned unit, TextureTarget target, TextureId texture);
+			void resetTextureBindings();
+
+			void texStorage2D(TextureTarget target, unsigned levels, TextureFormat format, GLsizei width, GLsizei height);
+			void texStorage3D(TextureTarget target, unsigned levels, TextureFormat format, GLsizei width, GLsizei height, GLsizei depth);
+			void texSubImage2D(TextureTarget target, GLint level, GLint x, GLint y, GLsizei width, GLsizei height, PixelFormat format, DataType type, GLvoid const* data);
+			void texSubImage3D(TextureTarget target, GLint level, GLint x, GLint y, GLint z, GLsizei width, GLsizei height, GLsizei depth, PixelFormat format, DataType type, GLvoid const* data);
+			void texParameter(TextureTarget target, GLenum name, GLint value);
+			void texParameter(TextureTarget target, GLenum name, GLfloat value);
+			void generateMipmap(TextureTarget target);
+
             ::std::vector<BufferId> genBuffers(unsigned n);
+			FramebufferId genFramebuffer();
+			void deleteFramebuffer(FramebufferId framebuffer);
+			void bindFramebuffer(FramebufferTarget target, FramebufferId framebuffer);
+			//bind the window's framebuffer
+			void bindFramebuffer(FramebufferTarget target);
+			void framebufferTexture(FramebufferTarget target, FramebufferAttachment attachment, TextureId texture, GLint level);
+			void framebufferRenderbuffer(FramebufferTarget target, FramebufferAttachment attachment, RenderbufferId renderbuffer);
+			//GL_FRAMEBUFFER_COMPLETE or the reason the bound framebuffer isn't
+			GLenum checkFramebufferStatus(FramebufferTarget target);
+			//copy between the bound read and draw framebuffers; mask is a
+			//combination of the GL_*_BUFFER_BIT bits
+			void blitFramebuffer(
+				GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1,
+				GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1,
+				GLbitfield mask, TextureFilter filter
+			);
+
+			QueryId genQuery();
+			void deleteQuery(QueryId query);
+			void beginQuery(QueryTarget target, QueryId query);
+			void endQuery(QueryTarget target);
+			//record the GPU time in ns once every command before it is done
+			void queryCounter(QueryId query);
+			//true once the result of query can be read without waiting
+			bool isQueryResultAvailable(QueryId query);
+			//waits for the result if it isn't available
+			GLuint64 getQueryResult(QueryId query);
+
+			RenderbufferId genRenderbuffer();
+			void deleteRenderbuffer(RenderbufferId renderbuffer);
+			void bindRenderbuffer(RenderbufferId renderbuffer);
+			void renderbufferStorage(TextureFormat format, GLsizei width, GLsizei height);
+
 			BufferId genBuffer();
 			void deleteBuffers(std::vector<BufferId> const& buffers);
 			void deleteBuffer(BufferId buffer);
@@ -258,13 +386,28 @@ namespace vox {
 			void bufferData(BufferTarget target, GLsizeiptr size, const GLvoid* data, BufferUsage usage);
 			void bufferSubData(BufferTarget target, GLintptr offset, GLsizeiptr size, const GLvoid* data);
 			void getBufferSubData(BufferTarget target, GLintptr offset, GLsizeiptr size, GLvoid* data);
+			void copyBufferSubData(BufferTarget readTarget, BufferTarget writeTarget, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size);
+			//access is a combination of the GL_MAP_* bits
+			GLvoid* mapBufferRange(BufferTarget target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+			//false if the contents were lost while mapped and must be set again
+			bool unmapBuffer(BufferTarget target);
 
 			ProgramId createProgram();
 			void deleteProgram(ProgramId program);
 			void linkProgram(ProgramId program);
+			void programParameter(ProgramId program, GLenum pname, GLint value);
+			//the linked program as a driver specific blob, in format
+			::std::vector<GLubyte> getProgramBinary(ProgramId program, GLenum& format);
+			//replace program with a blob from getProgramBinary; the driver may
+			//refuse it, so check get::program::isLinked after
+			void programBinary(ProgramId program, GLenum format, ::std::vector<GLubyte> const& binary);
 			void useProgram(ProgramId program);
 			void useProgram();
 
+			//let the driver compile and link on up to count threads of its own;
+			//needs KHR_parallel_shader_compile
+			void maxShaderCompilerThreads(GLuint count);
+
 			ShaderId createShader(ShaderType shaderType);
 			void shaderSource(ShaderId shader, String const& source);
 			void compileShader(ShaderId shader);
@@ -274,7 +417,7 @@ namespace vox {
 
 			::std::vector<ArrayId> genVertexArrays(unsigned n);
 			ArrayId genVertexArray();
-			void deleteVertexArrays(std::vector<ArrayId>& arrays);
+			void deleteVertexArrays(std::vector<ArrayId> const& arrays);
 			void deleteVertexArray(ArrayId array);
 			void bindVertexArray(ArrayId array);
 			void bindVertexArray();
@@ -284,6 +427,30 @@ namespace vox {
 
             void drawArrays(DrawMode mode, GLint first, GLsizei count);
 
+			//data is an offset into the bound pixel pack buffer if there is one
+			void readPixels(GLint x, GLint y, GLsizei width, GLsizei height, PixelFormat format, DataType type, GLvoid* data);
+
+			//a fence after every command issued so far
+			GLsync fenceSync();
+			//true once the GPU has passed fence; never waits
+			bool isSignaled(GLsync fence);
+			void deleteSync(GLsync fence);
+
+			//a name from the calling thread's HandlePools if it has one, else
+			//straight from the driver
+			BufferId	acquireBuffer();
+			ArrayId		acquireVertexArray();
+			TextureId	acquireTexture();
+
+			//names go back to the calling thread's HandlePools to be deleted
+			//at its next flush, or are deleted at once if it has none
+			void releaseBuffer(BufferId buffer);
+			void releaseVertexArray(ArrayId array);
+			void releaseTexture(TextureId texture);
+
+			//glGetString; empty if name has no value
+			String getString(GLenum name);
+
 			AttributeLocation getAttribLocation(ProgramId program, String const& name);
 			
 			variable_info getActiveUniform(ProgramId program, GLuint index, GLsizei bufSize);
@@ -314,6 +481,18 @@ namespace vox {
 						);
 					});
 				}
+
+				template <>
+				void setUniform<1, 1, GLint>(UniformLocation location, GLint const* data, unsigned size, GLboolean) {
+					::glUniform1iv(location.value, size, data);
+
+					onError([&location] (error::ErrorType e) {
+						BOOST_THROW_EXCEPTION(error::api_error()
+							<< boost::errinfo_api_function("glUniform1iv") << error::error_num(e)
+							<< error::uniform_loc(location)
+						);
+					});
+				}
 			} // namespace anon
 
 			namespace get {
@@ -330,6 +509,14 @@ namespace vox {
 					template <> static BufferId bufferBinding<BUFFER_TARGET_ARRAY>() {
 						return BufferId(get_(GL_ARRAY_BUFFER_BINDING));
 					}
+
+					template <> static BufferId bufferBinding<BUFFER_TARGET_PIXEL_UNPACK>() {
+						return BufferId(get_(GL_PIXEL_UNPACK_BUFFER_BINDING));
+					}
+
+					template <> static BufferId bufferBinding<BUFFER_TARGET_PIXEL_PACK>() {
+						return BufferId(get_(GL_PIXEL_PACK_BUFFER_BINDING));
+					}
 				private:
 					static GLint get_(GLenum param) {
 						GLint result;
@@ -358,6 +545,10 @@ namespace vox {
 					static unsigned activeUniformsMaxLength(ProgramId program);
 					static unsigned	activeAttribs(ProgramId program);
 					static unsigned activeAttribsMaxLength(ProgramId program);
+					static unsigned	binaryLength(ProgramId program);
+					//false while the driver is still linking; needs
+					//KHR_parallel_shader_compile
+					static bool		isComplete(ProgramId program);
 				private:
 					static GLint get_(ProgramId program, GLenum param);
 				};
@@ -366,6 +557,9 @@ namespace vox {
 					static unsigned	logLength(ShaderId shader);
 					static bool		isCompiled(ShaderId shader);
 					static String	infoLog(ShaderId shader);
+					//false while the driver is still compiling; needs
+					//KHR_parallel_shader_compile
+					static bool		isComplete(ShaderId shader);
 				private:
 					static GLint get_(ShaderId shader, GLenum param);
 				};
@@ -410,7 +604,7 @@ namespace vox {
 			typedef BufferId pointer;
 
 			void operator()(BufferId const& handle) const {
-				detail::deleteBuffer(handle);
+				detail::releaseBuffer(handle);
 			}
 		};
 
@@ -419,7 +613,43 @@ namespace vox {
 			typedef ArrayId pointer;
 
 			void operator()(ArrayId const& handle) const {
-				detail::deleteVertexArray(handle);
+				detail::releaseVertexArray(handle);
+			}
+		};
+
+		//deleter for TextureId
+		template <> struct handle_deleter<TextureId> {
+			typedef TextureId pointer;
+
+			void operator()(TextureId const& handle) const {
+				detail::releaseTexture(handle);
+			}
+		};
+
+		//deleter for FramebufferId
+		template <> struct handle_deleter<FramebufferId> {
+			typedef FramebufferId pointer;
+
+			void operator()(FramebufferId const& handle) const {
+				detail::deleteFramebuffer(handle);
+			}
+		};
+
+		//deleter for RenderbufferId
+		template <> struct handle_deleter<RenderbufferId> {
+			typedef RenderbufferId pointer;
+
+			void operator()(RenderbufferId const& handle) const {
+				detail::deleteRenderbuffer(handle);
+			}
+		};
+
+		//deleter for QueryId
+		template <> struct handle_deleter<QueryId> {
+			typedef QueryId pointer;
+
+			void operator()(QueryId const& handle) const {
+				detail::deleteQuery(handle);
 			}
 		};
 
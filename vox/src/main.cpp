@@ -1,5 +1,12 @@
 #include "common.hpp"
 #include "renderer/renderer.hpp"
+#include "world/chunkStreamer.hpp"
+#include "world/lighting.hpp"
+#include "world/terrainGenerator.hpp"
+#include "world/simulation.hpp"
+#include "util/threadPool.hpp"
+#include "util/profiler.hpp"
+#include "util/util.hpp"
 
 int
 wmain(int argc, wchar_t* argv[], wchar_t* envp[])
@@ -7,8 +14,9 @@ try {
     std::shared_ptr<vox::RenderWindow> window(
         new vox::RenderWindow(1024, 768)
     );
-    
-    vox::RenderTask renderer(window);
+
+    vox::util::ThreadPool pool;
+    vox::RenderTask       renderer(window, pool);
 
     window->setOnResize([&renderer](unsigned width, unsigned height) -> bool {
         renderer.setViewport(width, height);
@@ -22,12 +30,61 @@ try {
         return true;
     });
 
+    vox::world::World            world;
+    vox::world::LightEngine      light(world);
+    vox::world::TerrainGenerator generator(1);
+
+    vox::world::ChunkStreamer streamer(world, light, generator, nullptr, pool);
+
+    streamer.setOnMeshReady([&renderer](vox::world::ChunkStreamer::mesh_ptr mesh, std::function<void ()> onVisible) {
+        renderer.submitChunkMesh(mesh, onVisible);
+    });
+
+    streamer.setOnUnload([&renderer](vox::world::ChunkPos pos) {
+        renderer.removeChunkMesh(pos);
+    });
+
+    //ticks on its own thread; the renderer draws from its newest snapshot
+    vox::world::Simulation simulation(streamer);
+
+    vox::world::CameraState camera;
+    camera.position = Eigen::Vector3f(0.0f, 80.0f, 0.0f);
+    simulation.setCamera(camera);
+
+    renderer.setSnapshots(&simulation.snapshots());
+
+    //the renderer reads the simulation's snapshots, so it must stop before
+    //the simulation goes, however this scope is left
+    vox::util::on_scope_exit stopRenderer([&renderer] {
+        renderer.stop();
+    });
+
     renderer.start();
+    simulation.start();
 
     while (!finished) {
         window->doEvents();
+
+        //a job or the render thread that threw is a bug; don't carry on
+        //without it
+        boost::exception_ptr error = pool.takeError();
+        if (!error) {
+            error = renderer.takeError();
+        }
+
+        if (error) {
+            boost::rethrow_exception(error);
+        }
     }
 
+    simulation.stop();
+
+#if defined( VOX_PROFILE )
+    //open in chrome://tracing
+    std::ofstream trace("vox_trace.json");
+    vox::util::Profiler::exportChromeTrace(trace);
+#endif
+
 	return 0;
 } catch (vox::exception& e) {
     std::cout << diagnostic_information(e);
@@ -0,0 +1,129 @@
+#include "common.hpp"
+#include "blockAtlas.hpp"
+#include "textureStreamer.hpp"
+
+#include <fstream>
+
+namespace vgl = ::vox::gl;
+
+namespace {
+    //sharpest filtering the atlas asks for; drivers clamp it to what they have
+    float const ATLAS_ANISOTROPY = 8.0f;
+
+    //magenta and black squares, so a missing texture stands out
+    void placeholder(unsigned size, unsigned char* rgba) {
+        for (unsigned y = 0; y < size; ++y) {
+            for (unsigned x = 0; x < size; ++x) {
+                bool const magenta = ((x * 8 / size) ^ (y * 8 / size)) & 1;
+
+                rgba[0] = magenta ? 255 : 0;
+                rgba[1] = 0;
+                rgba[2] = magenta ? 255 : 0;
+                rgba[3] = 255;
+                rgba += 4;
+            }
+        }
+    }
+} //namespace anon
+
+vox::BlockAtlas::BlockAtlas(
+    world::BlockTextures const& textures,
+    unsigned                    size,
+    loader_t const&             load
+)
+    : textures_(textures)
+    , texture_()
+{
+    assert(size > 0);
+
+    unsigned const layers     = std::max(textures_.layerCount(), 1u);
+    unsigned const layerBytes = size * size * 4;
+
+    texture_.setStorage(vgl::TEXTURE_FORMAT_RGBA8, size, size, layers);
+
+    vgl::Buffer<vgl::BUFFER_USAGE_STREAM_DRAW, vgl::BUFFER_TARGET_PIXEL_UNPACK> pixels;
+    pixels.bind();
+    pixels.allocate(layers * layerBytes);
+
+    //the driver may throw the contents away while mapped; then do it again
+    do {
+        unsigned char* const data = static_cast<unsigned char*>(pixels.map(
+            0, layers * layerBytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT
+        ));
+
+        for (unsigned i = 0; i < layers; ++i) {
+            unsigned char* const layer = data + i * layerBytes;
+
+            if (i >= textures_.layerCount() || !load || !load(textures_.names()[i], size, layer)) {
+                placeholder(size, layer);
+            }
+        }
+    } while (!pixels.unmap());
+
+    //every layer in one copy from offset 0 of the unpack buffer
+    texture_.setImage(
+        0, 0, 0, 0, size, size, layers,
+        vgl::PIXEL_FORMAT_RGBA, vgl::DATA_TYPE_UBYTE, nullptr
+    );
+
+    //anything uploaded from client memory later must not read the buffer
+    pixels.unbind();
+
+    texture_.generateMipmaps();
+    texture_.setFilter(vgl::TEXTURE_FILTER_NEAREST_MIPMAP_LINEAR, vgl::TEXTURE_FILTER_NEAREST);
+    texture_.setWrap(vgl::TEXTURE_WRAP_REPEAT, vgl::TEXTURE_WRAP_REPEAT);
+    texture_.setAnisotropy(ATLAS_ANISOTROPY);
+}
+
+void
+vox::BlockAtlas::stream(TextureStreamer& streamer, loader_t const& load)
+{
+    assert(load);
+
+    unsigned const size = this->size();
+
+    for (unsigned i = 0; i < textures_.layerCount(); ++i) {
+        std::string const name = textures_.names()[i];
+
+        streamer.request(size * size * 4,
+            [load, name, size](unsigned char* rgba) {
+                return load(name, size, rgba);
+            },
+            [this, i, size](GLvoid const* pixels) {
+                texture_.setImage(
+                    0, 0, 0, i, size, size, 1,
+                    vgl::PIXEL_FORMAT_RGBA, vgl::DATA_TYPE_UBYTE, pixels
+                );
+                texture_.generateMipmaps();
+            }
+        );
+    }
+}
+
+vox::BlockAtlas::loader_t
+vox::BlockAtlas::rawFileLoader(std::string const& directory)
+{
+    return [directory](std::string const& name, unsigned size, unsigned char* rgba) -> bool {
+        std::ifstream in((directory + "/" + name + ".rgba").c_str(), std::ios::binary);
+
+        std::streamsize const bytes = static_cast<std::streamsize>(size) * size * 4;
+        in.read(reinterpret_cast<char*>(rgba), bytes);
+
+        return in && in.gcount() == bytes;
+    };
+}
+
+void
+vox::BlockAtlas::setUniforms(gl::Program const& program, unsigned unit) const
+{
+    GLint const sampler = static_cast<GLint>(unit);
+
+    vgl::detail::setUniform<1, 1>(
+        vgl::detail::getUniformLocation(program.id(), "blockTextures"), &sampler
+    );
+
+    vgl::detail::setUniform<1, 1>(
+        vgl::detail::getUniformLocation(program.id(), "blockLayers"),
+        textures_.layerTable(), textures_.layerTableSize()
+    );
+}
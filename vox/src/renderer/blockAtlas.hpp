@@ -0,0 +1,62 @@
+#pragma once
+#ifndef VOX_RENDERER_BLOCK_ATLAS_HPP
+#define VOX_RENDERER_BLOCK_ATLAS_HPP
+
+#include <functional>
+#include <string>
+#include <boost/utility.hpp>
+
+#include "../gl/vgl.hpp"
+#include "../world/blockTextures.hpp"
+
+namespace vox {
+
+class TextureStreamer;
+
+////////////////////////////////////////////////////////////////////////////////
+// Every block face texture in one RGBA8 2D array texture, one layer per
+// distinct texture of a world::BlockTextures, so the world draws with a
+// single texture binding. The shader picks the layer of a vertex from the
+// block and face in its in_Data with the table set by setUniforms().
+//
+// Layers are written by the loader straight into a mapped pixel unpack
+// buffer, then copied into the array with one glTexSubImage3D from the
+// buffer; the call returns as soon as the transfer is queued instead of
+// waiting on a copy out of client memory. stream() instead loads layers on
+// workers after the atlas is made. Must be made on the render thread.
+////////////////////////////////////////////////////////////////////////////////
+class BlockAtlas : private boost::noncopyable {
+public:
+    //fill size x size RGBA8 pixels, rows bottom up, for the named texture;
+    //false leaves a placeholder in the layer
+    typedef std::function<bool (std::string const& name, unsigned size, unsigned char* rgba)> loader_t;
+
+    //layers are size x size with a full mip chain; without load every layer
+    //starts as the placeholder
+    BlockAtlas(world::BlockTextures const& textures, unsigned size, loader_t const& load = loader_t());
+
+    //replace each layer as streamer gets to it, calling load on its workers;
+    //the atlas must outlive the streamer
+    void stream(TextureStreamer& streamer, loader_t const& load);
+
+    //loads <directory>/<name>.rgba, raw pixels of exactly the layer size
+    static loader_t rawFileLoader(std::string const& directory);
+
+    //point program's blockTextures sampler at unit and set its blockLayers
+    //table; program must be in use
+    void setUniforms(gl::Program const& program, unsigned unit) const;
+
+    void bind(unsigned unit) const { texture_.bind(unit); }
+    gl::TextureId id() const { return texture_.id(); }
+
+    world::BlockTextures const& textures() const { return textures_; }
+    unsigned size()   const { return texture_.width(); }
+    unsigned layers() const { return texture_.depth(); }
+private:
+    world::BlockTextures textures_;
+    gl::Texture2DArray   texture_;
+};
+
+} //namespace vox
+
+#endif //VOX_RENDERER_BLOCK_ATLAS_HPP
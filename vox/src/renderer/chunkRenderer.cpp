@@ -0,0 +1,204 @@
+#include "common.hpp"
+#include "chunkRenderer.hpp"
+#include "glCommandExecutor.hpp"
+#include "../util/threadPool.hpp"
+#include "../util/profiler.hpp"
+
+namespace vgl = ::vox::gl;
+
+namespace {
+    //bytes of vertices the heap starts with; it doubles when full
+    unsigned const HEAP_CAPACITY = 16 * 1024 * 1024;
+
+    //the heap is defragmented once holes waste more than
+    //1/HEAP_MAX_WASTE_DIVISOR of it
+    unsigned const HEAP_MAX_WASTE_DIVISOR = 4;
+
+    //texture unit the block atlas stays bound to
+    unsigned const ATLAS_UNIT = 0;
+
+    //chunks recorded per job; a few hundred keeps each job well over the
+    //cost of handing it to a worker
+    unsigned const RECORD_GRAIN = 256;
+
+    //true if a chunk's bounds, taken to clip space by clip, are entirely
+    //outside one of the frustum planes
+    bool outsideFrustum(Eigen::Matrix4f const& clip) {
+        unsigned outside[6] = {0};
+
+        for (unsigned i = 0; i < 8; ++i) {
+            Eigen::Vector4f const corner(
+                (i & 1) ? static_cast<float>(vox::world::CHUNK_SIZE_X) : 0.0f,
+                (i & 2) ? static_cast<float>(vox::world::CHUNK_SIZE_Y) : 0.0f,
+                (i & 4) ? static_cast<float>(vox::world::CHUNK_SIZE_Z) : 0.0f,
+                1.0f
+            );
+
+            Eigen::Vector4f const p = clip * corner;
+
+            outside[0] += p.x() < -p.w();
+            outside[1] += p.x() >  p.w();
+            outside[2] += p.y() < -p.w();
+            outside[3] += p.y() >  p.w();
+            outside[4] += p.z() < -p.w();
+            outside[5] += p.z() >  p.w();
+        }
+
+        return std::find(outside, outside + 6, 8u) != outside + 6;
+    }
+} //namespace anon
+
+vox::ChunkRenderer::ChunkRenderer(gl::Program const& program, BlockAtlas const& atlas, util::ThreadPool& pool)
+    : atlas_(atlas)
+    , pool_(pool)
+    , program_(program.id())
+    , position_(gl::detail::getAttribLocation(program.id(), "in_Position"))
+    , data_(gl::detail::getAttribLocation(program.id(), "in_Data"))
+    , heap_(HEAP_CAPACITY, sizeof(world::ChunkVertex))
+    , array_()
+    , attached_(0)
+    , recorder_(RECORD_GRAIN)
+    , stats_()
+{
+    atlas_.setUniforms(program, ATLAS_UNIT);
+    attach_();
+}
+
+void
+vox::ChunkRenderer::attach_()
+{
+    unsigned const stride = sizeof(world::ChunkVertex);
+
+    array_.bind();
+    vgl::detail::bindBuffer(vgl::BUFFER_TARGET_ARRAY, heap_.id());
+
+    //x, y, z then face, light, block and a pad byte; the shader unpacks the
+    //face and ambient occlusion bits itself
+    vgl::detail::vertexAttribPointer(
+        position_, vgl::ATTR_SIZE_3, vgl::DATA_TYPE_UBYTE, GL_FALSE, stride, nullptr
+    );
+    vgl::detail::enableVertexAttribArray(position_);
+
+    vgl::detail::vertexAttribPointer(
+        data_, vgl::ATTR_SIZE_4, vgl::DATA_TYPE_UBYTE, GL_FALSE, stride,
+        reinterpret_cast<GLvoid const*>(3)
+    );
+    vgl::detail::enableVertexAttribArray(data_);
+
+    attached_ = heap_.generation();
+}
+
+void
+vox::ChunkRenderer::upload(world::ChunkMesh const& mesh)
+{
+    remove(mesh.pos);
+
+    if (mesh.vertices.empty()) {
+        return;
+    }
+
+    unsigned const bytes = static_cast<unsigned>(mesh.vertices.size() * sizeof(world::ChunkVertex));
+
+    ChunkBlock const chunk = { heap_.allocate(bytes, &mesh.vertices[0]), static_cast<unsigned>(mesh.vertices.size()) };
+    chunks_[mesh.pos] = chunk;
+}
+
+void
+vox::ChunkRenderer::remove(world::ChunkPos pos)
+{
+    auto const it = chunks_.find(pos);
+    if (it == chunks_.end()) {
+        return;
+    }
+
+    heap_.free(it->second.block);
+    chunks_.erase(it);
+}
+
+void
+vox::ChunkRenderer::draw(
+    gl::uniform::mat4f&    mv,
+    Eigen::Matrix4f const& projection,
+    Eigen::Matrix4f const& view,
+    util::LinearArena&     frame
+) {
+    struct DrawItem {
+        ChunkBlock const* chunk;
+        world::ChunkPos   pos;
+        float             depth;
+    };
+
+    typedef std::vector<DrawItem, util::ArenaAllocator<DrawItem>> draw_list_t;
+
+    Eigen::Matrix4f const viewProjection = projection * view;
+
+    draw_list_t visible((util::ArenaAllocator<DrawItem>(frame)));
+    visible.reserve(chunks_.size());
+
+    for (auto it = chunks_.begin(); it != chunks_.end(); ++it) {
+        Eigen::Affine3f const offset(Eigen::Translation3f(
+            static_cast<float>(it->first.blockX()), 0.0f, static_cast<float>(it->first.blockZ())
+        ));
+
+        if (outsideFrustum(viewProjection * offset.matrix())) {
+            continue;
+        }
+
+        //view space depth of the chunk's centre
+        Eigen::Vector4f const centre = view * offset.matrix() * Eigen::Vector4f(
+            world::CHUNK_SIZE_X / 2.0f, world::CHUNK_SIZE_Y / 2.0f, world::CHUNK_SIZE_Z / 2.0f, 1.0f
+        );
+
+        DrawItem const item = { &it->second, it->first, -centre.z() };
+        visible.push_back(item);
+    }
+
+    if (heap_.wasted() > heap_.capacity() / HEAP_MAX_WASTE_DIVISOR) {
+        heap_.defragment();
+    }
+
+    if (attached_ != heap_.generation()) {
+        attach_();
+    }
+
+    //each packet's key carries its depth, so sorting also puts them front to
+    //back and the depth test rejects hidden chunks early
+    DrawState const state = { program_.value, atlas_.id().value, array_.id().value };
+    int const location = mv.location().value;
+
+    {
+        VOX_PROFILE_SCOPE("chunks/record");
+
+        recorder_.record(pool_, static_cast<unsigned>(visible.size()), [&](CommandBuffer& buffer, unsigned const i) {
+            DrawItem const& item = visible[i];
+
+            Eigen::Affine3f const offset(Eigen::Translation3f(
+                static_cast<float>(item.pos.blockX()), 0.0f, static_cast<float>(item.pos.blockZ())
+            ));
+
+            Eigen::Matrix4f const chunkView = view * offset.matrix();
+
+            buffer.begin(state, item.depth, PASS_OPAQUE);
+            buffer.setUniform(location, chunkView.data());
+            buffer.drawArrays(
+                vgl::DRAW_MODE_TRIANGLES,
+                static_cast<int>(heap_.offset(item.chunk->block) / sizeof(world::ChunkVertex)),
+                static_cast<int>(item.chunk->count)
+            );
+        });
+    }
+
+    VOX_PROFILE_SCOPE("chunks/replay");
+
+    CommandBuffer& commands = recorder_.merged();
+
+    stats_.draws                = commands.packets();
+    stats_.unsortedStateChanges = commands.stateChanges();
+
+    commands.sort();
+
+    stats_.stateChanges = commands.stateChanges();
+
+    GlCommandExecutor executor(ATLAS_UNIT, vgl::TEXTURE_2DA);
+    commands.replay(executor);
+}
@@ -0,0 +1,87 @@
+#pragma once
+#ifndef VOX_RENDERER_CHUNK_RENDERER_HPP
+#define VOX_RENDERER_CHUNK_RENDERER_HPP
+
+#include <map>
+#include <memory>
+#include <boost/utility.hpp>
+
+#include "../gl/vgl.hpp"
+#include "../gl/bufferHeap.hpp"
+#include "blockAtlas.hpp"
+#include "commandRecorder.hpp"
+#include "../util/frameArena.hpp"
+#include "../world/chunkMesher.hpp"
+
+namespace vox {
+
+namespace util { class ThreadPool; }
+
+////////////////////////////////////////////////////////////////////////////////
+// GPU copies of chunk meshes. Every member must be called on the render
+// thread; meshes from the streaming workers reach it through the render
+// task's queue.
+//
+// All meshes share one buffer heap, one vertex array and the block atlas;
+// a chunk is drawn from its block's offset in the heap. Draws are recorded
+// into command buffers on the pool, a group of chunks per job, and replayed
+// here.
+////////////////////////////////////////////////////////////////////////////////
+class ChunkRenderer : private boost::noncopyable {
+public:
+    //what the last draw() did
+    struct DrawStats {
+        unsigned draws;
+        unsigned stateChanges;         //as replayed, sorted
+        unsigned unsortedStateChanges; //had the draws been replayed as recorded
+    };
+
+    //program must be in use and have the in_Position and in_Data attributes
+    //and the uniforms of BlockAtlas::setUniforms(); atlas and pool must
+    //outlive this
+    ChunkRenderer(gl::Program const& program, BlockAtlas const& atlas, util::ThreadPool& pool);
+
+    //replace the mesh of mesh.pos; an empty mesh removes it
+    void upload(world::ChunkMesh const& mesh);
+    void remove(world::ChunkPos pos);
+
+    //draw the chunks inside the view frustum, sorted by state and then front
+    //to back, setting mv to view * the chunk's offset for each; the draw list
+    //is built in frame
+    void draw(
+        gl::uniform::mat4f&    mv,
+        Eigen::Matrix4f const& projection,
+        Eigen::Matrix4f const& view,
+        util::LinearArena&     frame
+    );
+
+    unsigned size() const { return static_cast<unsigned>(chunks_.size()); }
+    DrawStats const& stats() const { return stats_; }
+private:
+    struct ChunkBlock {
+        gl::BufferHeap::handle_t block;
+        unsigned                 count;
+    };
+
+    typedef std::map<world::ChunkPos, ChunkBlock> chunks_container_t;
+
+    //point the vertex array at the heap's current buffer
+    void attach_();
+
+    BlockAtlas const&     atlas_;
+    util::ThreadPool&     pool_;
+    gl::ProgramId         program_;
+    gl::AttributeLocation position_;
+    gl::AttributeLocation data_;
+    gl::BufferHeap        heap_;
+    gl::SimpleVertexArray array_;
+    unsigned              attached_; //heap generation the array points at
+    chunks_container_t    chunks_;
+
+    CommandRecorder       recorder_;
+    DrawStats             stats_;
+};
+
+} //namespace vox
+
+#endif //VOX_RENDERER_CHUNK_RENDERER_HPP
@@ -0,0 +1,157 @@
+#include "common.hpp"
+#include "commandBuffer.hpp"
+#include "../util/radixSort.hpp"
+
+#include <algorithm>
+
+namespace {
+    typedef vox::CommandBuffer::sort_key_t sort_key_t;
+
+    //where in a key things go
+    unsigned const PASS_SHIFT    = 60;
+    unsigned const PROGRAM_SHIFT = 48;
+    unsigned const TEXTURE_SHIFT = 36;
+    unsigned const ARRAY_SHIFT   = 24;
+
+    //the names of one kind a sort can rank apart
+    unsigned const RANK_LIMIT = 1 << 12;
+
+    //the program, texture and vertex array ranks
+    sort_key_t const STATE_BITS = ((static_cast<sort_key_t>(1) << 36) - 1) << ARRAY_SHIFT;
+} //namespace anon
+
+void
+vox::CommandBuffer::begin(DrawState const& state, float const depth, DrawPass const pass)
+{
+    unsigned const at = static_cast<unsigned>(words_.size());
+
+    //the state's part of the key is filled in by sort()
+    sort_key_t const key = (static_cast<sort_key_t>(pass & 0xF) << PASS_SHIFT)
+                         | depthBucket(depth, pass);
+
+    Packet const packet = { key, state, at, at };
+    packets_.push_back(packet);
+}
+
+void
+vox::CommandBuffer::setUniform(int const location, float const* matrix)
+{
+    unsigned data[16];
+    std::memcpy(data, matrix, sizeof(data));
+
+    push_(COMMAND_UNIFORM_MAT4);
+    push_(static_cast<unsigned>(location));
+    words_.insert(words_.end(), data, data + 16);
+
+    close_();
+}
+
+void
+vox::CommandBuffer::setUniform(int const location, int const value)
+{
+    push_(COMMAND_UNIFORM_INT);
+    push_(static_cast<unsigned>(location));
+    push_(static_cast<unsigned>(value));
+
+    close_();
+}
+
+void
+vox::CommandBuffer::drawArrays(unsigned const mode, int const first, int const count)
+{
+    push_(COMMAND_DRAW_ARRAYS);
+    push_(mode);
+    push_(static_cast<unsigned>(first));
+    push_(static_cast<unsigned>(count));
+
+    close_();
+}
+
+void
+vox::CommandBuffer::append(CommandBuffer const& other)
+{
+    unsigned const offset = static_cast<unsigned>(words_.size());
+
+    words_.insert(words_.end(), other.words_.begin(), other.words_.end());
+
+    packets_.reserve(packets_.size() + other.packets_.size());
+    for (auto it = other.packets_.begin(); it != other.packets_.end(); ++it) {
+        Packet packet = *it;
+        packet.begin += offset;
+        packet.end   += offset;
+        packets_.push_back(packet);
+    }
+}
+
+void
+vox::CommandBuffer::sort()
+{
+    for (auto it = packets_.begin(); it != packets_.end(); ++it) {
+        it->key &= ~STATE_BITS;
+    }
+
+    rank_(&DrawState::program,     PROGRAM_SHIFT);
+    rank_(&DrawState::texture,     TEXTURE_SHIFT);
+    rank_(&DrawState::vertexArray, ARRAY_SHIFT);
+
+    util::radixSort(packets_, scratch_, [](Packet const& packet) {
+        return packet.key;
+    });
+}
+
+void
+vox::CommandBuffer::rank_(unsigned DrawState::* const field, unsigned const shift)
+{
+    //packets with the same state tend to be next to each other, so only
+    //look a name up when it changes
+    names_.clear();
+
+    for (auto it = packets_.begin(); it != packets_.end(); ++it) {
+        unsigned const name = (*it).state.*field;
+
+        bool const changed = it == packets_.begin() || name != (*(it - 1)).state.*field;
+        if (changed && std::find(names_.begin(), names_.end(), name) == names_.end()) {
+            names_.push_back(name);
+        }
+    }
+
+    std::sort(names_.begin(), names_.end());
+
+    sort_key_t rank = 0;
+    for (auto it = packets_.begin(); it != packets_.end(); ++it) {
+        unsigned const name = (*it).state.*field;
+
+        if (it == packets_.begin() || name != (*(it - 1)).state.*field) {
+            rank = static_cast<sort_key_t>(std::lower_bound(names_.begin(), names_.end(), name) - names_.begin());
+        }
+
+        it->key |= (rank & (RANK_LIMIT - 1)) << shift;
+    }
+}
+
+void
+vox::CommandBuffer::clear()
+{
+    packets_.clear();
+    words_.clear();
+}
+
+unsigned
+vox::CommandBuffer::stateChanges() const
+{
+    unsigned  changes = 0;
+    DrawState current = { 0, 0, 0 };
+
+    for (auto packet = packets_.begin(); packet != packets_.end(); ++packet) {
+        bool const first = packet == packets_.begin();
+        DrawState const& state = packet->state;
+
+        changes += first || state.program     != current.program;
+        changes += first || state.texture     != current.texture;
+        changes += first || state.vertexArray != current.vertexArray;
+
+        current = state;
+    }
+
+    return changes;
+}
@@ -0,0 +1,209 @@
+#pragma once
+#ifndef VOX_RENDERER_COMMAND_BUFFER_HPP
+#define VOX_RENDERER_COMMAND_BUFFER_HPP
+
+#include <vector>
+#include <cstring>
+#include <cassert>
+
+namespace vox {
+
+//GL names a packet is drawn with; 0 for none
+struct DrawState {
+    unsigned program;
+    unsigned texture;
+    unsigned vertexArray;
+};
+
+//packets are drawn a pass at a time, in this order
+enum DrawPass {
+    PASS_OPAQUE,      //front to back, for early depth rejection
+    PASS_TRANSLUCENT, //back to front, for blending
+    PASS_OVERLAY,
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Draw commands recorded without a GL context, to be replayed later on the
+// render thread. Any thread can record into its own buffer; the buffers are
+// then appended into one, sorted by state, and replayed.
+//
+// Commands are grouped into packets, each drawn with one DrawState. Replay
+// only changes state between packets whose state differs, so sorting puts
+// packets with the same program, texture and vertex array next to each
+// other, and within those orders them by depth for their pass. Packets with
+// equal keys keep the order they were recorded in.
+//
+// Commands are stored as 32 bit words: the command, then its arguments.
+////////////////////////////////////////////////////////////////////////////////
+class CommandBuffer {
+public:
+    typedef unsigned long long sort_key_t;
+
+    //start a packet; the commands up to the next begin are drawn with state.
+    //depth is the view space distance of what's drawn, >= 0
+    void begin(DrawState const& state, float depth = 0.0f, DrawPass pass = PASS_OPAQUE);
+
+    //matrix is a column major 4x4
+    void setUniform(int location, float const* matrix);
+    void setUniform(int location, int value);
+    void drawArrays(unsigned mode, int first, int count);
+
+    //add other's packets after these
+    void append(CommandBuffer const& other);
+    //order packets by a key of, most significant first: pass (4 bits),
+    //program, texture and vertex array (12 bits each; the program is the
+    //most expensive to change) and depth bucket (24 bits). GL names can be
+    //of any size, so the key holds each name's rank among the names of its
+    //kind in the buffer instead; a sort can tell up to 4096 of each apart.
+    //Past that, names share ranks and are only grouped less well.
+    void sort();
+    void clear();
+
+    //program, texture and vertex array binds a replay in the current order
+    //would make
+    unsigned stateChanges() const;
+
+    //run every command through executor, which must have:
+    //  void bindProgram(unsigned program);
+    //  void bindTexture(unsigned texture);
+    //  void bindVertexArray(unsigned array);
+    //  void setUniform(int location, float const* matrix);
+    //  void setUniform(int location, int value);
+    //  void drawArrays(unsigned mode, int first, int count);
+    template <typename executor_t>
+    void replay(executor_t& executor) const;
+
+    unsigned packets() const { return static_cast<unsigned>(packets_.size()); }
+    size_t   bytes()   const { return words_.size() * sizeof(unsigned); }
+    //bytes held, used or not; clear() keeps them for the next frame
+    size_t   capacity() const {
+        return (packets_.capacity() + scratch_.capacity()) * sizeof(Packet)
+             + (words_.capacity() + names_.capacity()) * sizeof(unsigned);
+    }
+
+    //the top 24 bits of a non negative float order the same as the float,
+    //so buckets are finer near the camera; reversed for translucent packets
+    static unsigned depthBucket(float depth, DrawPass pass) {
+        unsigned bits = 0;
+        if (depth > 0.0f) {
+            std::memcpy(&bits, &depth, sizeof(bits));
+        }
+
+        unsigned const bucket = bits >> 8;
+        return pass == PASS_TRANSLUCENT ? (~bucket & 0xFFFFFF) : bucket;
+    }
+private:
+    enum Command {
+        COMMAND_UNIFORM_MAT4, //location, 16 floats
+        COMMAND_UNIFORM_INT,  //location, value
+        COMMAND_DRAW_ARRAYS,  //mode, first, count
+    };
+
+    struct Packet {
+        sort_key_t key;
+        DrawState  state;
+        unsigned   begin; //range of words_
+        unsigned   end;
+    };
+
+    //put the rank of each packet's field among all its values into key
+    //bits [shift, shift + 12)
+    void rank_(unsigned DrawState::* field, unsigned shift);
+
+    void push_(unsigned word) { words_.push_back(word); }
+    //the last packet ends after the last word pushed
+    void close_() {
+        assert(!packets_.empty() && "commands must be in a packet");
+        packets_.back().end = static_cast<unsigned>(words_.size());
+    }
+
+    std::vector<Packet>   packets_;
+    std::vector<Packet>   scratch_; //for sorting
+    std::vector<unsigned> names_;   //for ranking
+    std::vector<unsigned> words_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Counts what a replay would do without doing it, for testing and to time
+// recording and replay apart from the driver
+////////////////////////////////////////////////////////////////////////////////
+struct NullCommandExecutor {
+    NullCommandExecutor()
+        : stateChanges(0), uniforms(0), draws(0), vertices(0)
+    {
+    }
+
+    void bindProgram(unsigned)     { ++stateChanges; }
+    void bindTexture(unsigned)     { ++stateChanges; }
+    void bindVertexArray(unsigned) { ++stateChanges; }
+
+    void setUniform(int, float const*) { ++uniforms; }
+    void setUniform(int, int)          { ++uniforms; }
+
+    void drawArrays(unsigned, int, int count) {
+        ++draws;
+        vertices += count;
+    }
+
+    unsigned stateChanges;
+    unsigned uniforms;
+    unsigned draws;
+    unsigned vertices;
+};
+
+template <typename executor_t>
+void
+CommandBuffer::replay(executor_t& executor) const
+{
+    DrawState current = { 0, 0, 0 };
+    bool      bound   = false; //nothing is known to be bound before the first packet
+
+    for (auto packet = packets_.begin(); packet != packets_.end(); ++packet) {
+        DrawState const& state = packet->state;
+
+        if (!bound || state.program != current.program) {
+            executor.bindProgram(state.program);
+        }
+
+        if (!bound || state.texture != current.texture) {
+            executor.bindTexture(state.texture);
+        }
+
+        if (!bound || state.vertexArray != current.vertexArray) {
+            executor.bindVertexArray(state.vertexArray);
+        }
+
+        current = state;
+        bound   = true;
+
+        unsigned const* it  = words_.empty() ? nullptr : &words_[0] + packet->begin;
+        unsigned const* end = words_.empty() ? nullptr : &words_[0] + packet->end;
+
+        while (it != end) {
+            switch (*it) {
+            case COMMAND_UNIFORM_MAT4 : {
+                float matrix[16];
+                std::memcpy(matrix, it + 2, sizeof(matrix));
+                executor.setUniform(static_cast<int>(it[1]), matrix);
+                it += 18;
+                break;
+            }
+            case COMMAND_UNIFORM_INT :
+                executor.setUniform(static_cast<int>(it[1]), static_cast<int>(it[2]));
+                it += 3;
+                break;
+            case COMMAND_DRAW_ARRAYS :
+                executor.drawArrays(it[1], static_cast<int>(it[2]), static_cast<int>(it[3]));
+                it += 4;
+                break;
+            default :
+                assert(0 && "corrupt command buffer");
+                return;
+            }
+        }
+    }
+}
+
+} //namespace vox
+
+#endif //VOX_RENDERER_COMMAND_BUFFER_HPP
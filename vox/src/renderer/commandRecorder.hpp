@@ -0,0 +1,78 @@
+#pragma once
+#ifndef VOX_RENDERER_COMMAND_RECORDER_HPP
+#define VOX_RENDERER_COMMAND_RECORDER_HPP
+
+#include <vector>
+#include <algorithm>
+#include <boost/utility.hpp>
+
+#include "commandBuffer.hpp"
+#include "../util/threadPool.hpp"
+
+namespace vox {
+
+////////////////////////////////////////////////////////////////////////////////
+// Records a frame's draws on the pool, grain of them per job, each job into
+// its own CommandBuffer, then appends the jobs' buffers in order into one.
+// The buffers are kept from frame to frame, so once the number of draws
+// settles recording reuses their memory; capacity() shows if it still grows.
+////////////////////////////////////////////////////////////////////////////////
+class CommandRecorder : private boost::noncopyable {
+public:
+    explicit CommandRecorder(unsigned grain)
+        : grain_(std::max(1u, grain))
+    {
+    }
+
+    //call record(buffer, i) for every i in [0, count), in parallel, then
+    //merge what was recorded in order of i
+    template <typename record_t>
+    void record(util::ThreadPool& pool, unsigned count, record_t record);
+
+    //what the last record() recorded
+    CommandBuffer&       merged()       { return merged_; }
+    CommandBuffer const& merged() const { return merged_; }
+
+    //bytes every buffer holds, used or not
+    size_t capacity() const {
+        size_t result = merged_.capacity();
+        for (auto it = groups_.begin(); it != groups_.end(); ++it) {
+            result += it->capacity();
+        }
+
+        return result;
+    }
+private:
+    unsigned                   grain_;
+    std::vector<CommandBuffer> groups_; //one per job; kept for their memory
+    CommandBuffer              merged_;
+};
+
+template <typename record_t>
+void
+CommandRecorder::record(util::ThreadPool& pool, unsigned const count, record_t record)
+{
+    unsigned const groups = (count + grain_ - 1) / grain_;
+
+    while (groups_.size() < groups) {
+        groups_.push_back(CommandBuffer());
+    }
+
+    pool.parallelFor(count, [this, &record](unsigned const first, unsigned const last) {
+        CommandBuffer& buffer = groups_[first / grain_];
+        buffer.clear();
+
+        for (unsigned i = first; i < last; ++i) {
+            record(buffer, i);
+        }
+    }, grain_);
+
+    merged_.clear();
+    for (unsigned i = 0; i < groups; ++i) {
+        merged_.append(groups_[i]);
+    }
+}
+
+} //namespace vox
+
+#endif //VOX_RENDERER_COMMAND_RECORDER_HPP
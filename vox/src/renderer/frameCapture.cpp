@@ -0,0 +1,192 @@
+#include "common.hpp"
+#include "frameCapture.hpp"
+
+#include <fstream>
+#include <boost/format.hpp>
+#include <boost/exception_ptr.hpp>
+
+#include "../util/threadPool.hpp"
+
+namespace vgl = ::vox::gl;
+
+vox::FrameCapture::FrameCapture(util::ThreadPool& pool, unsigned slots)
+    : pool_(pool)
+    , sink_()
+    , captured_(0)
+    , dropped_(0)
+{
+    assert(slots > 0);
+
+    for (unsigned i = 0; i < slots; ++i) {
+        std::unique_ptr<Slot> slot(new Slot());
+        slot->fence  = nullptr;
+        slot->pixels = nullptr;
+        slot->state  = SLOT_FREE;
+        slot->frame  = 0;
+        slot->width  = 0;
+        slot->height = 0;
+
+        slots_.push_back(std::move(slot));
+    }
+}
+
+vox::FrameCapture::~FrameCapture()
+{
+    {//lock
+        boost::unique_lock<boost::mutex> lock(mutex_);
+
+        for (auto it = slots_.begin(); it != slots_.end(); ++it) {
+            while ((*it)->state == SLOT_SINKING) {
+                sunk_.wait(lock);
+            }
+        }
+    }//unlock
+
+    //no GL calls: a buffer still mapped is unmapped when it's deleted, and
+    //nothing is left bound. Fences drop() didn't delete go with the context
+}
+
+void
+vox::FrameCapture::drop()
+{
+    while (!reading_.empty()) {
+        Slot& slot = *reading_.front();
+        reading_.pop_front();
+
+        GLsync const fence = slot.fence;
+        slot.fence = nullptr;
+        slot.sink  = sink_t();
+        slot.state = SLOT_FREE;
+
+        vgl::detail::deleteSync(fence);
+    }
+}
+
+bool
+vox::FrameCapture::capture(unsigned const frame, unsigned const width, unsigned const height)
+{
+    if (!sink_ || width == 0 || height == 0) {
+        return false;
+    }
+
+    Slot* slot = nullptr;
+    {//lock
+        boost::lock_guard<boost::mutex> lock(mutex_);
+
+        for (auto it = slots_.begin(); it != slots_.end() && !slot; ++it) {
+            if ((*it)->state == SLOT_FREE) {
+                slot = it->get();
+            }
+        }
+    }//unlock
+
+    if (!slot) {
+        ++dropped_;
+        return false;
+    }
+
+    //a fresh store each time; the last one may still be being read
+    slot->buffer.bind();
+    slot->buffer.allocate(width * height * 4);
+
+    vgl::detail::readPixels(0, 0, width, height, vgl::PIXEL_FORMAT_RGBA, vgl::DATA_TYPE_UBYTE, nullptr);
+    vgl::detail::unbindBuffer(vgl::BUFFER_TARGET_PIXEL_PACK);
+
+    slot->fence  = vgl::detail::fenceSync();
+    slot->state  = SLOT_READING;
+    slot->frame  = frame;
+    slot->width  = width;
+    slot->height = height;
+    slot->sink   = sink_;
+
+    reading_.push_back(slot);
+
+    return true;
+}
+
+void
+vox::FrameCapture::update()
+{
+    //free buffers the sink is done with
+    for (auto it = slots_.begin(); it != slots_.end(); ++it) {
+        Slot& slot = **it;
+
+        {//lock
+            boost::lock_guard<boost::mutex> lock(mutex_);
+            if (slot.state != SLOT_SUNK) {
+                continue;
+            }
+        }//unlock
+
+        slot.buffer.bind();
+        slot.buffer.unmap();
+
+        slot.pixels = nullptr;
+        slot.sink   = sink_t();
+
+        boost::lock_guard<boost::mutex> lock(mutex_);
+        slot.state = SLOT_FREE;
+    }
+
+    //map finished reads, oldest first
+    while (!reading_.empty() && vgl::detail::isSignaled(reading_.front()->fence)) {
+        Slot& slot = *reading_.front();
+        reading_.pop_front();
+
+        vgl::detail::deleteSync(slot.fence);
+        slot.fence = nullptr;
+
+        slot.buffer.bind();
+        slot.pixels = static_cast<unsigned char const*>(
+            slot.buffer.map(0, slot.width * slot.height * 4, GL_MAP_READ_BIT)
+        );
+
+        {//lock
+            boost::lock_guard<boost::mutex> lock(mutex_);
+            slot.state = SLOT_SINKING;
+        }//unlock
+
+        ++captured_;
+
+        Slot* const target = &slot;
+        pool_.enqueue([this, target] { deliver_(*target); });
+    }
+
+    vgl::detail::unbindBuffer(vgl::BUFFER_TARGET_PIXEL_PACK);
+}
+
+void
+vox::FrameCapture::deliver_(Slot& slot)
+{
+    //the slot is done with either way; what the sink throws goes on to the
+    //pool once it is
+    boost::exception_ptr error;
+    try {
+        slot.sink(slot.frame, slot.width, slot.height, slot.pixels);
+    } catch (...) {
+        error = boost::current_exception();
+    }
+
+    {//lock
+        boost::lock_guard<boost::mutex> lock(mutex_);
+        slot.state = SLOT_SUNK;
+        sunk_.notify_all();
+    }//unlock
+
+    if (error) {
+        boost::rethrow_exception(error);
+    }
+}
+
+vox::FrameCapture::sink_t
+vox::FrameCapture::rawFileSink(std::string const& directory)
+{
+    return [directory](unsigned frame, unsigned width, unsigned height, unsigned char const* rgba) {
+        std::string const name = boost::str(
+            boost::format("%1%/frame_%2$06d_%3%x%4%.rgba") % directory % frame % width % height
+        );
+
+        std::ofstream out(name.c_str(), std::ios::binary);
+        out.write(reinterpret_cast<char const*>(rgba), static_cast<std::streamsize>(width) * height * 4);
+    };
+}
@@ -0,0 +1,98 @@
+#pragma once
+#ifndef VOX_RENDERER_FRAME_CAPTURE_HPP
+#define VOX_RENDERER_FRAME_CAPTURE_HPP
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <functional>
+#include <boost/utility.hpp>
+#include <boost/thread.hpp>
+
+#include "../gl/vgl.hpp"
+
+namespace vox {
+
+namespace util { class ThreadPool; }
+
+////////////////////////////////////////////////////////////////////////////////
+// Reads frames back without stalling the render thread.
+//
+// capture() reads the read framebuffer into one of a ring of pixel pack
+// buffers and puts a fence after it; glReadPixels into a buffer only queues
+// the copy. update() maps the buffers whose fence has passed, a frame or two
+// later, and hands the pixels to the sink on a worker; once the sink
+// returns, the next update() unmaps the buffer for reuse.
+//
+// A frame is dropped, not waited for, when every buffer is still busy.
+// All members but the sink run on the render thread. What the sink throws
+// is left to escape its job, for the pool's takeError().
+////////////////////////////////////////////////////////////////////////////////
+class FrameCapture : private boost::noncopyable {
+public:
+    //called on a worker with width x height RGBA8 pixels, rows bottom up,
+    //which are only valid until it returns
+    typedef std::function<void (unsigned frame, unsigned width, unsigned height, unsigned char const* rgba)> sink_t;
+
+    explicit FrameCapture(util::ThreadPool& pool, unsigned slots = 3);
+    //waits for the sink to finish with frames it has
+    ~FrameCapture();
+
+    //frames captured from now on go to sink; an empty sink stops capturing
+    void setSink(sink_t sink) { sink_ = std::move(sink); }
+    bool capturing() const { return static_cast<bool>(sink_); }
+
+    //queue a read of width x height pixels from (0, 0) of the read
+    //framebuffer; false if the frame was dropped
+    bool capture(unsigned frame, unsigned width, unsigned height);
+
+    //hand finished reads to the sink and free buffers the sink is done with
+    void update();
+    //give up on reads still waiting on their fence and delete the fences.
+    //The destructor can't report a failure to, so it leaves them to the
+    //context; call this first
+    void drop();
+
+    unsigned captured() const { return captured_; }
+    unsigned dropped()  const { return dropped_; }
+
+    //writes <directory>/frame_<frame>_<width>x<height>.rgba
+    static sink_t rawFileSink(std::string const& directory);
+private:
+    typedef gl::Buffer<gl::BUFFER_USAGE_STREAM_READ, gl::BUFFER_TARGET_PIXEL_PACK> buffer_t;
+
+    enum SlotState {
+        SLOT_FREE,
+        SLOT_READING,  //waiting on the fence
+        SLOT_SINKING,  //mapped and with the sink
+        SLOT_SUNK,     //still mapped
+    };
+
+    struct Slot {
+        buffer_t             buffer;
+        GLsync               fence;
+        unsigned char const* pixels;
+        SlotState            state;
+        unsigned             frame;
+        unsigned             width;
+        unsigned             height;
+        sink_t               sink;
+    };
+
+    //worker side of update
+    void deliver_(Slot& slot);
+
+    util::ThreadPool&                  pool_;
+    sink_t                             sink_;
+    std::vector<std::unique_ptr<Slot>> slots_;
+    std::deque<Slot*>                  reading_; //capture order
+    unsigned                           captured_;
+    unsigned                           dropped_;
+
+    boost::mutex              mutex_;
+    boost::condition_variable sunk_;
+};
+
+} //namespace vox
+
+#endif //VOX_RENDERER_FRAME_CAPTURE_HPP
@@ -0,0 +1,52 @@
+#pragma once
+#ifndef VOX_RENDERER_GL_COMMAND_EXECUTOR_HPP
+#define VOX_RENDERER_GL_COMMAND_EXECUTOR_HPP
+
+#include "../gl/vgl.hpp"
+
+namespace vox {
+
+////////////////////////////////////////////////////////////////////////////////
+// Replays a CommandBuffer into the GL context current on the calling thread.
+// Packet textures are bound to one unit and target; texture binds go through
+// the binding cache like every other.
+////////////////////////////////////////////////////////////////////////////////
+class GlCommandExecutor {
+public:
+    GlCommandExecutor(unsigned textureUnit, gl::TextureTarget textureTarget)
+        : unit_(textureUnit)
+        , target_(textureTarget)
+    {
+    }
+
+    void bindProgram(unsigned program) {
+        gl::detail::useProgram(gl::ProgramId(program));
+    }
+
+    void bindTexture(unsigned texture) {
+        gl::detail::bindTexture(unit_, target_, gl::TextureId(texture));
+    }
+
+    void bindVertexArray(unsigned array) {
+        gl::detail::bindVertexArray(gl::ArrayId(array));
+    }
+
+    void setUniform(int location, float const* matrix) {
+        gl::detail::setUniform<4, 4, GLfloat>(gl::UniformLocation(location), matrix);
+    }
+
+    void setUniform(int location, int value) {
+        gl::detail::setUniform<1, 1, GLint>(gl::UniformLocation(location), &value);
+    }
+
+    void drawArrays(unsigned mode, int first, int count) {
+        gl::detail::drawArrays(static_cast<gl::DrawMode>(mode), first, count);
+    }
+private:
+    unsigned          unit_;
+    gl::TextureTarget target_;
+};
+
+} //namespace vox
+
+#endif //VOX_RENDERER_GL_COMMAND_EXECUTOR_HPP
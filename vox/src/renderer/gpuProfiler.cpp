@@ -0,0 +1,154 @@
+#include "common.hpp"
+#include "gpuProfiler.hpp"
+
+#include <string>
+
+namespace {
+    //passes a frame has room for before it allocates
+    unsigned const PASSES_RESERVED = 16;
+
+    double elapsedMs(vox::gl::Query const& start, vox::gl::Query const& end) {
+        return static_cast<double>(end.result() - start.result()) / 1000000.0;
+    }
+} //namespace anon
+
+vox::GpuProfiler::GpuProfiler(util::Timings& timings, unsigned maxFrames)
+    : timings_(timings)
+    , frameTiming_(timings.id("gpu/frame"))
+    , frames_(maxFrames)
+    , first_(0)
+    , count_(0)
+    , active_(false)
+{
+    assert(maxFrames > 0);
+
+    for (auto it = frames_.begin(); it != frames_.end(); ++it) {
+        it->start = nullptr;
+        it->end   = nullptr;
+        it->passes.reserve(PASSES_RESERVED);
+    }
+
+    open_.reserve(PASSES_RESERVED);
+}
+
+void
+vox::GpuProfiler::beginFrame()
+{
+    assert(!active_);
+
+    if (count_ == frames_.size()) {
+        return;
+    }
+
+    gl::Query* const start = pool_.acquire();
+    start->timestamp();
+
+    ++count_;
+
+    Frame& frame = back_();
+    frame.start = start;
+    frame.end   = nullptr;
+    frame.passes.clear();
+
+    active_ = true;
+}
+
+void
+vox::GpuProfiler::endFrame()
+{
+    if (!active_) {
+        return;
+    }
+
+    assert(open_.empty() && "a pass wasn't ended");
+
+    Frame& frame = back_();
+    frame.end = pool_.acquire();
+    frame.end->timestamp();
+
+    active_ = false;
+}
+
+void
+vox::GpuProfiler::begin(char const* name)
+{
+    if (!active_) {
+        return;
+    }
+
+    Frame& frame = back_();
+
+    Pass const pass = { timing_(name), pool_.acquire(), nullptr };
+    pass.start->timestamp();
+
+    open_.push_back(static_cast<unsigned>(frame.passes.size()));
+    frame.passes.push_back(pass);
+}
+
+void
+vox::GpuProfiler::end()
+{
+    if (!active_) {
+        return;
+    }
+
+    assert(!open_.empty());
+
+    Pass& pass = back_().passes[open_.back()];
+    open_.pop_back();
+
+    pass.end = pool_.acquire();
+    pass.end->timestamp();
+}
+
+void
+vox::GpuProfiler::collect()
+{
+    while (count_ > 0) {
+        Frame& frame = frames_[first_];
+
+        //timestamps complete in order, so once the last is in they all are
+        if (!frame.end || !frame.end->isAvailable()) {
+            return;
+        }
+
+        for (auto it = frame.passes.begin(); it != frame.passes.end(); ++it) {
+            timings_.record(it->timing, elapsedMs(*it->start, *it->end));
+        }
+
+        timings_.record(frameTiming_, elapsedMs(*frame.start, *frame.end));
+
+        release_(frame);
+
+        first_ = (first_ + 1) % frames_.size();
+        --count_;
+    }
+}
+
+vox::util::Timings::id_t
+vox::GpuProfiler::timing_(char const* const name)
+{
+    for (auto it = names_.begin(); it != names_.end(); ++it) {
+        if (it->name == name) {
+            return it->timing;
+        }
+    }
+
+    //first time this literal is seen
+    Name const entry = { name, timings_.id(std::string("gpu/") + name) };
+    names_.push_back(entry);
+
+    return entry.timing;
+}
+
+void
+vox::GpuProfiler::release_(Frame& frame)
+{
+    for (auto it = frame.passes.begin(); it != frame.passes.end(); ++it) {
+        pool_.release(it->start);
+        pool_.release(it->end);
+    }
+
+    pool_.release(frame.start);
+    pool_.release(frame.end);
+}
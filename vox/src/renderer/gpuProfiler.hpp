@@ -0,0 +1,100 @@
+#pragma once
+#ifndef VOX_RENDERER_GPU_PROFILER_HPP
+#define VOX_RENDERER_GPU_PROFILER_HPP
+
+#include <vector>
+#include <boost/utility.hpp>
+#include <boost/preprocessor/cat.hpp>
+
+#include "../gl/vgl.hpp"
+#include "../util/timings.hpp"
+
+namespace vox {
+
+////////////////////////////////////////////////////////////////////////////////
+// GPU time of named passes, read back without stalling. Each pass is
+// bracketed by two timestamp queries, so passes may nest; a frame's results
+// are read a few frames later, once its last timestamp is available, and
+// recorded in the timings as "gpu/<name>" and "gpu/frame".
+//
+// If maxFrames frames are still waiting on the GPU, the next isn't profiled.
+// Frames are kept in a ring made up front and each pass name is turned into
+// its timings id once, so a frame doesn't allocate once the ring has warmed
+// up. Render thread only.
+////////////////////////////////////////////////////////////////////////////////
+class GpuProfiler : private boost::noncopyable {
+public:
+    ////////////////////////////////////////////////////////////////////////////
+    // Times the GPU work issued during its lifetime as a pass
+    ////////////////////////////////////////////////////////////////////////////
+    class Scope : private boost::noncopyable {
+    public:
+        //name must outlive the profiler's results; use a literal
+        Scope(GpuProfiler& profiler, char const* name)
+            : profiler_(profiler)
+        {
+            profiler_.begin(name);
+        }
+
+        ~Scope() {
+            profiler_.end();
+        }
+    private:
+        GpuProfiler& profiler_;
+    };
+
+    explicit GpuProfiler(util::Timings& timings, unsigned maxFrames = 4);
+
+    void beginFrame();
+    void endFrame();
+
+    //name must be a literal; passes end in the reverse order they begin
+    void begin(char const* name);
+    void end();
+
+    //record every frame the GPU has finished
+    void collect();
+
+    //queries made so far; stops growing once frames are read back steadily
+    unsigned queries() const { return pool_.size(); }
+private:
+    struct Pass {
+        util::Timings::id_t timing;
+        gl::Query*          start;
+        gl::Query*          end;
+    };
+
+    struct Frame {
+        gl::Query*        start;
+        gl::Query*        end;
+        std::vector<Pass> passes;
+    };
+
+    //names are literals, so almost always found by address
+    struct Name {
+        char const*         name;
+        util::Timings::id_t timing;
+    };
+
+    util::Timings::id_t timing_(char const* name);
+    Frame& back_() { return frames_[(first_ + count_ - 1) % frames_.size()]; }
+    void release_(Frame& frame);
+
+    util::Timings&        timings_;
+    util::Timings::id_t   frameTiming_; //"gpu/frame"
+    gl::QueryPool         pool_;
+    std::vector<Frame>    frames_;  //ring of maxFrames
+    unsigned              first_;   //oldest waiting frame
+    unsigned              count_;   //frames waiting; the last is open while active_
+    std::vector<unsigned> open_;    //passes begun and not yet ended
+    std::vector<Name>     names_;
+    bool                  active_;  //profiling the current frame
+};
+
+} //namespace vox
+
+//time the rest of the enclosing block on the GPU as pass NAME
+#define VOX_GPU_SCOPE(PROFILER, NAME) \
+    ::vox::GpuProfiler::Scope BOOST_PP_CAT(vox_gpu_scope_, __LINE__)(PROFILER, NAME)
+
+#endif //VOX_RENDERER_GPU_PROFILER_HPP
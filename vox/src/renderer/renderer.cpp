@@ -1,11 +1,47 @@
 #include "common.hpp"
 #include "renderer.hpp"
+#include "chunkRenderer.hpp"
+#include "blockAtlas.hpp"
+#include "textureStreamer.hpp"
+#include "gpuProfiler.hpp"
 
 #include "../gl/vgl.hpp"
 #include "../util/util.hpp"
+#include "../util/profiler.hpp"
+
+#include <boost/chrono.hpp>
 
 namespace vgl = ::vox::gl;
 
+namespace {
+    //width and height of each block texture
+    unsigned const BLOCK_TEXTURE_SIZE = 16;
+
+    //GPU time dynamic resolution aims to draw frames in; a little under
+    //16.7ms so a 60Hz frame has room for the upscale and the swap
+    float const FRAME_TIME_TARGET = 14.0f;
+
+    //dynamic resolution never draws below this many lines, nor at less
+    //than MIN_RENDER_SCALE of the window
+    unsigned const MIN_RENDER_HEIGHT = 360;
+    float const    MIN_RENDER_SCALE  = 0.25f;
+
+    //most bytes of streamed textures sent to the GPU each frame
+    unsigned const TEXTURE_UPLOAD_BUDGET = 2 * 1024 * 1024;
+
+    //frame stats are logged about every 10 seconds at 60Hz
+    unsigned const FRAME_STATS_LOG_INTERVAL = 600;
+
+    //the linked shader program, to skip compiling it on the next run
+    wchar_t const PROGRAM_CACHE_FILE[] = L"./data/shader.bin";
+
+    typedef boost::chrono::steady_clock steady_clock;
+
+    double msBetween(steady_clock::time_point const start, steady_clock::time_point const end) {
+        return boost::chrono::duration<double, boost::milli>(end - start).count();
+    }
+} //namespace anon
+
 Eigen::Matrix4f
 perspectiveMatrix(
 	GLfloat left,	GLfloat right,
@@ -254,15 +290,32 @@ vox::RenderTask::start() {
 void
 vox::RenderTask::stop() {
     boost::unique_lock<boost::mutex> lock(mutex_);
-        
-    state_ = STATE_STOPPING;
-    stateCondition_.notify_all();
 
-    while (state_ != STATE_STOPPED) {
-        stateCondition_.wait(lock);
+    //already stopped if the render thread failed
+    if (state_ != STATE_STOPPED) {
+        state_ = STATE_STOPPING;
+        stateCondition_.notify_all();
+
+        while (state_ != STATE_STOPPED) {
+            stateCondition_.wait(lock);
+        }
     }
 
-    thread_->join();
+    //stopping again, or before a start, does nothing
+    if (thread_) {
+        thread_->join();
+        thread_.reset();
+    }
+}
+
+boost::exception_ptr
+vox::RenderTask::takeError() {
+    boost::lock_guard<boost::mutex> lock(mutex_);
+
+    boost::exception_ptr result;
+    std::swap(result, error_);
+
+    return result;
 }
     
 void
@@ -270,11 +323,31 @@ vox::RenderTask::state()
 {
 }
 
-vox::RenderTask::RenderTask(std::shared_ptr<RenderWindow> window)
+vox::RenderTask::RenderTask(std::shared_ptr<RenderWindow> window, util::ThreadPool& pool)
     : window_(window)
+    , pool_(pool)
     , glProgram_()
+    , blockAtlas_()
+    , textureStreamer_()
+    , chunkRenderer_()
+    , frameCapture_()
+    , target_()
+    , snapshots_(nullptr)
+    , viewportWidth_(0)
+    , viewportHeight_(0)
+    , renderScale_(1.0f)
+    , headless_(false)
+    , statsLogInterval_(FRAME_STATS_LOG_INTERVAL)
+    , scaler_(FRAME_TIME_TARGET)
+    , dynamicResolution_(true)
+    , frame_(0)
     , state_(STATE_STOPPED)
     , thread_()
+{
+    matMv_.setIdentity();
+}
+
+vox::RenderTask::~RenderTask()
 {
 }
 
@@ -282,34 +355,105 @@ void
 vox::RenderTask::setViewport_(unsigned width, unsigned height) {
     GLfloat const aspect = static_cast<GLfloat>(width) / static_cast<GLfloat>(height);
 
-    ::glViewport(0, 0, width, height);
+    viewportWidth_  = width;
+    viewportHeight_ = height;
+
+    //small windows aren't scaled down as far
+    float const minScale = std::min(1.0f, std::max(
+        MIN_RENDER_SCALE, static_cast<float>(MIN_RENDER_HEIGHT) / static_cast<float>(std::max(height, 1u))
+    ));
+    scaler_.setBounds(minScale, 1.0f);
+
+    if (dynamicResolution_) {
+        renderScale_ = scaler_.scale();
+    }
+
+    resizeTarget_();
 
     projOrtho_ = orthoMatrix(0, width, 0, height, -10.0, 10.0);
     projPersp_ = perspectiveMatrix(-1.0*aspect, 1.0*aspect, -1.0, 1.0, 1.0, 1000.0);
 }
 
 void
-vox::RenderTask::initProgram_()
+vox::RenderTask::resizeTarget_()
+{
+    if (!target_ || viewportWidth_ == 0 || viewportHeight_ == 0) {
+        return;
+    }
+
+    unsigned const width  = static_cast<unsigned>(viewportWidth_  * renderScale_ + 0.5f);
+    unsigned const height = static_cast<unsigned>(viewportHeight_ * renderScale_ + 0.5f);
+
+    target_->resize(std::max(width, 1u), std::max(height, 1u));
+}
+
+void
+vox::RenderTask::setDynamicResolution_(float targetMs)
+{
+    dynamicResolution_ = targetMs > 0.0f;
+
+    if (dynamicResolution_) {
+        scaler_.setTarget(targetMs);
+        renderScale_ = scaler_.scale();
+        resizeTarget_();
+    }
+}
+
+void
+vox::RenderTask::updateScale_()
+{
+    float ms = 0.0f;
+    while (frameTimer_->poll(ms)) {
+        if (!dynamicResolution_) {
+            continue;
+        }
+
+        float const scale = scaler_.update(ms);
+        if (scale != renderScale_) {
+            renderScale_ = scale;
+            resizeTarget_();
+        }
+    }
+}
+
+void
+vox::RenderTask::submitChunkMesh_(
+    world::ChunkMesh const&       mesh,
+    std::function<void ()> const& onVisible
+) {
+    chunkRenderer_->upload(mesh);
+
+    if (onVisible) {
+        onVisible();
+    }
+}
+
+void
+vox::RenderTask::removeChunkMesh_(world::ChunkPos pos) {
+    chunkRenderer_->remove(pos);
+}
+
+bool
+vox::RenderTask::startProgram_()
 {
     glProgram_.reset(
         new gl::Program()
     );
-    
+
+    gl::enableParallelShaderCompile();
+
+    std::vector<gl::ShaderSource> sources;
+    sources.push_back(gl::loadShaderSource(L"./data/shader.frag", gl::SHADER_TYPE_FRAGMENT));
+    sources.push_back(gl::loadShaderSource(L"./data/shader.vert", gl::SHADER_TYPE_VERTEX));
+
+    return glProgram_->linkAsync(sources, PROGRAM_CACHE_FILE);
+}
+
+void
+vox::RenderTask::initProgram_()
+{
     gl::Program& program = *glProgram_;
-    
-    program.attachShader(
-        std::shared_ptr<gl::Shader>(
-            new gl::Shader(L"./data/shader.frag", gl::SHADER_TYPE_FRAGMENT)
-        )
-    );
-    
-    program.attachShader(
-        std::shared_ptr<gl::Shader>(
-            new gl::Shader(L"./data/shader.vert", gl::SHADER_TYPE_VERTEX)
-        )
-    );
 
-    program.link();
     program.use();
 
     projMatrix_ = program.variable<gl::uniform::mat4f>("mProjection");
@@ -326,6 +470,8 @@ vox::RenderTask::initProgram_()
 
 void
 vox::RenderTask::main_() {
+    VOX_PROFILE_THREAD("render");
+
     //Set the state to STARTED
     {//lock
         boost::lock_guard<boost::mutex> lock(mutex_);
@@ -334,19 +480,87 @@ vox::RenderTask::main_() {
         stateCondition_.notify_all();
     }//unlock
 
-    auto context = window_->acquireGl();
-    
-    //This thread needs to be the one to clean up opengl -- do it after main_() ends
-    util::on_scope_exit exit_f([this]() -> void {
+    try {
+        auto context = window_->acquireGl();
+
+        //This thread needs to be the one to clean up opengl -- do it after run_() ends
+        util::on_scope_exit exit_f([this]() -> void {
+            boost::lock_guard<boost::mutex> lock(mutex_);
+
+            releaseGl_();
+            handles_.reset();
+        });
+
+        run_();
+
+        //on a normal exit release everything here, where a failure can still
+        //be reported
+        frameCapture_->drop();
+        releaseGl_();
+        handles_->clear();
+    } catch (...) {
         boost::lock_guard<boost::mutex> lock(mutex_);
-            
-        glProgram_.release();
+        error_ = boost::current_exception();
+    }
+
+    {//lock
+        boost::lock_guard<boost::mutex> lock(mutex_);
+
         state_ = STATE_STOPPED;
         stateCondition_.notify_all();
-    });
-        
-    //Setup opengl shaders, variables, etc
-    initProgram_();
+    }//unlock
+}
+
+void
+vox::RenderTask::releaseGl_() {
+    frameCapture_.reset();
+    frameTimer_.reset();
+    gpuProfiler_.reset();
+    target_.reset();
+    chunkRenderer_.reset();
+    textureStreamer_.reset();
+    blockAtlas_.reset();
+    glProgram_.release();
+}
+
+void
+vox::RenderTask::run_() {
+    //names are made in batches and deleted once a frame
+    handles_.reset(new gl::HandlePools());
+    gl::HandlePools::makeCurrent(handles_.get());
+
+    //the shaders compile while everything that doesn't need them is set up
+    steady_clock::time_point const programStart = steady_clock::now();
+    bool const programCached = startProgram_();
+
+    //block textures start as placeholders and stream in over the first frames
+    textureStreamer_.reset(new TextureStreamer(pool_));
+    blockAtlas_.reset(new BlockAtlas(world::BlockTextures::standard(), BLOCK_TEXTURE_SIZE));
+    blockAtlas_->stream(*textureStreamer_, BlockAtlas::rawFileLoader("./data/blocks"));
+    frameCapture_.reset(new FrameCapture(pool_));
+
+    //sized properly by the first setViewport
+    target_.reset(new gl::RenderTarget(1, 1));
+    frameTimer_.reset(new gl::FrameTimer());
+    gpuProfiler_.reset(new GpuProfiler(timings_));
+    resizeTarget_();
+
+    {
+        bool const programReady = glProgram_->ready();
+        steady_clock::time_point const waitStart = steady_clock::now();
+
+        //Setup opengl shaders, variables, etc; waits for the program if need be
+        initProgram_();
+
+        steady_clock::time_point const programEnd = steady_clock::now();
+
+        std::cout << "shader program " << (programCached ? "loaded from cache" : "compiled")
+                  << " in " << msBetween(programStart, programEnd) << "ms, "
+                  << msBetween(waitStart, programEnd) << "ms of it waited for"
+                  << (programReady ? " (ready before use)" : "") << "\n" << std::flush;
+    }
+
+    chunkRenderer_.reset(new ChunkRenderer(*glProgram_, *blockAtlas_, pool_));
 
     Scene testScene;
     testScene.prepareScene(*glProgram_);
@@ -355,33 +569,138 @@ vox::RenderTask::main_() {
     Cube cube;
     cube.bufferData(*glProgram_);
 
+    steady_clock::time_point lastStart;
+
     while (state_ == STATE_STARTED) {
-        while (!tasks_.isEmpty()) {
-            tasks_.dequeue()();
+        {
+            VOX_PROFILE_SCOPE("render/pace");
+            pacer_.beginFrame();
         }
-        
-        ::glClear( GL_COLOR_BUFFER_BIT   |
-                   GL_DEPTH_BUFFER_BIT   |
-                   GL_STENCIL_BUFFER_BIT
-        );
 
-       
- 	    mvMatrix_.set(
-		    Eigen::Affine3f(Eigen::Translation3f(1.0, 1.0, -5.0)).matrix()
-	    );
+        VOX_PROFILE_SCOPE("render/frame");
+
+        steady_clock::time_point const start = steady_clock::now();
+        util::FrameStats::Sample stats = {};
+
+        util::LinearArena& frame = frameArena_.beginFrame();
+
+        {
+            VOX_PROFILE_SCOPE("render/drain");
+
+            while (!tasks_.isEmpty()) {
+                tasks_.dequeue()();
+            }
+        }
+
+        stats.times[util::FrameStats::SERIES_DRAIN] = msBetween(start, steady_clock::now());
+
+        if (snapshots_) {
+            snapshots_->acquire();
 
-        projMatrix_.set(projPersp_);      
-        cube.draw();
+            world::RenderSnapshot const& snapshot = snapshots_->front();
+            if (snapshot.tick > 0) {
+                matMv_ = snapshot.view(start);
+            }
+        }
+
+        {
+            VOX_PROFILE_SCOPE("render/stream");
+            textureStreamer_->update(TEXTURE_UPLOAD_BUDGET);
+        }
+
+        target_->bind();
+        ::glViewport(0, 0, target_->width(), target_->height());
+
+        frameTimer_->begin();
+        gpuProfiler_->beginFrame();
+
+        {
+            VOX_GPU_SCOPE(*gpuProfiler_, "clear");
+
+            ::glClear( GL_COLOR_BUFFER_BIT   |
+                       GL_DEPTH_BUFFER_BIT   |
+                       GL_STENCIL_BUFFER_BIT
+            );
+        }
+
+        {
+            VOX_GPU_SCOPE(*gpuProfiler_, "cube");
+
+ 	        mvMatrix_.set(
+		        Eigen::Affine3f(Eigen::Translation3f(1.0, 1.0, -5.0)).matrix()
+	        );
+
+            projMatrix_.set(projPersp_);
+            cube.draw();
+        }
+
+        {
+            VOX_PROFILE_SCOPE("render/chunks");
+            VOX_GPU_SCOPE(*gpuProfiler_, "chunks");
+            chunkRenderer_->draw(mvMatrix_, projPersp_, matMv_, frame);
+        }
+
+        {
+            VOX_GPU_SCOPE(*gpuProfiler_, "ortho");
+
+ 	        mvMatrix_.set(
+		        (Eigen::Translation3f(10.0f, 10.0f, 0.0f)*
+                 Eigen::Scaling(100.0f, 100.0f, 1.0f)).matrix()
+	        );
+
+            projMatrix_.set(projOrtho_);
+            testScene.drawScene();
+        }
+
+        frameTimer_->end();
+
+        //read back the frame as drawn, before it's scaled to the window
+        if (frameCapture_->capturing()) {
+            frameCapture_->capture(frame_, target_->width(), target_->height());
+        }
 
- 	    mvMatrix_.set(
-		    (Eigen::Translation3f(10.0f, 10.0f, 0.0f)*
-             Eigen::Scaling(100.0f, 100.0f, 1.0f)).matrix()
-	    );
+        if (!headless_ && viewportWidth_ > 0 && viewportHeight_ > 0) {
+            VOX_PROFILE_SCOPE("render/present");
+            VOX_GPU_SCOPE(*gpuProfiler_, "present");
+
+            steady_clock::time_point const swapStart = steady_clock::now();
+
+            target_->present(viewportWidth_, viewportHeight_);
+            window_->swap();
+
+            stats.times[util::FrameStats::SERIES_SWAP] = msBetween(swapStart, steady_clock::now());
+        }
 
-        projMatrix_.set(projOrtho_);
-        testScene.drawScene();
+        gpuProfiler_->endFrame();
 
-        window_->swap();
+        ++frame_;
+
+        updateScale_();
+        gpuProfiler_->collect();
+        frameCapture_->update();
+        handles_->flush();
+
+        //the first frame has no interval
+        if (frame_ > 1) {
+            stats.times[util::FrameStats::SERIES_INTERVAL] = msBetween(lastStart, start);
+            stats.times[util::FrameStats::SERIES_CPU] =
+                msBetween(start, steady_clock::now()) - stats.times[util::FrameStats::SERIES_SWAP];
+
+            frameStats_.record(stats);
+        }
+
+        lastStart = start;
+
+        pacer_.endFrame();
+
+        if (statsLogInterval_ > 0 && frame_ % statsLogInterval_ == 0) {
+            ChunkRenderer::DrawStats const& draws = chunkRenderer_->stats();
+
+            std::cout << frameStats_.report()
+                      << "chunks: " << draws.draws << " draws, "
+                      << draws.unsortedStateChanges << " state changes as recorded, "
+                      << draws.stateChanges << " sorted\n" << std::flush;
+        }
     }
 }
 
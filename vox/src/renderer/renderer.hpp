@@ -4,13 +4,31 @@
 
 #include <boost/utility.hpp>
 #include <boost/thread.hpp>
+#include <boost/exception_ptr.hpp>
 
 #include "../system/window/NativeWindow.hpp"
 #include "../util/blockingQueue.hpp"
+#include "../util/frameArena.hpp"
+#include "../util/resolutionScaler.hpp"
+#include "../util/timings.hpp"
+#include "../util/frameStats.hpp"
+#include "../util/framePacer.hpp"
+#include "../util/profiler.hpp"
 #include "../gl/vgl.hpp"
+#include "../gl/handlePool.hpp"
+#include "../world/chunkMesher.hpp"
+#include "../world/simulation.hpp"
+#include "frameCapture.hpp"
 
 namespace vox {
 
+class ChunkRenderer;
+class BlockAtlas;
+class TextureStreamer;
+class GpuProfiler;
+
+namespace util { class ThreadPool; }
+
 class RenderWindow : private boost::noncopyable {
 public:
     RenderWindow(unsigned width, unsigned height)
@@ -21,7 +39,10 @@ public:
     void close();
     void resize(unsigned width, unsigned height);
 
-    void doEvents() { window_.doEventsWait(); }
+    void doEvents() {
+        VOX_PROFILE_SCOPE("window/events");
+        window_.doEventsWait();
+    }
 
     bool isClosed() { return false; //TODO
     }
@@ -30,6 +51,11 @@ public:
         window_.swap();
     }
 
+    //render thread only; see NativeWindow::setSwapInterval
+    bool setSwapInterval(int interval) {
+        return window_.setSwapInterval(interval);
+    }
+
     vox::system::OpenGlContext acquireGl() {
         return window_.acquireGl();
     }
@@ -58,25 +84,157 @@ public:
     };
 
     void start();
+    //may be called more than once
     void stop();  
+    //what stopped the render thread, if it failed; empty otherwise. The
+    //thread stops on its own when it fails; stop() still has to be called
+    boost::exception_ptr takeError();
     void state();
 public:
-    explicit RenderTask(std::shared_ptr<RenderWindow> window);
+    //pool decodes streamed textures and must outlive the task
+    RenderTask(std::shared_ptr<RenderWindow> window, util::ThreadPool& pool);
+
+    ~RenderTask();
 
     void setViewport(unsigned width, unsigned height) {
         tasks_.enqueue(
             [this, width, height] { setViewport_(width, height); }
         );
     }
+
+    //draw at scale times the window's size and stretch the frame to fit
+    //the window; 1 draws at the window's size. Turns dynamic resolution off
+    void setRenderScale(float scale) {
+        tasks_.enqueue(
+            [this, scale] { dynamicResolution_ = false; renderScale_ = scale; resizeTarget_(); }
+        );
+    }
+
+    //pick the render scale each frame to keep the GPU time of drawing the
+    //frame under targetMs; 0 turns it off and leaves the scale where it is
+    void setDynamicResolution(float targetMs) {
+        tasks_.enqueue(
+            [this, targetMs] { setDynamicResolution_(targetMs); }
+        );
+    }
+
+    //draw offscreen only: frames aren't shown in the window or swapped,
+    //but are still captured. Set the size to draw at with setViewport
+    void setHeadless(bool headless) {
+        tasks_.enqueue(
+            [this, headless] { headless_ = headless; }
+        );
+    }
+
+    //start frames at most hz times a second; 0 doesn't limit the rate.
+    //Frames wait in the pacer rather than spinning on swap
+    void setFrameRateLimit(float hz) {
+        tasks_.enqueue(
+            [this, hz] { pacer_.setTarget(hz); }
+        );
+    }
+
+    //start each frame as late as it can be and still be done in time, so
+    //it's drawn from fresher input; needs a frame rate limit
+    void setLowLatency(bool lowLatency) {
+        tasks_.enqueue(
+            [this, lowLatency] { pacer_.setLowLatency(lowLatency); }
+        );
+    }
+
+    //see NativeWindow::setSwapInterval
+    void setSwapInterval(int interval) {
+        tasks_.enqueue(
+            [this, interval] { window_->setSwapInterval(interval); }
+        );
+    }
+
+    //how long the GPU took over each pass; may be read from any thread
+    util::Timings const& timings() const { return timings_; }
+
+    //CPU times of recent frames; may be read from any thread
+    util::FrameStats const& frameStats() const { return frameStats_; }
+
+    //write frameStats().report() and the last frame's chunk state changes to
+    //stdout every frames frames; 0 never does
+    void setStatsLogInterval(unsigned frames) {
+        tasks_.enqueue(
+            [this, frames] { statsLogInterval_ = frames; }
+        );
+    }
+
+    //ignored while the view comes from snapshots
+    void setView(Eigen::Matrix4f const& view) {
+        tasks_.enqueue(
+            [this, view] { matMv_ = view; }
+        );
+    }
+
+    //take the view from the newest simulation tick each frame, blended
+    //between ticks; the render thread becomes the mailbox's only reader.
+    //nullptr goes back to setView
+    void setSnapshots(world::Simulation::mailbox_t* snapshots) {
+        tasks_.enqueue(
+            [this, snapshots] { snapshots_ = snapshots; }
+        );
+    }
+
+    //upload mesh on the render thread; onVisible is called there once it
+    //will be drawn
+    void submitChunkMesh(
+        std::shared_ptr<world::ChunkMesh const> mesh,
+        std::function<void ()>                  onVisible
+    ) {
+        tasks_.enqueue(
+            [this, mesh, onVisible] { submitChunkMesh_(*mesh, onVisible); }
+        );
+    }
+
+    void removeChunkMesh(world::ChunkPos pos) {
+        tasks_.enqueue(
+            [this, pos] { removeChunkMesh_(pos); }
+        );
+    }
+
+    //hand every frame drawn from now on to sink on a worker thread; frames
+    //are dropped rather than waited for; an empty sink stops capturing
+    void setFrameSink(FrameCapture::sink_t sink) {
+        tasks_.enqueue(
+            [this, sink] { frameCapture_->setSink(sink); }
+        );
+    }
 private:
     void setViewport_(unsigned width, unsigned height);
+    //size the render target to the viewport times the render scale
+    void resizeTarget_();
+    void setDynamicResolution_(float targetMs);
+    //feed finished frame times to the scaler
+    void updateScale_();
+    void submitChunkMesh_(world::ChunkMesh const& mesh, std::function<void ()> const& onVisible);
+    void removeChunkMesh_(world::ChunkPos pos);
 
+    //runs run_() with the context current and keeps what it throws
     void main_();
+    void run_();
+    //destroy everything holding GL objects, except the handle pools
+    void releaseGl_();
+    //issue the program's compile and link; true if it was cached
+    bool startProgram_();
+    //wait for the program, then use it and find its variables
     void initProgram_();
 
     std::shared_ptr<RenderWindow> window_;
+    util::ThreadPool&             pool_;
     
-    std::unique_ptr<gl::Program>  glProgram_;
+    std::unique_ptr<gl::HandlePools> handles_; //current on the render thread while it runs
+    std::unique_ptr<gl::Program>     glProgram_;
+    std::unique_ptr<BlockAtlas>      blockAtlas_;
+    std::unique_ptr<TextureStreamer> textureStreamer_;
+    std::unique_ptr<ChunkRenderer>   chunkRenderer_;
+    std::unique_ptr<FrameCapture>    frameCapture_;
+    std::unique_ptr<gl::RenderTarget> target_; //every frame is drawn here first
+    std::unique_ptr<gl::FrameTimer>   frameTimer_; //GPU time of drawing into target_
+    std::unique_ptr<GpuProfiler>      gpuProfiler_;
 
     gl::uniform::mat4f projMatrix_;
     gl::uniform::mat4f mvMatrix_;
@@ -87,7 +245,26 @@ private:
     Eigen::Matrix4f matProj_;
     Eigen::Matrix4f matMv_;
 
+    world::Simulation::mailbox_t* snapshots_; //where the view comes from, if set
+
+    unsigned viewportWidth_;
+    unsigned viewportHeight_;
+    float    renderScale_;
+    bool     headless_;
+
+    util::Timings          timings_;
+    util::FrameStats       frameStats_;
+    util::FramePacer       pacer_;
+    unsigned               statsLogInterval_; //frames between reports; 0 for none
+    util::ResolutionScaler scaler_;
+    bool                   dynamicResolution_;
+    unsigned frame_; //frames drawn
+
+    //transient per frame data; one arena per frame the driver may queue
+    util::FrameArena frameArena_;
+
     State                          state_;
+    boost::exception_ptr           error_; //from the render thread
     std::unique_ptr<boost::thread> thread_;
     boost::mutex                   mutex_;
     boost::condition_variable      stateCondition_;
@@ -0,0 +1,353 @@
+#include "common.hpp"
+#include <boost/test/unit_test.hpp>
+#include <boost/chrono.hpp>
+#include <Eigen/Geometry>
+
+#include "../commandBuffer.hpp"
+#include "../../util/threadPool.hpp"
+
+namespace {
+    typedef boost::chrono::steady_clock steady_clock;
+
+    double msSince(steady_clock::time_point const start) {
+        return boost::chrono::duration<double, boost::milli>(steady_clock::now() - start).count();
+    }
+
+    unsigned const GL_TRIANGLES_MODE = 4;
+
+    //remembers everything replayed, in order
+    struct RecordingExecutor : vox::NullCommandExecutor {
+        void bindProgram(unsigned program) {
+            vox::NullCommandExecutor::bindProgram(program);
+            program_ = program;
+        }
+
+        void setUniform(int location, float const* matrix) {
+            vox::NullCommandExecutor::setUniform(location, matrix);
+            lastMatrix.assign(matrix, matrix + 16);
+        }
+
+        void setUniform(int location, int value) {
+            vox::NullCommandExecutor::setUniform(location, value);
+            lastInt = value;
+        }
+
+        void drawArrays(unsigned mode, int first, int count) {
+            vox::NullCommandExecutor::drawArrays(mode, first, count);
+            drawn.push_back(std::make_pair(program_, first));
+        }
+
+        unsigned                                 program_;
+        std::vector<float>                       lastMatrix;
+        int                                      lastInt;
+        std::vector<std::pair<unsigned, int> >   drawn; //program, first
+    };
+
+    //keeps the matrices from being optimized away in the benchmark
+    struct SummingExecutor : vox::NullCommandExecutor {
+        using vox::NullCommandExecutor::setUniform;
+
+        SummingExecutor() : sum(0.0f) {}
+
+        void setUniform(int location, float const* matrix) {
+            vox::NullCommandExecutor::setUniform(location, matrix);
+            sum += matrix[12] + matrix[14];
+        }
+
+        float sum;
+    };
+
+    //what drawing chunk i takes; the same whichever way it's issued
+    Eigen::Matrix4f chunkMatrix(Eigen::Matrix4f const& view, unsigned i) {
+        Eigen::Affine3f const offset(Eigen::Translation3f(
+            static_cast<float>((i % 100) * 16), 0.0f, static_cast<float>((i / 100) * 16)
+        ));
+
+        return view * offset.matrix();
+    }
+
+    //distances shuffled so the sort has to order them
+    float chunkDepth(unsigned i) {
+        return static_cast<float>((i * 7919) % 10007) * 0.1f;
+    }
+
+    vox::DrawState chunkState(unsigned i) {
+        //a few programs and textures, interleaved as badly as possible
+        vox::DrawState const state = { 1 + i % 3, 10 + i % 2, 7 };
+        return state;
+    }
+} //namespace anon
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(CommandBufferReplay)
+{
+    vox::CommandBuffer buffer;
+
+    vox::DrawState const a = { 1, 5, 9 };
+    vox::DrawState const b = { 2, 5, 9 };
+
+    float matrix[16] = {0};
+    matrix[0] = matrix[5] = matrix[10] = matrix[15] = 1.0f;
+    matrix[12] = 3.5f;
+
+    buffer.begin(a);
+    buffer.setUniform(0, matrix);
+    buffer.drawArrays(GL_TRIANGLES_MODE, 0, 36);
+
+    buffer.begin(b);
+    buffer.setUniform(2, 7);
+    buffer.drawArrays(GL_TRIANGLES_MODE, 36, 6);
+
+    buffer.begin(a);
+    buffer.drawArrays(GL_TRIANGLES_MODE, 42, 6);
+
+    BOOST_CHECK_EQUAL(buffer.packets(), 3u);
+
+    //as recorded: a, b, a changes the program twice
+    RecordingExecutor recorded;
+    buffer.replay(recorded);
+
+    BOOST_CHECK_EQUAL(recorded.draws, 3u);
+    BOOST_CHECK_EQUAL(recorded.vertices, 48u);
+    BOOST_CHECK_EQUAL(recorded.stateChanges, 3u + 2u);
+    BOOST_REQUIRE_EQUAL(recorded.lastMatrix.size(), 16u);
+    BOOST_CHECK_EQUAL(recorded.lastMatrix[12], 3.5f);
+    BOOST_CHECK_EQUAL(recorded.lastInt, 7);
+
+    //sorted: both a packets first, still in the order they were recorded
+    buffer.sort();
+
+    RecordingExecutor sorted;
+    buffer.replay(sorted);
+
+    BOOST_CHECK_EQUAL(sorted.stateChanges, 3u + 1u);
+    BOOST_REQUIRE_EQUAL(sorted.drawn.size(), 3u);
+    BOOST_CHECK_EQUAL(sorted.drawn[0].second, 0);
+    BOOST_CHECK_EQUAL(sorted.drawn[1].second, 42);
+    BOOST_CHECK_EQUAL(sorted.drawn[2].second, 36);
+    BOOST_CHECK_EQUAL(sorted.drawn[2].first, 2u);
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(CommandBufferSortKey)
+{
+    vox::CommandBuffer buffer;
+
+    vox::DrawState const a = { 1, 5, 9 };
+    vox::DrawState const b = { 2, 5, 9 };
+
+    //first is the draw's index, recorded in no useful order
+    buffer.begin(b, 1.0f);
+    buffer.drawArrays(GL_TRIANGLES_MODE, 0, 3);
+    buffer.begin(a, 0.0f, vox::PASS_TRANSLUCENT);
+    buffer.drawArrays(GL_TRIANGLES_MODE, 1, 3);
+    buffer.begin(a, 300.0f);
+    buffer.drawArrays(GL_TRIANGLES_MODE, 2, 3);
+    buffer.begin(a, 50.0f, vox::PASS_TRANSLUCENT);
+    buffer.drawArrays(GL_TRIANGLES_MODE, 3, 3);
+    buffer.begin(a, 2.5f);
+    buffer.drawArrays(GL_TRIANGLES_MODE, 4, 3);
+    buffer.begin(a, -1.0f); //behind the camera: the nearest bucket
+    buffer.drawArrays(GL_TRIANGLES_MODE, 5, 3);
+
+    //as recorded: b, then every a
+    BOOST_CHECK_EQUAL(buffer.stateChanges(), 3u + 1u);
+
+    buffer.sort();
+
+    //passes come before state, so a is bound again after b
+    BOOST_CHECK_EQUAL(buffer.stateChanges(), 3u + 1u + 1u);
+
+    RecordingExecutor executor;
+    buffer.replay(executor);
+
+    BOOST_CHECK_EQUAL(executor.stateChanges, buffer.stateChanges());
+
+    //opaque a front to back, then b, then translucent a back to front
+    int const expected[] = { 5, 4, 2, 0, 3, 1 };
+
+    BOOST_REQUIRE_EQUAL(executor.drawn.size(), 6u);
+    for (unsigned i = 0; i < 6; ++i) {
+        BOOST_CHECK_EQUAL(executor.drawn[i].second, expected[i]);
+    }
+
+    //depth buckets follow depth
+    BOOST_CHECK_LT(vox::CommandBuffer::depthBucket(0.5f, vox::PASS_OPAQUE),
+                   vox::CommandBuffer::depthBucket(0.6f, vox::PASS_OPAQUE));
+    BOOST_CHECK_LT(vox::CommandBuffer::depthBucket(1000.0f, vox::PASS_OPAQUE),
+                   vox::CommandBuffer::depthBucket(1001.0f, vox::PASS_OPAQUE));
+    BOOST_CHECK_GT(vox::CommandBuffer::depthBucket(0.5f, vox::PASS_TRANSLUCENT),
+                   vox::CommandBuffer::depthBucket(0.6f, vox::PASS_TRANSLUCENT));
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(CommandBufferSortLargeNames)
+{
+    vox::CommandBuffer buffer;
+
+    //the same in their low 12 bits
+    vox::DrawState const a = { 1,        5, 9 };
+    vox::DrawState const b = { 1 + 4096, 5, 9 };
+
+    for (unsigned i = 0; i < 8; ++i) {
+        buffer.begin(i % 2 ? b : a, static_cast<float>(i));
+        buffer.drawArrays(GL_TRIANGLES_MODE, static_cast<int>(i), 3);
+    }
+
+    buffer.sort();
+
+    //every a, then every b: one program change between them
+    BOOST_CHECK_EQUAL(buffer.stateChanges(), 3u + 1u);
+
+    //sorting again gives the same order
+    buffer.sort();
+    BOOST_CHECK_EQUAL(buffer.stateChanges(), 3u + 1u);
+
+    RecordingExecutor executor;
+    buffer.replay(executor);
+
+    int const expected[] = { 0, 2, 4, 6, 1, 3, 5, 7 };
+
+    BOOST_REQUIRE_EQUAL(executor.drawn.size(), 8u);
+    for (unsigned i = 0; i < 8; ++i) {
+        BOOST_CHECK_EQUAL(executor.drawn[i].second, expected[i]);
+    }
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(CommandBufferAppend)
+{
+    vox::CommandBuffer first;
+    vox::CommandBuffer second;
+
+    vox::DrawState const a = { 1, 0, 0 };
+
+    first.begin(a);
+    first.drawArrays(GL_TRIANGLES_MODE, 0, 3);
+
+    second.begin(a);
+    second.setUniform(1, 4);
+    second.drawArrays(GL_TRIANGLES_MODE, 3, 3);
+
+    vox::CommandBuffer merged;
+    merged.append(first);
+    merged.append(second);
+
+    BOOST_CHECK_EQUAL(merged.packets(), 2u);
+    BOOST_CHECK_EQUAL(merged.bytes(), first.bytes() + second.bytes());
+
+    RecordingExecutor executor;
+    merged.replay(executor);
+
+    BOOST_REQUIRE_EQUAL(executor.drawn.size(), 2u);
+    BOOST_CHECK_EQUAL(executor.drawn[0].second, 0);
+    BOOST_CHECK_EQUAL(executor.drawn[1].second, 3);
+    BOOST_CHECK_EQUAL(executor.lastInt, 4);
+    BOOST_CHECK_EQUAL(executor.stateChanges, 3u);
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(CommandBufferBenchmark)
+{
+    unsigned const DRAWS   = 10000;
+    unsigned const THREADS = 4;
+    unsigned const GRAIN   = DRAWS / THREADS;
+    unsigned const RUNS    = 20;
+
+    vox::util::ThreadPool pool(THREADS);
+
+    Eigen::Matrix4f const view =
+        Eigen::Affine3f(Eigen::Translation3f(-100.0f, -80.0f, -100.0f)).matrix();
+
+    //issued straight to the executor, as the render thread does now
+    SummingExecutor direct;
+    auto const directStart = steady_clock::now();
+
+    for (unsigned run = 0; run < RUNS; ++run) {
+        vox::DrawState current = { 0, 0, 0 };
+
+        for (unsigned i = 0; i < DRAWS; ++i) {
+            vox::DrawState const state = chunkState(i);
+
+            if (state.program != current.program) {
+                direct.bindProgram(state.program);
+            }
+            if (state.texture != current.texture) {
+                direct.bindTexture(state.texture);
+            }
+            if (state.vertexArray != current.vertexArray) {
+                direct.bindVertexArray(state.vertexArray);
+            }
+            current = state;
+
+            direct.setUniform(0, chunkMatrix(view, i).data());
+            direct.drawArrays(GL_TRIANGLES_MODE, i * 36, 36);
+        }
+    }
+
+    double const directMs = msSince(directStart) / RUNS;
+
+    //recorded in parallel, merged, sorted and replayed
+    std::vector<vox::CommandBuffer> recorders(THREADS);
+    vox::CommandBuffer              merged;
+    SummingExecutor                 replayed;
+
+    double recordMs = 0.0;
+    double sortMs   = 0.0;
+    double replayMs = 0.0;
+
+    unsigned unsortedChanges = 0;
+
+    for (unsigned run = 0; run < RUNS; ++run) {
+        auto const recordStart = steady_clock::now();
+
+        pool.parallelFor(DRAWS, [&](unsigned first, unsigned last) {
+            vox::CommandBuffer& buffer = recorders[first / GRAIN];
+            buffer.clear();
+
+            for (unsigned i = first; i < last; ++i) {
+                buffer.begin(chunkState(i), chunkDepth(i));
+                buffer.setUniform(0, chunkMatrix(view, i).data());
+                buffer.drawArrays(GL_TRIANGLES_MODE, i * 36, 36);
+            }
+        }, GRAIN);
+
+        auto const sortStart = steady_clock::now();
+        recordMs += msSince(recordStart);
+
+        merged.clear();
+        for (auto it = recorders.begin(); it != recorders.end(); ++it) {
+            merged.append(*it);
+        }
+
+        unsortedChanges = merged.stateChanges();
+        merged.sort();
+
+        auto const replayStart = steady_clock::now();
+        sortMs += msSince(sortStart);
+
+        merged.replay(replayed);
+
+        replayMs += msSince(replayStart);
+    }
+
+    recordMs /= RUNS;
+    sortMs   /= RUNS;
+    replayMs /= RUNS;
+
+    BOOST_MESSAGE("10k draws direct: " << directMs << "ms");
+    BOOST_MESSAGE("10k draws recorded on " << THREADS << " threads: " << recordMs
+        << "ms, merged and sorted: " << sortMs << "ms, replayed: " << replayMs << "ms");
+    BOOST_MESSAGE("state changes per frame direct: " << direct.stateChanges / RUNS
+        << ", as recorded: " << unsortedChanges << ", sorted: " << merged.stateChanges());
+
+    //same work either way, with far fewer state changes once sorted
+    BOOST_CHECK_EQUAL(replayed.draws,    direct.draws);
+    BOOST_CHECK_EQUAL(replayed.uniforms, direct.uniforms);
+    BOOST_CHECK_EQUAL(replayed.vertices, direct.vertices);
+    BOOST_CHECK_CLOSE(replayed.sum, direct.sum, 0.01);
+    BOOST_CHECK_EQUAL(merged.packets(), DRAWS);
+    BOOST_CHECK_LT(replayed.stateChanges, direct.stateChanges / 100);
+    BOOST_CHECK_EQUAL(unsortedChanges, direct.stateChanges / RUNS);
+    BOOST_CHECK_EQUAL(merged.stateChanges(), replayed.stateChanges / RUNS);
+}
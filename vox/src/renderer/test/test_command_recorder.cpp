@@ -0,0 +1,124 @@
+#include "common.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include "../commandRecorder.hpp"
+#include "../../util/frameArena.hpp"
+
+namespace util = ::vox::util;
+
+namespace {
+    unsigned const GL_TRIANGLES_MODE = 4;
+
+    //as ChunkRenderer::draw keeps its draw list
+    struct DrawItem {
+        unsigned chunk;
+        float    depth;
+    };
+
+    typedef std::vector<DrawItem, util::ArenaAllocator<DrawItem>> draw_list_t;
+
+    //remembers where each draw starts, in replay order
+    struct FirstsExecutor : vox::NullCommandExecutor {
+        void drawArrays(unsigned mode, int first, int count) {
+            vox::NullCommandExecutor::drawArrays(mode, first, count);
+            firsts.push_back(first);
+        }
+
+        std::vector<int> firsts;
+    };
+
+    //culls, records, sorts and replays objects chunks the way
+    //ChunkRenderer::draw does, minus the GL
+    unsigned drawFrame(
+        util::LinearArena&    frame,
+        util::ThreadPool&     pool,
+        vox::CommandRecorder& recorder,
+        unsigned              objects
+    ) {
+        draw_list_t visible((util::ArenaAllocator<DrawItem>(frame)));
+        visible.reserve(objects);
+
+        for (unsigned i = 0; i < objects; ++i) {
+            if (i % 3 != 0) {
+                DrawItem const item = { i, static_cast<float>((i * 7919) % 1009) };
+                visible.push_back(item);
+            }
+        }
+
+        vox::DrawState const state = { 1, 2, 3 };
+        float const matrix[16] = {0};
+
+        recorder.record(pool, static_cast<unsigned>(visible.size()), [&](vox::CommandBuffer& buffer, unsigned i) {
+            buffer.begin(state, visible[i].depth);
+            buffer.setUniform(0, matrix);
+            buffer.drawArrays(GL_TRIANGLES_MODE, visible[i].chunk * 36, 36);
+        });
+
+        recorder.merged().sort();
+
+        vox::NullCommandExecutor executor;
+        recorder.merged().replay(executor);
+
+        return executor.draws;
+    }
+} //namespace anon
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(CommandRecorderKeepsOrder)
+{
+    util::ThreadPool     pool(4);
+    vox::CommandRecorder recorder(10);
+
+    vox::DrawState const state = { 1, 1, 1 };
+
+    recorder.record(pool, 95, [&](vox::CommandBuffer& buffer, unsigned i) {
+        buffer.begin(state);
+        buffer.drawArrays(GL_TRIANGLES_MODE, static_cast<int>(i), 3);
+    });
+
+    //every group merged in order, whichever job finished first
+    FirstsExecutor executor;
+    recorder.merged().replay(executor);
+
+    BOOST_REQUIRE_EQUAL(executor.firsts.size(), 95u);
+    for (unsigned i = 0; i < 95; ++i) {
+        BOOST_CHECK_EQUAL(executor.firsts[i], static_cast<int>(i));
+    }
+
+    //fewer draws reuse the groups left from before
+    recorder.record(pool, 5, [&](vox::CommandBuffer& buffer, unsigned i) {
+        buffer.begin(state);
+        buffer.drawArrays(GL_TRIANGLES_MODE, static_cast<int>(i), 3);
+    });
+
+    BOOST_CHECK_EQUAL(recorder.merged().packets(), 5u);
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(FrameLoopNoSteadyStateGrowth)
+{
+    util::FrameArena     frames(3, 4 * 1024);
+    util::ThreadPool     pool(2);
+    vox::CommandRecorder recorder(64);
+
+    //the scene grows for a while, then settles
+    unsigned drawn = 0;
+    for (unsigned i = 0; i < 30; ++i) {
+        drawn += drawFrame(frames.beginFrame(), pool, recorder, 100 + i * 20);
+    }
+
+    unsigned const warmArena    = frames.heapAllocations();
+    size_t const   warmCommands = recorder.capacity();
+
+    for (unsigned i = 0; i < 1000; ++i) {
+        drawn += drawFrame(frames.beginFrame(), pool, recorder, 100 + 29 * 20 - (i % 7) * 10);
+    }
+
+    BOOST_CHECK(drawn > 0);
+    BOOST_CHECK(warmArena > 0u);
+
+    //the draw lists fit the arenas and the commands fit the buffers from the
+    //warm up; only the pool's own job bookkeeping is left on the heap
+    BOOST_CHECK_EQUAL(frames.heapAllocations(), warmArena);
+    BOOST_CHECK_EQUAL(recorder.capacity(), warmCommands);
+}
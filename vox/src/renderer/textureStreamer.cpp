@@ -0,0 +1,172 @@
+#include "common.hpp"
+#include "textureStreamer.hpp"
+
+#include "../util/threadPool.hpp"
+
+namespace vgl = ::vox::gl;
+
+vox::TextureStreamer::TextureStreamer(
+    util::ThreadPool& pool,
+    unsigned          slots,
+    unsigned          slotSize
+)
+    : pool_(pool)
+    , slotSize_(slotSize)
+    , uploaded_(0)
+{
+    assert(slots > 0);
+
+    for (unsigned i = 0; i < slots; ++i) {
+        std::unique_ptr<Slot> slot(new Slot());
+        slot->pixels = nullptr;
+        slot->state  = SLOT_FREE;
+
+        slots_.push_back(std::move(slot));
+    }
+}
+
+vox::TextureStreamer::~TextureStreamer()
+{
+    {//lock
+        boost::unique_lock<boost::mutex> lock(mutex_);
+
+        for (auto it = inFlight_.begin(); it != inFlight_.end(); ++it) {
+            while ((*it)->state == SLOT_DECODING) {
+                decoded_.wait(lock);
+            }
+        }
+    }//unlock
+
+    //no GL calls: a buffer still mapped is unmapped when it's deleted, and
+    //update() leaves nothing bound
+}
+
+void
+vox::TextureStreamer::request(unsigned bytes, decoder_t decode, upload_t upload)
+{
+    assert(bytes > 0 && decode && upload);
+
+    Request request;
+    request.bytes  = bytes;
+    request.decode = std::move(decode);
+    request.upload = std::move(upload);
+
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    waiting_.push_back(std::move(request));
+}
+
+unsigned
+vox::TextureStreamer::update(unsigned const budget)
+{
+    unsigned sent = 0;
+
+    //uploads, oldest first
+    while (!inFlight_.empty()) {
+        Slot& slot = *inFlight_.front();
+
+        SlotState state;
+        {//lock
+            boost::lock_guard<boost::mutex> lock(mutex_);
+            state = slot.state;
+        }//unlock
+
+        if (state == SLOT_DECODING) {
+            break;
+        }
+
+        if (state == SLOT_DECODED && sent > 0 && sent + slot.request.bytes > budget) {
+            break;
+        }
+
+        slot.buffer.bind();
+        slot.pixels = nullptr;
+
+        if (!slot.buffer.unmap()) {
+            //the driver lost the contents; decode into a fresh mapping
+            if (state == SLOT_DECODED) {
+                inFlight_.pop_front();
+                dispatch_(slot);
+                continue;
+            }
+        } else if (state == SLOT_DECODED) {
+            slot.request.upload(nullptr);
+
+            sent      += slot.request.bytes;
+            uploaded_ += slot.request.bytes;
+        }
+
+        slot.request = Request();
+        inFlight_.pop_front();
+
+        boost::lock_guard<boost::mutex> lock(mutex_);
+        slot.state = SLOT_FREE;
+    }
+
+    //hand free buffers to waiting requests
+    for (auto it = slots_.begin(); it != slots_.end(); ++it) {
+        Slot& slot = **it;
+
+        {//lock
+            boost::lock_guard<boost::mutex> lock(mutex_);
+
+            if (slot.state != SLOT_FREE || waiting_.empty()) {
+                continue;
+            }
+
+            slot.request = std::move(waiting_.front());
+            waiting_.pop_front();
+        }//unlock
+
+        dispatch_(slot);
+    }
+
+    vgl::detail::unbindBuffer(vgl::BUFFER_TARGET_PIXEL_UNPACK);
+
+    return sent;
+}
+
+unsigned
+vox::TextureStreamer::pending() const
+{
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    return static_cast<unsigned>(waiting_.size() + inFlight_.size());
+}
+
+void
+vox::TextureStreamer::dispatch_(Slot& slot)
+{
+    unsigned const bytes = std::max(slot.request.bytes, slotSize_);
+
+    //orphan the old storage so this never waits on an upload still reading it
+    slot.buffer.bind();
+    slot.buffer.allocate(bytes);
+    slot.pixels = static_cast<unsigned char*>(slot.buffer.map(
+        0, bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT
+    ));
+
+    {//lock
+        boost::lock_guard<boost::mutex> lock(mutex_);
+        slot.state = SLOT_DECODING;
+    }//unlock
+
+    inFlight_.push_back(&slot);
+
+    Slot* const target = &slot;
+    pool_.enqueue([this, target] { decode_(*target); });
+}
+
+void
+vox::TextureStreamer::decode_(Slot& slot)
+{
+    bool ok = false;
+
+    try {
+        ok = slot.request.decode(slot.pixels);
+    } catch (...) {
+        ok = false;
+    }
+
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    slot.state = ok ? SLOT_DECODED : SLOT_FAILED;
+    decoded_.notify_all();
+}
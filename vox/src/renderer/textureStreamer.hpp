@@ -0,0 +1,96 @@
+#pragma once
+#ifndef VOX_RENDERER_TEXTURE_STREAMER_HPP
+#define VOX_RENDERER_TEXTURE_STREAMER_HPP
+
+#include <deque>
+#include <memory>
+#include <functional>
+#include <boost/utility.hpp>
+#include <boost/thread.hpp>
+
+#include "../gl/vgl.hpp"
+
+namespace vox {
+
+namespace util { class ThreadPool; }
+
+////////////////////////////////////////////////////////////////////////////////
+// Streams images into textures without stalling the render thread.
+//
+// A ring of pixel unpack buffers is mapped on the render thread and each
+// mapped buffer handed to a worker, which decodes a requested image straight
+// into it. Back on the render thread update() unmaps decoded buffers and
+// runs the request's upload with the buffer bound, so its glTexSubImage*
+// reads from the buffer and returns once the transfer is queued. Buffers are
+// orphaned before being mapped again, so reuse never waits on the GPU.
+//
+// Images are uploaded in the order they were requested, as many per frame
+// as fit in update()'s byte budget.
+////////////////////////////////////////////////////////////////////////////////
+class TextureStreamer : private boost::noncopyable {
+public:
+    //write the image into pixels; runs on a worker. false drops the request
+    typedef std::function<bool (unsigned char* pixels)> decoder_t;
+    //copy the image into its texture; runs on the render thread with the
+    //buffer bound to the unpack target, so pixels is an offset into it
+    typedef std::function<void (GLvoid const* pixels)> upload_t;
+
+    //slots unpack buffers of at least slotSize bytes; render thread only
+    TextureStreamer(util::ThreadPool& pool, unsigned slots = 4, unsigned slotSize = 1024 * 1024);
+    //waits for decodes in flight and drops their uploads; render thread only
+    ~TextureStreamer();
+
+    //decode a bytes sized image and upload it; may be called on any thread
+    void request(unsigned bytes, decoder_t decode, upload_t upload);
+
+    //upload decoded images until budget bytes have gone this call, then
+    //give free buffers to waiting requests. An image bigger than the whole
+    //budget goes alone. Returns the bytes uploaded; render thread only
+    unsigned update(unsigned budget);
+
+    //requests not yet uploaded
+    unsigned pending() const;
+    //bytes uploaded so far
+    unsigned long long uploaded() const { return uploaded_; }
+private:
+    typedef gl::Buffer<gl::BUFFER_USAGE_STREAM_DRAW, gl::BUFFER_TARGET_PIXEL_UNPACK> buffer_t;
+
+    struct Request {
+        unsigned  bytes;
+        decoder_t decode;
+        upload_t  upload;
+    };
+
+    enum SlotState {
+        SLOT_FREE,
+        SLOT_DECODING,
+        SLOT_DECODED,
+        SLOT_FAILED,
+    };
+
+    struct Slot {
+        buffer_t       buffer;
+        unsigned char* pixels; //mapped while decoding
+        SlotState      state;
+        Request        request;
+    };
+
+    //map slot and hand it to a worker
+    void dispatch_(Slot& slot);
+    //worker side of dispatch_
+    void decode_(Slot& slot);
+
+    util::ThreadPool&                  pool_;
+    unsigned                           slotSize_;
+    std::vector<std::unique_ptr<Slot>> slots_;
+    std::deque<Slot*>                  inFlight_; //dispatch order
+    std::deque<Request>                waiting_;
+    unsigned long long                 uploaded_;
+
+    mutable boost::mutex      mutex_;
+    boost::condition_variable decoded_;
+};
+
+} //namespace vox
+
+#endif //VOX_RENDERER_TEXTURE_STREAMER_HPP
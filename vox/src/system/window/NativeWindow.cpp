@@ -38,6 +38,10 @@ struct sys::detail::native_window_data {
         win.swap();
     }
 
+    bool setSwapInterval(int interval) const {
+        return win.setSwapInterval(interval);
+    }
+
     util::Rectangle<unsigned> clientSize() const {
         RECT const r = win.getClientRect();
         return util::Rectangle<unsigned>(r.left, r.top, r.right, r.bottom);
@@ -120,6 +124,12 @@ sys::NativeWindow::swap() const
     impl_->swap();
 }
 
+bool
+sys::NativeWindow::setSwapInterval(int const interval) const
+{
+    return impl_->setSwapInterval(interval);
+}
+
 vox::util::Rectangle<unsigned>
 sys::NativeWindow::clientSize() const
 {
@@ -60,6 +60,10 @@ namespace vox {
 			static bool doEventsWait();
 
 			void swap() const;
+			//frames to wait for vertical blank in swap: 0 doesn't wait, 1 is
+			//vsync and -1 is vsync unless the frame is late. Call with the
+			//context current; returns false if the driver doesn't support it
+			bool setSwapInterval(int interval) const;
 			OpenGlContext acquireGl();
             void releaseGl();
 		public:
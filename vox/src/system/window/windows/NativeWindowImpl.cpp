@@ -983,6 +983,21 @@ detail::GlWindow::swap() const
 	CHECK_API_FAILURE(result == FALSE, "SwapBuffers");
 }
 
+bool
+detail::GlWindow::setSwapInterval(int const interval) const
+{
+    //negative intervals are adaptive vsync, which needs swap_control_tear
+    if (!WGLEW_EXT_swap_control || (interval < 0 && !WGLEW_EXT_swap_control_tear)) {
+        LOG_TRACE(L"GlWindow[%1%]::setSwapInterval(%2%) unsupported", window() % interval);
+        return false;
+    }
+
+	auto const result = ::wglSwapIntervalEXT(interval);
+	CHECK_API_FAILURE(result == FALSE, "wglSwapIntervalEXT");
+
+    return true;
+}
+
 HDC
 detail::Window::deviceContext() const
 {
@@ -188,6 +188,8 @@ namespace vox {
 				virtual bool close();
 
 				void swap() const;
+                //see NativeWindow::setSwapInterval
+                bool setSwapInterval(int interval) const;
 				
                 handle<HGLRC>::unique acquireGl();
                 void releaseGl(handle<HGLRC>::unique handle);
@@ -0,0 +1,158 @@
+#include "common.hpp"
+#include "frameArena.hpp"
+
+namespace util = ::vox::util;
+
+////////////////////////////////////////////////////////////////////////////////
+// LinearArena
+////////////////////////////////////////////////////////////////////////////////
+util::LinearArena::LinearArena(size_t blockSize)
+    : blockSize_(blockSize)
+    , current_(0)
+    , cur_(nullptr)
+    , end_(nullptr)
+    , heapAllocations_(0)
+{
+}
+
+util::LinearArena::~LinearArena()
+{
+    freeBlocks_();
+}
+
+void
+util::LinearArena::freeBlocks_()
+{
+    std::for_each(blocks_.begin(), blocks_.end(), [](Block const& b) {
+        ::operator delete(b.data);
+    });
+
+    blocks_.clear();
+}
+
+void
+util::LinearArena::useBlock_(size_t const i)
+{
+    current_ = i;
+    cur_     = blocks_[i].data;
+    end_     = blocks_[i].data + blocks_[i].size;
+}
+
+void*
+util::LinearArena::allocateSlow_(size_t const size, size_t const align)
+{
+    //blocks after the current one are left over from a frame before the
+    //last reset merged them
+    for (size_t i = blocks_.empty() ? 0 : current_ + 1; i < blocks_.size(); ++i) {
+        useBlock_(i);
+
+        char* const p = align_(cur_, align);
+        if (p + size <= end_) {
+            cur_ = p + size;
+            return p;
+        }
+    }
+
+    Block block;
+    block.size = std::max(blockSize_, size + align);
+    block.data = static_cast<char*>(::operator new(block.size));
+
+    blocks_.push_back(block);
+    ++heapAllocations_;
+
+    useBlock_(blocks_.size() - 1);
+
+    char* const p = align_(cur_, align);
+    cur_ = p + size;
+    return p;
+}
+
+void
+util::LinearArena::reset()
+{
+    if (blocks_.empty()) {
+        return;
+    }
+
+    //the last frame needed more than one block; make one block that holds
+    //all of it
+    if (current_ > 0) {
+        size_t total = 0;
+        std::for_each(blocks_.begin(), blocks_.end(), [&](Block const& b) {
+            total += b.size;
+        });
+
+        freeBlocks_();
+
+        Block block;
+        block.size = total;
+        block.data = static_cast<char*>(::operator new(total));
+
+        blocks_.push_back(block);
+        ++heapAllocations_;
+    }
+
+    useBlock_(0);
+}
+
+size_t
+util::LinearArena::used() const
+{
+    if (blocks_.empty()) {
+        return 0;
+    }
+
+    size_t total = cur_ - blocks_[current_].data;
+    for (size_t i = 0; i < current_; ++i) {
+        total += blocks_[i].size;
+    }
+
+    return total;
+}
+
+size_t
+util::LinearArena::capacity() const
+{
+    size_t total = 0;
+    std::for_each(blocks_.begin(), blocks_.end(), [&](Block const& b) {
+        total += b.size;
+    });
+
+    return total;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// FrameArena
+////////////////////////////////////////////////////////////////////////////////
+util::FrameArena::FrameArena(unsigned frames, size_t blockSize)
+    : index_(0)
+{
+    for (unsigned i = 0; i < std::max(1u, frames); ++i) {
+        arenas_.push_back(new LinearArena(blockSize));
+    }
+}
+
+util::FrameArena::~FrameArena()
+{
+    std::for_each(arenas_.begin(), arenas_.end(), [](LinearArena* a) { delete a; });
+}
+
+util::LinearArena&
+util::FrameArena::beginFrame()
+{
+    index_ = (index_ + 1) % arenas_.size();
+    arenas_[index_]->reset();
+
+    return *arenas_[index_];
+}
+
+unsigned
+util::FrameArena::heapAllocations() const
+{
+    unsigned result = 0;
+    for (auto it = arenas_.begin(); it != arenas_.end(); ++it) {
+        result += (*it)->heapAllocations();
+    }
+
+    return result;
+}
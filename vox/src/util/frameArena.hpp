@@ -0,0 +1,153 @@
+#pragma once
+#ifndef VOX_UTIL_FRAME_ARENA_HPP
+#define VOX_UTIL_FRAME_ARENA_HPP
+
+#include <vector>
+#include <limits>
+#include <cstddef>
+#include <type_traits>
+#include <boost/utility.hpp>
+
+namespace vox {
+    namespace util {
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Bump allocator: allocations advance a pointer through large blocks and
+    // are never freed one by one, only all at once by reset(). When a frame
+    // overflows the first block more are added; reset() then merges them into
+    // a single block big enough for the whole frame, so once the frames stop
+    // growing the arena no longer touches the heap.
+    ////////////////////////////////////////////////////////////////////////////
+    class LinearArena : private boost::noncopyable {
+    public:
+        explicit LinearArena(size_t blockSize = 64 * 1024);
+        ~LinearArena();
+
+        //align must be a power of two
+        void* allocate(size_t size, size_t align = 16) {
+            char* const p = align_(cur_, align);
+            if (p + size <= end_ && p >= cur_) {
+                cur_ = p + size;
+                return p;
+            }
+
+            return allocateSlow_(size, align);
+        }
+
+        //everything allocated so far is gone
+        void reset();
+
+        //bytes handed out since the last reset, alignment padding included
+        size_t used() const;
+        //bytes in all blocks
+        size_t capacity() const;
+        //blocks taken from the heap over the arena's life
+        unsigned heapAllocations() const { return heapAllocations_; }
+    private:
+        struct Block {
+            char*  data;
+            size_t size;
+        };
+
+        static char* align_(char* p, size_t align) {
+            size_t const n = reinterpret_cast<size_t>(p);
+            return reinterpret_cast<char*>((n + align - 1) & ~(align - 1));
+        }
+
+        void* allocateSlow_(size_t size, size_t align);
+        void  useBlock_(size_t i);
+        void  freeBlocks_();
+
+        size_t const       blockSize_;
+        std::vector<Block> blocks_;
+        size_t             current_;
+        char*              cur_;
+        char*              end_;
+        unsigned           heapAllocations_;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // One LinearArena per frame in flight. beginFrame() moves to the next one
+    // and resets it, so data allocated for a frame stays valid until that
+    // many frames later, e.g. while the GPU may still be reading it.
+    ////////////////////////////////////////////////////////////////////////////
+    class FrameArena : private boost::noncopyable {
+    public:
+        explicit FrameArena(unsigned frames = 3, size_t blockSize = 256 * 1024);
+        ~FrameArena();
+
+        LinearArena& beginFrame();
+        LinearArena& current() { return *arenas_[index_]; }
+
+        unsigned frames() const { return static_cast<unsigned>(arenas_.size()); }
+        //blocks every arena has taken from the heap
+        unsigned heapAllocations() const;
+    private:
+        std::vector<LinearArena*> arenas_;
+        unsigned                  index_;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Standard allocator over a LinearArena. deallocate does nothing; the
+    // memory comes back when the arena is reset, so a container using it
+    // must not outlive the arena's current frame.
+    ////////////////////////////////////////////////////////////////////////////
+    template <typename T>
+    class ArenaAllocator {
+    public:
+        typedef T              value_type;
+        typedef T*             pointer;
+        typedef T const*       const_pointer;
+        typedef T&             reference;
+        typedef T const&       const_reference;
+        typedef size_t         size_type;
+        typedef std::ptrdiff_t difference_type;
+
+        template <typename U>
+        struct rebind {
+            typedef ArenaAllocator<U> other;
+        };
+
+        explicit ArenaAllocator(LinearArena& arena) : arena_(&arena) {}
+
+        template <typename U>
+        ArenaAllocator(ArenaAllocator<U> const& other) : arena_(&other.arena()) {}
+
+        LinearArena& arena() const { return *arena_; }
+
+        pointer       address(reference x)       const { return &x; }
+        const_pointer address(const_reference x) const { return &x; }
+
+        pointer allocate(size_type n, void const* = nullptr) {
+            return static_cast<pointer>(
+                arena_->allocate(n * sizeof(T), std::alignment_of<T>::value)
+            );
+        }
+
+        void deallocate(pointer, size_type) {
+        }
+
+        size_type max_size() const {
+            return std::numeric_limits<size_type>::max() / sizeof(T);
+        }
+
+        void construct(pointer p, T const& value) {
+            ::new (static_cast<void*>(p)) T(value);
+        }
+
+        void destroy(pointer p) {
+            p->~T();
+        }
+
+        template <typename U>
+        bool operator==(ArenaAllocator<U> const& rhs) const { return arena_ == &rhs.arena(); }
+        template <typename U>
+        bool operator!=(ArenaAllocator<U> const& rhs) const { return arena_ != &rhs.arena(); }
+    private:
+        LinearArena* arena_;
+    };
+
+    } //namespace util
+} //namespace vox
+
+#endif //VOX_UTIL_FRAME_ARENA_HPP
@@ -0,0 +1,150 @@
+#include "common.hpp"
+#include "framePacer.hpp"
+
+#include <algorithm>
+#include <boost/thread.hpp>
+
+#if defined( VOX_WINDOWS )
+#   include <mmsystem.h>
+#   pragma comment(lib, "winmm.lib")
+#endif
+
+namespace util = ::vox::util;
+
+namespace {
+    typedef util::FramePacer::clock clock;
+
+    //spin for at least this many ms, and never more than MAX_SPIN
+    double const MIN_SPIN     = 0.25;
+    double const MAX_SPIN     = 4.0;
+    double const INITIAL_SPIN = 2.0;
+    //how quickly the spin shrinks again while sleeps wake on time
+    double const SPIN_DECAY   = 0.02;
+
+    //the prediction follows slower frames at once and faster ones gradually,
+    //so one quick frame doesn't make the next start too late
+    double const PREDICTION_DECAY = 0.1;
+    //ms low latency leaves spare before the frame is due
+    double const LATENCY_SLACK    = 1.0;
+
+    double toMs(clock::duration const d) {
+        return boost::chrono::duration<double, boost::milli>(d).count();
+    }
+
+    clock::duration fromMs(double const ms) {
+        return boost::chrono::duration_cast<clock::duration>(
+            boost::chrono::duration<double, boost::milli>(ms)
+        );
+    }
+} //namespace anon
+
+util::FramePacer::FramePacer(float const hz)
+    : hz_(0.0f)
+    , lowLatency_(false)
+    , interval_(clock::duration::zero())
+    , next_(clock::now())
+    , start_(next_)
+    , predicted_(0.0)
+    , waited_(0.0)
+    , spin_(INITIAL_SPIN)
+{
+#if defined( VOX_WINDOWS )
+    //sleeps otherwise wake on the default 15.6ms tick
+    ::timeBeginPeriod(1);
+#endif
+
+    setTarget(hz);
+}
+
+util::FramePacer::~FramePacer()
+{
+#if defined( VOX_WINDOWS )
+    ::timeEndPeriod(1);
+#endif
+}
+
+void
+util::FramePacer::setTarget(float const hz)
+{
+    hz_       = std::max(hz, 0.0f);
+    interval_ = hz_ > 0.0f ? fromMs(1000.0 / hz_) : clock::duration::zero();
+    next_     = clock::now();
+}
+
+void
+util::FramePacer::setLowLatency(bool const lowLatency)
+{
+    lowLatency_ = lowLatency;
+}
+
+void
+util::FramePacer::beginFrame()
+{
+    clock::time_point const before = clock::now();
+
+    if (interval_ == clock::duration::zero()) {
+        start_  = before;
+        waited_ = 0.0;
+        return;
+    }
+
+    clock::time_point deadline = next_;
+    if (lowLatency_) {
+        double const delay = toMs(interval_) - predicted_ - LATENCY_SLACK;
+        if (delay > 0.0) {
+            deadline += fromMs(delay);
+        }
+    }
+
+    waitUntil_(deadline);
+
+    start_  = clock::now();
+    waited_ = toMs(start_ - before);
+
+    //more than a frame behind: start the schedule over rather than running
+    //frames back to back to catch up
+    if (start_ - next_ > interval_) {
+        next_ = start_;
+    }
+
+    next_ += interval_;
+}
+
+void
+util::FramePacer::endFrame()
+{
+    double const work = toMs(clock::now() - start_);
+
+    if (work > predicted_) {
+        predicted_ = work;
+    } else {
+        predicted_ += (work - predicted_) * PREDICTION_DECAY;
+    }
+}
+
+void
+util::FramePacer::waitUntil_(clock::time_point const deadline)
+{
+    for (;;) {
+        clock::time_point const now = clock::now();
+        double const remaining = toMs(deadline - now);
+        if (remaining <= spin_) {
+            break;
+        }
+
+        double const sleep = remaining - spin_;
+        boost::this_thread::sleep_for(fromMs(sleep));
+
+        //grow the spin to cover however late the sleep woke
+        double const late = toMs(clock::now() - now) - sleep;
+        if (late > spin_) {
+            spin_ = std::min(late, MAX_SPIN);
+        } else {
+            spin_ = std::max(spin_ + (late - spin_) * SPIN_DECAY, MIN_SPIN);
+        }
+    }
+
+    while (clock::now() < deadline) {
+        boost::this_thread::yield();
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+#ifndef VOX_UTIL_FRAME_PACER_HPP
+#define VOX_UTIL_FRAME_PACER_HPP
+
+#include <boost/utility.hpp>
+#include <boost/chrono.hpp>
+
+namespace vox {
+    namespace util {
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Starts frames at a fixed rate. Waiting sleeps for most of the time and
+    // spins for the last stretch, since a sleep can wake late by about a
+    // timer tick; how late is learned as it goes, so the spin stays short.
+    //
+    // With low latency on, a frame isn't started as soon as the last one is
+    // done but as late as it can be and still finish in time, going by how
+    // long recent frames took, so input is read closer to when it's shown.
+    ////////////////////////////////////////////////////////////////////////////
+    class FramePacer : private boost::noncopyable {
+    public:
+        typedef boost::chrono::steady_clock clock;
+
+        //0 doesn't limit the rate
+        explicit FramePacer(float hz = 0.0f);
+        ~FramePacer();
+
+        void setTarget(float hz);
+        void setLowLatency(bool lowLatency);
+
+        //wait until the next frame should start
+        void beginFrame();
+        //the frame's work, swap included, is done
+        void endFrame();
+
+        float target()     const { return hz_; }
+        bool  lowLatency() const { return lowLatency_; }
+        //ms beginFrame waited last time
+        double waited()    const { return waited_; }
+        //ms a frame is expected to take
+        double predicted() const { return predicted_; }
+    private:
+        void waitUntil_(clock::time_point deadline);
+
+        float             hz_;
+        bool              lowLatency_;
+        clock::duration   interval_;   //zero if unlimited
+        clock::time_point next_;       //earliest the next frame may start
+        clock::time_point start_;      //of the current frame
+        double            predicted_;  //ms
+        double            waited_;     //ms
+        double            spin_;       //ms left to spin instead of sleep
+    };
+
+    } //namespace util
+} //namespace vox
+
+#endif //VOX_UTIL_FRAME_PACER_HPP
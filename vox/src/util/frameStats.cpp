@@ -0,0 +1,118 @@
+#include "common.hpp"
+#include "frameStats.hpp"
+
+#include <cmath>
+#include <sstream>
+#include <algorithm>
+#include <boost/format.hpp>
+
+namespace util = ::vox::util;
+
+namespace {
+    //nearest rank; sorted must not be empty
+    double percentile(std::vector<double> const& sorted, double const p) {
+        unsigned const rank = static_cast<unsigned>(std::ceil(p * sorted.size()));
+        return sorted[std::max(rank, 1u) - 1];
+    }
+} //namespace anon
+
+util::FrameStats::FrameStats(unsigned const capacity)
+    : samples_(std::max(capacity, 1u))
+    , next_(0)
+    , count_(0)
+{
+}
+
+void
+util::FrameStats::record(Sample const& sample)
+{
+    boost::lock_guard<boost::mutex> lock(mutex_);
+
+    samples_[next_] = sample;
+    next_ = (next_ + 1) % samples_.size();
+    count_ = std::min(count_ + 1, static_cast<unsigned>(samples_.size()));
+}
+
+util::FrameStats::Summary
+util::FrameStats::summary(Series const series) const
+{
+    assert(series < SERIES_COUNT);
+
+    Summary result = { 0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+
+    std::vector<double> times;
+
+    {//lock
+        boost::lock_guard<boost::mutex> lock(mutex_);
+
+        times.reserve(count_);
+        for (unsigned i = 0; i < count_; ++i) {
+            times.push_back(samples_[i].times[series]);
+        }
+    }//unlock
+
+    if (times.empty()) {
+        return result;
+    }
+
+    std::sort(times.begin(), times.end());
+
+    double total = 0.0;
+    for (auto it = times.begin(); it != times.end(); ++it) {
+        total += *it;
+    }
+
+    result.count = static_cast<unsigned>(times.size());
+    result.min   = times.front();
+    result.mean  = total / times.size();
+    result.p50   = percentile(times, 0.50);
+    result.p95   = percentile(times, 0.95);
+    result.p99   = percentile(times, 0.99);
+    result.max   = times.back();
+
+    return result;
+}
+
+std::string
+util::FrameStats::report() const
+{
+    std::ostringstream out;
+    out << boost::format("%-10s %6s %8s %8s %8s %8s %8s %8s\n")
+        % "frame ms" % "count" % "min" % "mean" % "p50" % "p95" % "p99" % "max";
+
+    for (unsigned i = 0; i < SERIES_COUNT; ++i) {
+        Series const series = static_cast<Series>(i);
+        Summary const s = summary(series);
+
+        out << boost::format("%-10s %6u %8.2f %8.2f %8.2f %8.2f %8.2f %8.2f\n")
+            % name(series) % s.count % s.min % s.mean % s.p50 % s.p95 % s.p99 % s.max;
+    }
+
+    return out.str();
+}
+
+unsigned
+util::FrameStats::count() const
+{
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    return count_;
+}
+
+void
+util::FrameStats::clear()
+{
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    next_  = 0;
+    count_ = 0;
+}
+
+char const*
+util::FrameStats::name(Series const series)
+{
+    static char const* const NAMES[SERIES_COUNT] = {
+        "interval", "cpu", "drain", "swap"
+    };
+
+    assert(series < SERIES_COUNT);
+    return NAMES[series];
+}
@@ -0,0 +1,68 @@
+#pragma once
+#ifndef VOX_UTIL_FRAME_STATS_HPP
+#define VOX_UTIL_FRAME_STATS_HPP
+
+#include <string>
+#include <vector>
+#include <boost/utility.hpp>
+#include <boost/thread.hpp>
+
+namespace vox {
+    namespace util {
+
+    ////////////////////////////////////////////////////////////////////////////
+    // CPU side times of the last few hundred frames, so stutter shows up in
+    // the tail percentiles instead of vanishing into an average. Every member
+    // is thread safe.
+    ////////////////////////////////////////////////////////////////////////////
+    class FrameStats : private boost::noncopyable {
+    public:
+        enum Series {
+            SERIES_INTERVAL, //start of the previous frame to the start of this one
+            SERIES_CPU,      //the frame's work on the render thread, less the swap
+            SERIES_DRAIN,    //running queued render tasks
+            SERIES_SWAP,     //presenting and swapping
+            SERIES_COUNT
+        };
+
+        //ms for each series
+        struct Sample {
+            double times[SERIES_COUNT];
+        };
+
+        struct Summary {
+            unsigned count;
+            double   min;
+            double   mean;
+            double   p50;
+            double   p95;
+            double   p99;
+            double   max;
+        };
+
+        //keeps the last capacity frames
+        explicit FrameStats(unsigned capacity = 300);
+
+        void record(Sample const& sample);
+
+        //over the frames kept; all zero before the first
+        Summary summary(Series series) const;
+        //one line per series
+        std::string report() const;
+
+        //frames kept
+        unsigned count() const;
+        void clear();
+
+        static char const* name(Series series);
+    private:
+        mutable boost::mutex mutex_;
+        std::vector<Sample>  samples_; //ring; next_ is the oldest once full
+        unsigned             next_;
+        unsigned             count_;
+    };
+
+    } //namespace util
+} //namespace vox
+
+#endif //VOX_UTIL_FRAME_STATS_HPP
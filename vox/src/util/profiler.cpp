@@ -0,0 +1,306 @@
+#include "common.hpp"
+#include "profiler.hpp"
+#include "timings.hpp"
+
+#include <deque>
+#include <ostream>
+#include <boost/chrono.hpp>
+
+namespace util = ::vox::util;
+
+VOX_THREAD_LOCAL util::ProfileChunk* util::profileChunk = nullptr;
+
+bool volatile util::Profiler::enabled_ = true;
+
+namespace {
+    typedef boost::chrono::steady_clock clock;
+
+    //about 6MB of events across every thread
+    unsigned const DEFAULT_MAX_CHUNKS = 64;
+    //shortest span the tick rate is measured over
+    boost::chrono::milliseconds const CALIBRATION_TIME(10);
+
+    struct ProfileThread {
+        char const*         name;
+        util::ProfileChunk* current;  //written only by its thread; never reused
+    };
+
+    struct ProfileRecord {
+        util::ProfileEvent event;
+        unsigned           thread;
+    };
+
+    struct ProfileState {
+        ProfileState()
+            : maxChunks(DEFAULT_MAX_CHUNKS)
+            , allocated(0)
+            , cutoff(0)
+            , originTicks(util::Profiler::now())
+            , originTime(clock::now())
+        {
+        }
+
+        boost::mutex                     mutex;
+        std::vector<ProfileThread>       threads;
+        std::deque<util::ProfileChunk*>  full;   //oldest first
+        std::vector<util::ProfileChunk*> spare;
+        unsigned                         maxChunks;
+        unsigned                         allocated;
+        util::profile_ticks_t            cutoff; //events starting before are cleared
+        util::profile_ticks_t            originTicks;
+        clock::time_point                originTime;
+    };
+
+    //index + 1 of the calling thread in ProfileState::threads, or 0
+    VOX_THREAD_LOCAL unsigned profileThread = 0;
+
+    //threads may still record while statics are destroyed at exit, so the
+    //state is created on first use and never freed
+    boost::once_flag profileStateOnce     = BOOST_ONCE_INIT;
+    ProfileState*    profileStateInstance = nullptr;
+
+    void createProfileState() {
+        profileStateInstance = new ProfileState();
+    }
+
+    ProfileState& profileState() {
+        boost::call_once(profileStateOnce, &createProfileState);
+        return *profileStateInstance;
+    }
+
+    //state.mutex must be held
+    unsigned registerThread(ProfileState& state) {
+        if (profileThread == 0) {
+            ProfileThread const thread = { nullptr, nullptr };
+            state.threads.push_back(thread);
+            profileThread = static_cast<unsigned>(state.threads.size());
+        }
+
+        return profileThread - 1;
+    }
+
+    //state.mutex must be held
+    void trimChunks(ProfileState& state) {
+        while (state.allocated > state.maxChunks && !state.spare.empty()) {
+            delete state.spare.back();
+            state.spare.pop_back();
+            --state.allocated;
+        }
+
+        while (state.allocated > state.maxChunks && !state.full.empty()) {
+            delete state.full.front();
+            state.full.pop_front();
+            --state.allocated;
+        }
+    }
+
+    //state.mutex must be held
+    void copyChunk(ProfileState const& state, util::ProfileChunk const& chunk, std::vector<ProfileRecord>& out) {
+        //the owning thread may be appending; everything below count is done
+        unsigned const count = chunk.count;
+        VOX_PROFILER_BARRIER();
+
+        for (unsigned i = 0; i < count; ++i) {
+            if (chunk.events[i].start < state.cutoff) {
+                continue;
+            }
+
+            ProfileRecord const record = { chunk.events[i], chunk.thread };
+            out.push_back(record);
+        }
+    }
+
+    //every event since the last clear, and the thread names
+    void snapshot(std::vector<ProfileRecord>& records, std::vector<char const*>& names) {
+        ProfileState& state = profileState();
+        boost::lock_guard<boost::mutex> lock(state.mutex);
+
+        for (auto it = state.full.begin(); it != state.full.end(); ++it) {
+            copyChunk(state, **it, records);
+        }
+
+        names.reserve(state.threads.size());
+        for (auto it = state.threads.begin(); it != state.threads.end(); ++it) {
+            if (it->current) {
+                copyChunk(state, *it->current, records);
+            }
+
+            names.push_back(it->name);
+        }
+    }
+
+    //the tick rate is only known once enough time has passed to measure it
+    double ticksPerMicrosecond() {
+        ProfileState& state = profileState();
+
+        if (clock::now() - state.originTime < CALIBRATION_TIME) {
+            boost::this_thread::sleep_for(CALIBRATION_TIME);
+        }
+
+        util::profile_ticks_t const ticks = util::Profiler::now();
+        clock::time_point const     time  = clock::now();
+
+        double const us = boost::chrono::duration<double, boost::micro>(time - state.originTime).count();
+        return static_cast<double>(ticks - state.originTicks) / us;
+    }
+
+    void writeJsonString(std::ostream& out, char const* str) {
+        out << '"';
+        for (; *str; ++str) {
+            if (*str == '"' || *str == '\\') {
+                out << '\\';
+            }
+            out << *str;
+        }
+        out << '"';
+    }
+} //namespace anon
+
+void
+util::Profiler::setEnabled(bool const enabled)
+{
+    //start calibrating before the first scope
+    profileState();
+    enabled_ = enabled;
+}
+
+void
+util::Profiler::setThreadName(char const* name)
+{
+    assert(name);
+
+    ProfileState& state = profileState();
+    boost::lock_guard<boost::mutex> lock(state.mutex);
+
+    state.threads[registerThread(state)].name = name;
+}
+
+util::ProfileChunk*
+util::Profiler::nextChunk_()
+{
+    ProfileState& state = profileState();
+    boost::lock_guard<boost::mutex> lock(state.mutex);
+
+    unsigned const index = registerThread(state);
+    ProfileThread& thread = state.threads[index];
+
+    if (thread.current) {
+        state.full.push_back(thread.current);
+        thread.current = nullptr;
+    }
+
+    ProfileChunk* chunk = nullptr;
+
+    if (!state.spare.empty()) {
+        chunk = state.spare.back();
+        state.spare.pop_back();
+    } else if (state.allocated >= state.maxChunks && !state.full.empty()) {
+        chunk = state.full.front();
+        state.full.pop_front();
+    } else {
+        //every thread keeps a chunk, so more threads than maxChunks go over
+        chunk = new ProfileChunk;
+        ++state.allocated;
+    }
+
+    chunk->count  = 0;
+    chunk->thread = index;
+
+    thread.current = chunk;
+    profileChunk   = chunk;
+
+    return chunk;
+}
+
+void
+util::Profiler::exportChromeTrace(std::ostream& out)
+{
+    std::vector<ProfileRecord> records;
+    std::vector<char const*>   names;
+    snapshot(records, names);
+
+    double const rate = ticksPerMicrosecond();
+    profile_ticks_t const origin = profileState().originTicks;
+
+    out << "{\"traceEvents\":[\n";
+
+    bool first = true;
+
+    for (unsigned i = 0; i < names.size(); ++i) {
+        if (!names[i]) {
+            continue;
+        }
+
+        out << (first ? "" : ",\n")
+            << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << i
+            << ",\"args\":{\"name\":";
+        writeJsonString(out, names[i]);
+        out << "}}";
+
+        first = false;
+    }
+
+    for (auto it = records.begin(); it != records.end(); ++it) {
+        ProfileEvent const& event = it->event;
+
+        double const ts  = static_cast<double>(static_cast<long long>(event.start - origin)) / rate;
+        double const dur = static_cast<double>(event.end - event.start) / rate;
+
+        out << (first ? "" : ",\n") << "{\"name\":";
+        writeJsonString(out, event.name);
+        out << boost::format(",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}")
+            % it->thread % ts % dur;
+
+        first = false;
+    }
+
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+void
+util::Profiler::summarize(Timings& timings)
+{
+    std::vector<ProfileRecord> records;
+    std::vector<char const*>   names;
+    snapshot(records, names);
+
+    double const msRate = ticksPerMicrosecond() * 1000.0;
+
+    //names are literals, so the same name is almost always the same pointer
+    std::map<char const*, std::string> keys;
+
+    for (auto it = records.begin(); it != records.end(); ++it) {
+        ProfileEvent const& event = it->event;
+
+        auto key = keys.find(event.name);
+        if (key == keys.end()) {
+            key = keys.insert(std::make_pair(event.name, std::string("cpu/") + event.name)).first;
+        }
+
+        timings.record(key->second, static_cast<double>(event.end - event.start) / msRate);
+    }
+}
+
+void
+util::Profiler::clear()
+{
+    ProfileState& state = profileState();
+    boost::lock_guard<boost::mutex> lock(state.mutex);
+
+    //current chunks belong to their threads, so their old events are
+    //hidden rather than removed
+    state.cutoff = now();
+
+    state.spare.insert(state.spare.end(), state.full.begin(), state.full.end());
+    state.full.clear();
+}
+
+void
+util::Profiler::setMaxChunks(unsigned const chunks)
+{
+    ProfileState& state = profileState();
+    boost::lock_guard<boost::mutex> lock(state.mutex);
+
+    state.maxChunks = std::max(1u, chunks);
+    trimChunks(state);
+}
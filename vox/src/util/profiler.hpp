@@ -0,0 +1,135 @@
+#pragma once
+#ifndef VOX_UTIL_PROFILER_HPP
+#define VOX_UTIL_PROFILER_HPP
+
+#include <iosfwd>
+#include <boost/utility.hpp>
+#include <boost/preprocessor/cat.hpp>
+
+#if defined( VOX_MSVC )
+#   include <intrin.h>
+#   define VOX_PROFILER_BARRIER() _ReadWriteBarrier()
+#else
+#   include <x86intrin.h>
+#   define VOX_PROFILER_BARRIER() __asm__ __volatile__("" ::: "memory")
+#endif
+
+namespace vox {
+    namespace util {
+
+    class Timings;
+
+    typedef unsigned long long profile_ticks_t;
+
+    //events in each chunk of a thread's profile buffer
+    unsigned const PROFILE_CHUNK_EVENTS = 4096;
+
+    struct ProfileEvent {
+        char const*     name;
+        profile_ticks_t start;
+        profile_ticks_t end;
+    };
+
+    struct ProfileChunk {
+        ProfileEvent      events[PROFILE_CHUNK_EVENTS];
+        unsigned volatile count;  //only ever grows while the chunk is current
+        unsigned          thread; //index into the profiler's threads
+    };
+
+    //the calling thread's current chunk, if it has recorded anything
+    extern VOX_THREAD_LOCAL ProfileChunk* profileChunk;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Records timed scopes from any thread with almost no overhead: a scope
+    // is two reads of the time stamp counter and three stores into a buffer
+    // only its own thread writes to, with no locks or atomics. A thread only
+    // takes a lock when it fills a chunk of PROFILE_CHUNK_EVENTS and needs
+    // another, and readers only ever look below a chunk's published count.
+    //
+    // The most recent chunks are kept, so memory stays bounded when left on.
+    // Ticks are converted to time against a steady clock at export.
+    ////////////////////////////////////////////////////////////////////////////
+    class Profiler : private boost::noncopyable {
+    public:
+        static profile_ticks_t now() { return __rdtsc(); }
+
+        //scopes begun while disabled aren't recorded
+        static bool enabled() { return enabled_; }
+        static void setEnabled(bool enabled);
+
+        //name shown for the calling thread; must be a literal
+        static void setThreadName(char const* name);
+
+        //name must be a literal
+        static void record(char const* name, profile_ticks_t start, profile_ticks_t end) {
+            ProfileChunk* chunk = profileChunk;
+            if (!chunk || chunk->count == PROFILE_CHUNK_EVENTS) {
+                chunk = nextChunk_();
+            }
+
+            unsigned const i = chunk->count;
+
+            ProfileEvent& event = chunk->events[i];
+            event.name  = name;
+            event.start = start;
+            event.end   = end;
+
+            //the event must be in memory before readers can see the count;
+            //x86 keeps stores in order, so only the compiler needs stopping
+            VOX_PROFILER_BARRIER();
+            chunk->count = i + 1;
+        }
+
+        //everything recorded since the last clear as Chrome trace event JSON,
+        //for chrome://tracing or Perfetto
+        static void exportChromeTrace(std::ostream& out);
+        //add the time of every recorded scope to timings as "cpu/<name>"
+        static void summarize(Timings& timings);
+        //forget everything recorded so far
+        static void clear();
+
+        //most chunks kept across all threads; older ones are reused first
+        static void setMaxChunks(unsigned chunks);
+    private:
+        static ProfileChunk* nextChunk_();
+
+        static bool volatile enabled_;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Records the time from its construction to its destruction
+    ////////////////////////////////////////////////////////////////////////////
+    class ProfileScope : private boost::noncopyable {
+    public:
+        //name must be a literal
+        explicit ProfileScope(char const* name)
+            : name_(Profiler::enabled() ? name : nullptr)
+            , start_(name_ ? Profiler::now() : 0)
+        {
+        }
+
+        ~ProfileScope() {
+            if (name_) {
+                Profiler::record(name_, start_, Profiler::now());
+            }
+        }
+    private:
+        char const*     name_;
+        profile_ticks_t start_;
+    };
+
+    } //namespace util
+} //namespace vox
+
+#if defined( VOX_PROFILE )
+//profile the rest of the enclosing block as NAME, a literal
+#   define VOX_PROFILE_SCOPE(NAME) \
+        ::vox::util::ProfileScope BOOST_PP_CAT(vox_profile_scope_, __LINE__)(NAME)
+//name the calling thread in exported traces
+#   define VOX_PROFILE_THREAD(NAME) ::vox::util::Profiler::setThreadName(NAME)
+#else
+#   define VOX_PROFILE_SCOPE(NAME)  ((void)0)
+#   define VOX_PROFILE_THREAD(NAME) ((void)0)
+#endif
+
+#endif //VOX_UTIL_PROFILER_HPP
@@ -0,0 +1,61 @@
+#pragma once
+#ifndef VOX_UTIL_RADIX_SORT_HPP
+#define VOX_UTIL_RADIX_SORT_HPP
+
+#include <vector>
+#include <algorithm>
+
+namespace vox {
+    namespace util {
+
+    //sort items by key(item), an unsigned 64 bit integer, a byte at a time
+    //from the least significant. Stable; bytes every key has the same are
+    //skipped, so keys that only differ in a few bits sort in a few passes.
+    //scratch is working space, kept by the caller so it's only grown once
+    template <typename T, typename key_t>
+    void radixSort(std::vector<T>& items, std::vector<T>& scratch, key_t key) {
+        size_t const n = items.size();
+        if (n < 2) {
+            return;
+        }
+
+        scratch.resize(n);
+
+        T* from = &items[0];
+        T* to   = &scratch[0];
+
+        for (unsigned shift = 0; shift < 64; shift += 8) {
+            size_t counts[256] = {0};
+
+            for (size_t i = 0; i < n; ++i) {
+                ++counts[(key(from[i]) >> shift) & 0xFF];
+            }
+
+            if (counts[(key(from[0]) >> shift) & 0xFF] == n) {
+                continue;
+            }
+
+            //counts become where each byte's run starts
+            size_t offset = 0;
+            for (unsigned d = 0; d < 256; ++d) {
+                size_t const count = counts[d];
+                counts[d] = offset;
+                offset += count;
+            }
+
+            for (size_t i = 0; i < n; ++i) {
+                to[counts[(key(from[i]) >> shift) & 0xFF]++] = from[i];
+            }
+
+            std::swap(from, to);
+        }
+
+        if (from != &items[0]) {
+            std::copy(from, from + n, items.begin());
+        }
+    }
+
+    } //namespace util
+} //namespace vox
+
+#endif //VOX_UTIL_RADIX_SORT_HPP
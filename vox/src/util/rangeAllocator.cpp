@@ -0,0 +1,152 @@
+#include "common.hpp"
+#include "rangeAllocator.hpp"
+
+namespace util = ::vox::util;
+
+////////////////////////////////////////////////////////////////////////////////
+// RangeAllocator
+////////////////////////////////////////////////////////////////////////////////
+util::RangeAllocator::RangeAllocator(size_t capacity, size_t alignment)
+    : capacity_(0)
+    , alignment_(std::max<size_t>(1, alignment))
+    , used_(0)
+{
+    grow(capacity);
+}
+
+void
+util::RangeAllocator::addFree_(size_t offset, size_t size)
+{
+    //merge with the free ranges on either side
+    auto const next = free_.find(offset + size);
+    if (next != free_.end()) {
+        size += next->second;
+        removeFree_(next);
+    }
+
+    auto prev = free_.lower_bound(offset);
+    if (prev != free_.begin()) {
+        --prev;
+        if (prev->first + prev->second == offset) {
+            offset = prev->first;
+            size  += prev->second;
+            removeFree_(prev);
+        }
+    }
+
+    free_.insert(std::make_pair(offset, size));
+    freeBySize_.insert(std::make_pair(size, offset));
+}
+
+void
+util::RangeAllocator::removeFree_(by_offset_t::iterator const it)
+{
+    auto range = freeBySize_.equal_range(it->second);
+    for (; range.first != range.second; ++range.first) {
+        if (range.first->second == it->first) {
+            freeBySize_.erase(range.first);
+            break;
+        }
+    }
+
+    free_.erase(it);
+}
+
+bool
+util::RangeAllocator::allocate(size_t size, size_t& offset)
+{
+    size = (std::max<size_t>(1, size) + alignment_ - 1) / alignment_ * alignment_;
+
+    auto const best = freeBySize_.lower_bound(size);
+    if (best == freeBySize_.end()) {
+        return false;
+    }
+
+    size_t const freeOffset = best->second;
+    size_t const freeSize   = best->first;
+
+    removeFree_(free_.find(freeOffset));
+
+    if (freeSize > size) {
+        addFree_(freeOffset + size, freeSize - size);
+    }
+
+    ranges_.insert(std::make_pair(freeOffset, size));
+    used_ += size;
+
+    offset = freeOffset;
+    return true;
+}
+
+void
+util::RangeAllocator::free(size_t const offset)
+{
+    auto const it = ranges_.find(offset);
+    assert(it != ranges_.end() && "not a live range");
+
+    size_t const size = it->second;
+    ranges_.erase(it);
+    used_ -= size;
+
+    addFree_(offset, size);
+}
+
+void
+util::RangeAllocator::grow(size_t capacity)
+{
+    capacity = capacity / alignment_ * alignment_;
+    if (capacity <= capacity_) {
+        return;
+    }
+
+    size_t const old = capacity_;
+    capacity_ = capacity;
+
+    addFree_(old, capacity - old);
+}
+
+size_t
+util::RangeAllocator::sizeOf(size_t const offset) const
+{
+    auto const it = ranges_.find(offset);
+    assert(it != ranges_.end() && "not a live range");
+
+    return it->second;
+}
+
+size_t
+util::RangeAllocator::largestFree() const
+{
+    return freeBySize_.empty() ? 0 : freeBySize_.rbegin()->first;
+}
+
+std::vector<util::RangeAllocator::Move>
+util::RangeAllocator::compact()
+{
+    std::vector<Move> moves;
+
+    //ranges only ever move down, and in offset order, so each move lands in
+    //space already vacated
+    by_offset_t packed;
+    size_t      next = 0;
+
+    for (auto it = ranges_.begin(); it != ranges_.end(); ++it) {
+        if (it->first != next) {
+            Move const move = { it->first, next, it->second };
+            moves.push_back(move);
+        }
+
+        packed.insert(packed.end(), std::make_pair(next, it->second));
+        next += it->second;
+    }
+
+    ranges_.swap(packed);
+    free_.clear();
+    freeBySize_.clear();
+
+    if (next < capacity_) {
+        addFree_(next, capacity_ - next);
+    }
+
+    return moves;
+}
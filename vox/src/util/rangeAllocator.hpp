@@ -0,0 +1,74 @@
+#pragma once
+#ifndef VOX_UTIL_RANGE_ALLOCATOR_HPP
+#define VOX_UTIL_RANGE_ALLOCATOR_HPP
+
+#include <map>
+#include <vector>
+#include <cstddef>
+
+namespace vox {
+    namespace util {
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Hands out variable sized ranges of [0, capacity) without owning any
+    // memory, for carving up storage it can't touch directly such as a GPU
+    // buffer. Requests take the smallest free range that fits, and freed
+    // ranges merge with free neighbours. compact() plans moving every range
+    // to the front; the caller applies the moves to its storage.
+    ////////////////////////////////////////////////////////////////////////////
+    class RangeAllocator {
+    public:
+        struct Move {
+            size_t from;
+            size_t to;
+            size_t size;
+        };
+
+        //sizes and offsets are multiples of alignment
+        explicit RangeAllocator(size_t capacity = 0, size_t alignment = 1);
+
+        //false if no free range is big enough
+        bool allocate(size_t size, size_t& offset);
+        //offset must be a live range
+        void free(size_t offset);
+
+        //add free space at the end
+        void grow(size_t capacity);
+
+        //move every range to the front, keeping their order; afterwards all
+        //free space is one range at the end. The moves are returned in the
+        //order they must be applied; a move's target never overlaps a range
+        //not yet moved, but may overlap its own source.
+        std::vector<Move> compact();
+
+        size_t capacity()   const { return capacity_; }
+        size_t used()       const { return used_; }
+        size_t alignment()  const { return alignment_; }
+        size_t rangeCount() const { return ranges_.size(); }
+
+        //size of a live range, alignment included
+        size_t sizeOf(size_t offset) const;
+
+        //the biggest request that would succeed
+        size_t largestFree() const;
+        //free space not in the largest free range
+        size_t wasted() const { return capacity_ - used_ - largestFree(); }
+    private:
+        typedef std::map<size_t, size_t>      by_offset_t; //offset -> size
+        typedef std::multimap<size_t, size_t> by_size_t;   //size -> offset
+
+        void addFree_(size_t offset, size_t size);
+        void removeFree_(by_offset_t::iterator it);
+
+        size_t      capacity_;
+        size_t      alignment_;
+        size_t      used_;
+        by_offset_t ranges_;
+        by_offset_t free_;
+        by_size_t   freeBySize_;
+    };
+
+    } //namespace util
+} //namespace vox
+
+#endif //VOX_UTIL_RANGE_ALLOCATOR_HPP
@@ -0,0 +1,104 @@
+#include "common.hpp"
+#include "resolutionScaler.hpp"
+
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+
+namespace util = ::vox::util;
+
+namespace {
+    //weight of each new frame time in the smoothed time
+    float const SMOOTHING = 0.2f;
+
+    //scales are multiples of this
+    float const SCALE_STEP = 0.05f;
+
+    //the most the scale grows by in one change; shrinking isn't limited
+    float const MAX_GROWTH = 0.1f;
+
+    //grow only while under this fraction of the target, and then to about
+    //there, so the scale doesn't bounce across the target
+    float const HEADROOM = 0.8f;
+
+    //updates to wait after a change; timer results lag a few frames
+    unsigned const COOLDOWN = 8;
+
+    float quantize(float scale) {
+        return std::floor(scale / SCALE_STEP + 0.5f) * SCALE_STEP;
+    }
+} //namespace anon
+
+util::ResolutionScaler::ResolutionScaler(float targetMs, float minScale, float maxScale)
+    : target_(targetMs)
+    , min_(minScale)
+    , max_(maxScale)
+    , scale_(maxScale)
+    , smoothed_(0.0f)
+    , cooldown_(0)
+{
+    assert(targetMs > 0.0f);
+    assert(minScale > 0.0f && minScale <= maxScale);
+}
+
+void
+util::ResolutionScaler::setTarget(float const targetMs)
+{
+    assert(targetMs > 0.0f);
+    target_ = targetMs;
+}
+
+void
+util::ResolutionScaler::setBounds(float const minScale, float const maxScale)
+{
+    assert(minScale > 0.0f && minScale <= maxScale);
+
+    min_ = minScale;
+    max_ = maxScale;
+
+    float const scale = std::min(std::max(scale_, min_), max_);
+    if (scale != scale_) {
+        if (smoothed_ > 0.0f) {
+            smoothed_ *= (scale * scale) / (scale_ * scale_);
+        }
+
+        scale_ = scale;
+    }
+}
+
+float
+util::ResolutionScaler::update(float const gpuMs)
+{
+    smoothed_ = smoothed_ > 0.0f ? smoothed_ + (gpuMs - smoothed_) * SMOOTHING : gpuMs;
+
+    if (cooldown_ > 0) {
+        --cooldown_;
+        return scale_;
+    }
+
+    if (smoothed_ <= 0.0f) {
+        return scale_;
+    }
+
+    float desired = scale_;
+
+    if (smoothed_ > target_) {
+        //round down so one step is enough to get under the target
+        desired = std::floor(scale_ * std::sqrt(target_ / smoothed_) / SCALE_STEP) * SCALE_STEP;
+    } else if (smoothed_ < target_ * HEADROOM) {
+        desired = quantize(std::min(scale_ * std::sqrt(target_ * HEADROOM / smoothed_), scale_ + MAX_GROWTH));
+    }
+
+    desired = std::min(std::max(desired, min_), max_);
+
+    if (std::fabs(desired - scale_) < SCALE_STEP / 2) {
+        return scale_;
+    }
+
+    //the frames to come cost about as much more as they have pixels
+    smoothed_ *= (desired * desired) / (scale_ * scale_);
+    scale_     = desired;
+    cooldown_  = COOLDOWN;
+
+    return scale_;
+}
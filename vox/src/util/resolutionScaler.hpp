@@ -0,0 +1,47 @@
+#pragma once
+#ifndef VOX_UTIL_RESOLUTION_SCALER_HPP
+#define VOX_UTIL_RESOLUTION_SCALER_HPP
+
+namespace vox {
+    namespace util {
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Picks the scale to draw frames at so GPU frame time stays under a
+    // target. The cost of a frame is taken to grow with its pixel count, so
+    // a frame over budget by a factor f is scaled by 1/sqrt(f). Times are
+    // smoothed, the scale moves in fixed steps, it only grows again once
+    // there's clear headroom, and it's left alone for a few frames after each
+    // change while the measurements catch up, so it settles instead of
+    // resizing the target every frame.
+    ////////////////////////////////////////////////////////////////////////////
+    class ResolutionScaler {
+    public:
+        //scale starts at maxScale
+        explicit ResolutionScaler(float targetMs, float minScale = 0.5f, float maxScale = 1.0f);
+
+        void setTarget(float targetMs);
+        //the current scale is clamped to the new bounds
+        void setBounds(float minScale, float maxScale);
+
+        //GPU time of a frame drawn at scale(); returns the scale to use next
+        float update(float gpuMs);
+
+        float scale()    const { return scale_; }
+        float target()   const { return target_; }
+        float minScale() const { return min_; }
+        float maxScale() const { return max_; }
+        //smoothed frame time at the current scale, 0 before the first update
+        float smoothed() const { return smoothed_; }
+    private:
+        float    target_;
+        float    min_;
+        float    max_;
+        float    scale_;
+        float    smoothed_;
+        unsigned cooldown_; //updates left before the scale may change again
+    };
+
+    } //namespace util
+} //namespace vox
+
+#endif //VOX_UTIL_RESOLUTION_SCALER_HPP
@@ -0,0 +1,191 @@
+#include "common.hpp"
+#include "slabAllocator.hpp"
+
+namespace util = ::vox::util;
+
+namespace {
+    //per thread lookup from an allocator to its cache for the thread. Slots
+    //are direct mapped by allocator serial; two allocators sharing a slot
+    //only cost a locked search of the allocator's caches on a miss.
+    unsigned const CACHE_SLOTS = 64;
+
+    struct CacheSlot {
+        unsigned serial; //0 when empty
+        void*    cache;
+    };
+
+    VOX_THREAD_LOCAL CacheSlot cacheSlots[CACHE_SLOTS];
+
+    boost::mutex serialMutex;
+    unsigned     nextSerial = 1;
+
+    unsigned newSerial() {
+        boost::lock_guard<boost::mutex> lock(serialMutex);
+        return nextSerial++;
+    }
+} //namespace anon
+
+////////////////////////////////////////////////////////////////////////////////
+// SlabAllocator
+////////////////////////////////////////////////////////////////////////////////
+util::SlabAllocator::SlabAllocator(size_t blockSize, unsigned blocksPerSlab, unsigned cacheSize)
+    : blockSize_((std::max(blockSize, sizeof(Node)) + 15) & ~static_cast<size_t>(15))
+    , blocksPerSlab_(std::max(1u, blocksPerSlab))
+    , cacheSize_(std::max(2u, cacheSize))
+    , serial_(newSerial())
+    , free_(nullptr)
+{
+}
+
+util::SlabAllocator::~SlabAllocator()
+{
+    std::for_each(caches_.begin(), caches_.end(), [](Cache* c) { delete c; });
+    std::for_each(slabs_.begin(), slabs_.end(), [](void* s) { ::operator delete(s); });
+}
+
+unsigned
+util::SlabAllocator::slabCount() const
+{
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    return static_cast<unsigned>(slabs_.size());
+}
+
+util::SlabAllocator::Cache&
+util::SlabAllocator::localCache_()
+{
+    //serials aren't reused, so a slot left behind by a destroyed allocator
+    //never matches again
+    CacheSlot& slot = cacheSlots[serial_ % CACHE_SLOTS];
+    if (slot.serial == serial_) {
+        return *static_cast<Cache*>(slot.cache);
+    }
+
+    boost::thread::id const self = boost::this_thread::get_id();
+    Cache* cache = nullptr;
+
+    {//lock
+        boost::lock_guard<boost::mutex> lock(mutex_);
+
+        auto const it = std::find_if(caches_.begin(), caches_.end(), [&](Cache* c) {
+            return c->thread == self;
+        });
+
+        if (it != caches_.end()) {
+            cache = *it;
+        } else {
+            cache = new Cache();
+            cache->head   = nullptr;
+            cache->count  = 0;
+            cache->thread = self;
+
+            caches_.push_back(cache);
+        }
+    }//unlock
+
+    slot.serial = serial_;
+    slot.cache  = cache;
+
+    return *cache;
+}
+
+void
+util::SlabAllocator::refill_(Cache& cache)
+{
+    boost::lock_guard<boost::mutex> lock(mutex_);
+
+    for (unsigned i = 0; i < cacheSize_ / 2; ++i) {
+        if (!free_) {
+            newSlab_();
+        }
+
+        Node* const node = free_;
+        free_ = node->next;
+
+        node->next = cache.head;
+        cache.head = node;
+        ++cache.count;
+    }
+}
+
+void
+util::SlabAllocator::drain_(Cache& cache, unsigned const keep)
+{
+    boost::lock_guard<boost::mutex> lock(mutex_);
+
+    while (cache.count > keep) {
+        Node* const node = cache.head;
+        cache.head = node->next;
+        --cache.count;
+
+        node->next = free_;
+        free_ = node;
+    }
+}
+
+void
+util::SlabAllocator::newSlab_()
+{
+    char* const slab = static_cast<char*>(::operator new(blockSize_ * blocksPerSlab_));
+    slabs_.push_back(slab);
+
+    //hand out the slab front to back
+    for (unsigned i = blocksPerSlab_; i-- > 0; ) {
+        Node* const node = reinterpret_cast<Node*>(slab + i * blockSize_);
+        node->next = free_;
+        free_ = node;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// SizeClassPool
+////////////////////////////////////////////////////////////////////////////////
+util::SizeClassPool::SizeClassPool(size_t minSize, size_t maxSize, size_t slabBytes)
+    : minSize_(minSize)
+{
+    for (size_t size = minSize; size <= maxSize; size *= 2) {
+        unsigned const blocks = static_cast<unsigned>(std::max<size_t>(1, slabBytes / size));
+
+        //big classes move fewer blocks between a thread and the shared list
+        unsigned const cache = std::max(2u, std::min(8u, blocks));
+
+        classes_.push_back(std::unique_ptr<SlabAllocator>(new SlabAllocator(size, blocks, cache)));
+    }
+}
+
+int
+util::SizeClassPool::classOf_(size_t size) const
+{
+    size_t classSize = minSize_;
+    for (int i = 0; i < static_cast<int>(classes_.size()); ++i, classSize *= 2) {
+        if (size <= classSize) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+size_t
+util::SizeClassPool::classSize(size_t size) const
+{
+    int const i = classOf_(size);
+    return i < 0 ? 0 : classes_[i]->blockSize();
+}
+
+void*
+util::SizeClassPool::allocate(size_t size)
+{
+    int const i = classOf_(size);
+    return i < 0 ? ::operator new(size) : classes_[i]->allocate();
+}
+
+void
+util::SizeClassPool::deallocate(void* p, size_t size)
+{
+    int const i = classOf_(size);
+    if (i < 0) {
+        ::operator delete(p);
+    } else {
+        classes_[i]->deallocate(p);
+    }
+}
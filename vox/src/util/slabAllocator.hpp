@@ -0,0 +1,177 @@
+#pragma once
+#ifndef VOX_UTIL_SLAB_ALLOCATOR_HPP
+#define VOX_UTIL_SLAB_ALLOCATOR_HPP
+
+#include <vector>
+#include <memory>
+#include <limits>
+#include <cstddef>
+
+#include <boost/thread.hpp>
+
+namespace vox {
+    namespace util {
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Fixed size blocks carved out of larger slabs. Freed blocks go on a free
+    // list and are handed out again; slabs are only returned to the system
+    // when the allocator is destroyed, so a steady churn of allocations
+    // neither fragments the heap nor touches malloc.
+    //
+    // Each thread allocates from and frees to its own small cache and only
+    // takes the shared lock to move half a cache's worth of blocks at a time.
+    // A thread's cache lives as long as the allocator; blocks left in the
+    // cache of a thread that exited are not reused before then.
+    ////////////////////////////////////////////////////////////////////////////
+    class SlabAllocator : private boost::noncopyable {
+    public:
+        //blocks of at least blockSize bytes, 16 byte aligned when the system
+        //allocator is; cacheSize blocks per thread at most
+        explicit SlabAllocator(size_t blockSize, unsigned blocksPerSlab = 16, unsigned cacheSize = 8);
+        ~SlabAllocator();
+
+        size_t blockSize() const { return blockSize_; }
+
+        void* allocate() {
+            Cache& cache = localCache_();
+            if (!cache.head) {
+                refill_(cache);
+            }
+
+            Node* const node = cache.head;
+            cache.head = node->next;
+            --cache.count;
+
+            return node;
+        }
+
+        void deallocate(void* block) {
+            if (!block) {
+                return;
+            }
+
+            Cache& cache = localCache_();
+
+            Node* const node = static_cast<Node*>(block);
+            node->next = cache.head;
+            cache.head = node;
+
+            if (++cache.count > cacheSize_) {
+                drain_(cache, cacheSize_ / 2);
+            }
+        }
+
+        //slabs allocated so far
+        unsigned slabCount() const;
+    private:
+        struct Node {
+            Node* next;
+        };
+
+        struct Cache {
+            Node*              head;
+            unsigned           count;
+            boost::thread::id  thread;
+        };
+
+        Cache& localCache_();
+        void   refill_(Cache& cache);
+        void   drain_(Cache& cache, unsigned keep);
+        void   newSlab_();
+
+        size_t const   blockSize_;
+        unsigned const blocksPerSlab_;
+        unsigned const cacheSize_;
+        unsigned const serial_; //never reused, identifies this in the per thread lookup
+
+        mutable boost::mutex mutex_;
+        Node*                free_;
+        std::vector<void*>   slabs_;
+        std::vector<Cache*>  caches_;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Variable sized allocations rounded up to a power of two size class,
+    // each class served by its own SlabAllocator. Requests larger than the
+    // biggest class go to the system allocator.
+    ////////////////////////////////////////////////////////////////////////////
+    class SizeClassPool : private boost::noncopyable {
+    public:
+        //classes of minSize, 2*minSize, ... maxSize bytes; each class gets
+        //slabs of about slabBytes
+        explicit SizeClassPool(
+            size_t minSize   = 256,
+            size_t maxSize   = 1024 * 1024,
+            size_t slabBytes = 1024 * 1024
+        );
+
+        void* allocate(size_t size);
+        //size must be what was passed to allocate
+        void deallocate(void* p, size_t size);
+
+        //size of the block a request of size is served with; 0 for requests
+        //that go to the system allocator
+        size_t classSize(size_t size) const;
+    private:
+        int classOf_(size_t size) const;
+
+        size_t const                                 minSize_;
+        std::vector<std::unique_ptr<SlabAllocator>>  classes_;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Standard allocator over the SizeClassPool returned by pool_t::get(), so
+    // containers stay stateless and any two of them compare equal.
+    ////////////////////////////////////////////////////////////////////////////
+    template <typename T, typename pool_t>
+    class PoolAllocator {
+    public:
+        typedef T              value_type;
+        typedef T*             pointer;
+        typedef T const*       const_pointer;
+        typedef T&             reference;
+        typedef T const&       const_reference;
+        typedef size_t         size_type;
+        typedef std::ptrdiff_t difference_type;
+
+        template <typename U>
+        struct rebind {
+            typedef PoolAllocator<U, pool_t> other;
+        };
+
+        PoolAllocator() {}
+
+        template <typename U>
+        PoolAllocator(PoolAllocator<U, pool_t> const&) {}
+
+        pointer       address(reference x)       const { return &x; }
+        const_pointer address(const_reference x) const { return &x; }
+
+        pointer allocate(size_type n, void const* = nullptr) {
+            return static_cast<pointer>(pool_t::get().allocate(n * sizeof(T)));
+        }
+
+        void deallocate(pointer p, size_type n) {
+            pool_t::get().deallocate(p, n * sizeof(T));
+        }
+
+        size_type max_size() const {
+            return std::numeric_limits<size_type>::max() / sizeof(T);
+        }
+
+        void construct(pointer p, T const& value) {
+            ::new (static_cast<void*>(p)) T(value);
+        }
+
+        void destroy(pointer p) {
+            p->~T();
+        }
+
+        bool operator==(PoolAllocator const&) const { return true; }
+        bool operator!=(PoolAllocator const&) const { return false; }
+    };
+
+    } //namespace util
+} //namespace vox
+
+#endif //VOX_UTIL_SLAB_ALLOCATOR_HPP
@@ -0,0 +1,248 @@
+#include "common.hpp"
+#include <cstdlib>
+#include <boost/test/unit_test.hpp>
+#include <boost/chrono.hpp>
+
+#include "../slabAllocator.hpp"
+
+namespace util = ::vox::util;
+
+namespace {
+    double secondsSince(boost::chrono::steady_clock::time_point start) {
+        return boost::chrono::duration<double>(boost::chrono::steady_clock::now() - start).count();
+    }
+
+    unsigned nextRandom(unsigned& state) {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    }
+
+    struct TestPool {
+        static util::SizeClassPool& get() {
+            static util::SizeClassPool pool(64, 4096, 64 * 1024);
+            return pool;
+        }
+    };
+
+    //each thread keeps live allocations and keeps replacing a random one,
+    //touching every block it gets; returns allocations per second
+    template <typename alloc_t, typename free_t, typename size_t_fn>
+    double churn(
+        unsigned threads, unsigned live, unsigned iterations,
+        alloc_t alloc, free_t free, size_t_fn sizeOf
+    ) {
+        boost::barrier start(threads + 1);
+        boost::thread_group group;
+
+        for (unsigned t = 0; t < threads; ++t) {
+            group.create_thread([=, &start] {
+                unsigned state = t + 1;
+                std::vector<std::pair<void*, size_t>> blocks(live, std::make_pair(static_cast<void*>(nullptr), size_t(0)));
+
+                start.wait();
+
+                for (unsigned i = 0; i < iterations; ++i) {
+                    auto& block = blocks[nextRandom(state) % live];
+                    free(block.first, block.second);
+
+                    block.second = sizeOf(state);
+                    block.first  = alloc(block.second);
+                    static_cast<char*>(block.first)[0] = static_cast<char>(i);
+                }
+
+                std::for_each(blocks.begin(), blocks.end(), [&](std::pair<void*, size_t> const& b) {
+                    free(b.first, b.second);
+                });
+            });
+        }
+
+        auto const begin = boost::chrono::steady_clock::now();
+        start.wait();
+        group.join_all();
+
+        return threads * iterations / secondsSince(begin);
+    }
+} //namespace anon
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(SlabAllocatorReuse)
+{
+    util::SlabAllocator slab(100, 4, 4);
+
+    BOOST_CHECK_EQUAL(slab.blockSize(), 112u);
+    BOOST_CHECK_EQUAL(slab.slabCount(), 0u);
+
+    void* const a = slab.allocate();
+    void* const b = slab.allocate();
+    BOOST_CHECK(a != b);
+    BOOST_CHECK_EQUAL(slab.slabCount(), 1u);
+
+    //freed blocks are handed out again before anything new
+    slab.deallocate(a);
+    BOOST_CHECK_EQUAL(slab.allocate(), a);
+
+    std::vector<void*> blocks;
+    for (unsigned i = 0; i < 16; ++i) {
+        blocks.push_back(slab.allocate());
+    }
+
+    std::sort(blocks.begin(), blocks.end());
+    BOOST_CHECK(std::unique(blocks.begin(), blocks.end()) == blocks.end());
+    BOOST_CHECK_EQUAL(slab.slabCount(), 5u);
+
+    std::for_each(blocks.begin(), blocks.end(), [&](void* p) { slab.deallocate(p); });
+    slab.deallocate(b);
+    slab.deallocate(nullptr);
+
+    for (unsigned i = 0; i < 17; ++i) {
+        slab.allocate();
+    }
+
+    BOOST_CHECK_EQUAL(slab.slabCount(), 5u);
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(SlabAllocatorThreads)
+{
+    unsigned const THREADS = 4;
+    unsigned const BLOCKS  = 200;
+
+    util::SlabAllocator slab(256, 16, 8);
+    boost::mutex        mutex;
+    std::vector<void*>  handoff; //allocated on one thread, freed on another
+    bool                ok = true;
+
+    boost::thread_group group;
+    for (unsigned t = 0; t < THREADS; ++t) {
+        group.create_thread([&, t] {
+            std::vector<unsigned char*> mine;
+
+            for (unsigned round = 0; round < 20; ++round) {
+                for (unsigned i = 0; i < BLOCKS; ++i) {
+                    unsigned char* const p = static_cast<unsigned char*>(slab.allocate());
+                    std::fill(p, p + 256, static_cast<unsigned char>(t));
+                    mine.push_back(p);
+                }
+
+                //nobody else may have written to a block this thread owns
+                for (size_t i = 0; i < mine.size(); ++i) {
+                    if (std::count(mine[i], mine[i] + 256, static_cast<unsigned char>(t)) != 256) {
+                        boost::lock_guard<boost::mutex> lock(mutex);
+                        ok = false;
+                    }
+                }
+
+                {//lock
+                    boost::lock_guard<boost::mutex> lock(mutex);
+                    std::for_each(handoff.begin(), handoff.end(), [&](void* p) { slab.deallocate(p); });
+                    handoff.assign(mine.begin(), mine.begin() + BLOCKS / 2);
+                }//unlock
+
+                std::for_each(mine.begin() + BLOCKS / 2, mine.end(), [&](unsigned char* p) { slab.deallocate(p); });
+                mine.clear();
+            }
+        });
+    }
+
+    group.join_all();
+    std::for_each(handoff.begin(), handoff.end(), [&](void* p) { slab.deallocate(p); });
+
+    BOOST_CHECK(ok);
+
+    //at most every thread's blocks plus the handoff live at once
+    BOOST_CHECK(slab.slabCount() * 16 <= THREADS * BLOCKS + BLOCKS / 2 + THREADS * 16);
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(SizeClassPoolClasses)
+{
+    util::SizeClassPool pool(64, 4096, 64 * 1024);
+
+    BOOST_CHECK_EQUAL(pool.classSize(1),    64u);
+    BOOST_CHECK_EQUAL(pool.classSize(64),   64u);
+    BOOST_CHECK_EQUAL(pool.classSize(65),   128u);
+    BOOST_CHECK_EQUAL(pool.classSize(4096), 4096u);
+    BOOST_CHECK_EQUAL(pool.classSize(4097), 0u);
+
+    void* const small = pool.allocate(100);
+    void* const large = pool.allocate(10000);
+    std::memset(small, 1, 100);
+    std::memset(large, 2, 10000);
+
+    pool.deallocate(small, 100);
+    pool.deallocate(large, 10000);
+
+    //the same class reuses the freed block
+    BOOST_CHECK_EQUAL(pool.allocate(120), small);
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(PoolAllocatorVector)
+{
+    std::vector<int, util::PoolAllocator<int, TestPool>> values;
+    for (int i = 0; i < 10000; ++i) {
+        values.push_back(i);
+    }
+
+    BOOST_CHECK_EQUAL(values.size(), 10000u);
+    BOOST_CHECK_EQUAL(values[1234], 1234);
+
+    std::vector<int, util::PoolAllocator<int, TestPool>> copy(values);
+    BOOST_CHECK(copy == values);
+
+    values.clear();
+    values.shrink_to_fit();
+    BOOST_CHECK_EQUAL(copy.back(), 9999);
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(AllocatorChurnTiming)
+{
+    unsigned const THREADS    = 4;
+    unsigned const LIVE       = 64;
+    unsigned const ITERATIONS = 200000;
+    size_t const   CHUNK      = 64 * 1024;
+
+    //fixed size chunk data
+    {
+        util::SlabAllocator slab(CHUNK, 16);
+
+        double const slabRate = churn(THREADS, LIVE, ITERATIONS,
+            [&](size_t)          { return slab.allocate(); },
+            [&](void* p, size_t) { slab.deallocate(p); },
+            [](unsigned&)        { return CHUNK; }
+        );
+
+        double const newRate = churn(THREADS, LIVE, ITERATIONS,
+            [](size_t size)      { return ::operator new(size); },
+            [](void* p, size_t)  { ::operator delete(p); },
+            [](unsigned&)        { return CHUNK; }
+        );
+
+        BOOST_MESSAGE(boost::format("chunk churn, %u threads: slab %.0f allocs/sec, new %.0f allocs/sec")
+            % THREADS % slabRate % newRate);
+    }
+
+    //mesh sized buffers from 2KB to 256KB
+    {
+        util::SizeClassPool pool(2 * 1024, 1024 * 1024);
+        auto const meshSize = [](unsigned& state) -> size_t {
+            return 2 * 1024 + nextRandom(state) % (254 * 1024);
+        };
+
+        double const poolRate = churn(THREADS, LIVE, ITERATIONS,
+            [&](size_t size)          { return pool.allocate(size); },
+            [&](void* p, size_t size) { if (p) pool.deallocate(p, size); },
+            meshSize
+        );
+
+        double const mallocRate = churn(THREADS, LIVE, ITERATIONS,
+            [](size_t size)           { return std::malloc(size); },
+            [](void* p, size_t)       { std::free(p); },
+            meshSize
+        );
+
+        BOOST_MESSAGE(boost::format("mesh churn, %u threads: size class pool %.0f allocs/sec, malloc %.0f allocs/sec")
+            % THREADS % poolRate % mallocRate);
+    }
+}
@@ -0,0 +1,60 @@
+#include "common.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include "../frameArena.hpp"
+
+namespace util = ::vox::util;
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(LinearArenaBasics)
+{
+    util::LinearArena arena(1024);
+
+    BOOST_CHECK_EQUAL(arena.capacity(), 0u);
+
+    char* const a = static_cast<char*>(arena.allocate(10, 1));
+    char* const b = static_cast<char*>(arena.allocate(8, 16));
+    BOOST_CHECK(b >= a + 10);
+    BOOST_CHECK_EQUAL(reinterpret_cast<size_t>(b) % 16, 0u);
+    BOOST_CHECK_EQUAL(arena.heapAllocations(), 1u);
+
+    //overflow into a second block, including one bigger than a block
+    arena.allocate(1000);
+    arena.allocate(5000);
+    BOOST_CHECK_EQUAL(arena.heapAllocations(), 3u);
+    BOOST_CHECK(arena.used() >= 6018u);
+
+    //reset merges the blocks so the same frame fits in one
+    arena.reset();
+    BOOST_CHECK_EQUAL(arena.used(), 0u);
+    BOOST_CHECK_EQUAL(arena.heapAllocations(), 4u);
+
+    void* const c = arena.allocate(10, 1);
+    arena.allocate(8, 16);
+    arena.allocate(1000);
+    arena.allocate(5000);
+    BOOST_CHECK_EQUAL(arena.heapAllocations(), 4u);
+
+    //the first allocation after a reset reuses the start of the block
+    arena.reset();
+    BOOST_CHECK_EQUAL(arena.allocate(10, 1), c);
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(FrameArenaRotation)
+{
+    util::FrameArena frames(3, 1024);
+    BOOST_CHECK_EQUAL(frames.frames(), 3u);
+
+    int* const first = static_cast<int*>(frames.beginFrame().allocate(sizeof(int)));
+    *first = 42;
+
+    //the two frames after it use other arenas
+    frames.beginFrame().allocate(sizeof(int));
+    frames.beginFrame().allocate(sizeof(int));
+    BOOST_CHECK_EQUAL(*first, 42);
+
+    //and the one after that reuses its memory
+    BOOST_CHECK_EQUAL(frames.beginFrame().allocate(sizeof(int)), first);
+    BOOST_CHECK_EQUAL(frames.heapAllocations(), 3u);
+}
@@ -0,0 +1,70 @@
+#include "common.hpp"
+#include <boost/test/unit_test.hpp>
+#include <boost/chrono.hpp>
+
+#include "../framePacer.hpp"
+
+namespace util = ::vox::util;
+
+namespace {
+    typedef boost::chrono::steady_clock steady_clock;
+
+    double msSince(steady_clock::time_point const start) {
+        return boost::chrono::duration<double, boost::milli>(steady_clock::now() - start).count();
+    }
+
+    //ms taken by frames frames of work ms each
+    double runFrames(util::FramePacer& pacer, unsigned frames, unsigned workMs) {
+        pacer.beginFrame();
+        pacer.endFrame();
+
+        auto const start = steady_clock::now();
+
+        for (unsigned i = 0; i < frames; ++i) {
+            pacer.beginFrame();
+            boost::this_thread::sleep_for(boost::chrono::milliseconds(workMs));
+            pacer.endFrame();
+        }
+
+        return msSince(start);
+    }
+} //namespace anon
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(FramePacerLimitsRate)
+{
+    util::FramePacer pacer(100.0f);
+
+    //the first frame is free; the next 20 take 10ms each. Loose bounds since
+    //the machine running this may be busy
+    double const ms = runFrames(pacer, 20, 2);
+    BOOST_CHECK_GE(ms, 190.0);
+    BOOST_CHECK_LE(ms, 300.0);
+
+    BOOST_CHECK_GE(pacer.predicted(), 2.0);
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(FramePacerUnlimited)
+{
+    util::FramePacer pacer;
+
+    double const ms = runFrames(pacer, 20, 0);
+    BOOST_CHECK_LT(ms, 100.0);
+    BOOST_CHECK_EQUAL(pacer.waited(), 0.0);
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(FramePacerLowLatency)
+{
+    util::FramePacer pacer(50.0f);
+    pacer.setLowLatency(true);
+
+    //still 20ms a frame, but each starts late in its 20ms instead of at the
+    //beginning, so most of the wait comes before the work, not after
+    double const ms = runFrames(pacer, 10, 5);
+    BOOST_CHECK_GE(ms, 190.0);
+    BOOST_CHECK_LE(ms, 300.0);
+
+    BOOST_CHECK_GE(pacer.waited(), 10.0);
+}
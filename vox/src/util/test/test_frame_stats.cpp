@@ -0,0 +1,68 @@
+#include "common.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include "../frameStats.hpp"
+
+namespace util = ::vox::util;
+
+namespace {
+    util::FrameStats::Sample sampleOf(double interval) {
+        util::FrameStats::Sample const sample = {{ interval, interval / 2.0, 0.5, 1.0 }};
+        return sample;
+    }
+} //namespace anon
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(FrameStatsPercentiles)
+{
+    util::FrameStats stats(100);
+
+    auto const empty = stats.summary(util::FrameStats::SERIES_INTERVAL);
+    BOOST_CHECK_EQUAL(empty.count, 0u);
+    BOOST_CHECK_EQUAL(empty.max, 0.0);
+
+    //recorded out of order; 1..100
+    for (unsigned i = 0; i < 100; ++i) {
+        stats.record(sampleOf(static_cast<double>((i * 37) % 100 + 1)));
+    }
+
+    auto const s = stats.summary(util::FrameStats::SERIES_INTERVAL);
+    BOOST_CHECK_EQUAL(s.count, 100u);
+    BOOST_CHECK_CLOSE(s.min,  1.0,   0.001);
+    BOOST_CHECK_CLOSE(s.mean, 50.5,  0.001);
+    BOOST_CHECK_CLOSE(s.p50,  50.0,  0.001);
+    BOOST_CHECK_CLOSE(s.p95,  95.0,  0.001);
+    BOOST_CHECK_CLOSE(s.p99,  99.0,  0.001);
+    BOOST_CHECK_CLOSE(s.max,  100.0, 0.001);
+
+    auto const cpu = stats.summary(util::FrameStats::SERIES_CPU);
+    BOOST_CHECK_CLOSE(cpu.max, 50.0, 0.001);
+
+    BOOST_CHECK(stats.report().find("interval") != std::string::npos);
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(FrameStatsRolling)
+{
+    util::FrameStats stats(10);
+
+    for (unsigned i = 1; i <= 25; ++i) {
+        stats.record(sampleOf(static_cast<double>(i)));
+    }
+
+    //only the last 10 frames are kept
+    auto const s = stats.summary(util::FrameStats::SERIES_INTERVAL);
+    BOOST_CHECK_EQUAL(s.count, 10u);
+    BOOST_CHECK_CLOSE(s.min, 16.0, 0.001);
+    BOOST_CHECK_CLOSE(s.max, 25.0, 0.001);
+
+    //a single hitch shows in the tail but barely moves the median
+    stats.record(sampleOf(200.0));
+
+    auto const hitch = stats.summary(util::FrameStats::SERIES_INTERVAL);
+    BOOST_CHECK_CLOSE(hitch.p99, 200.0, 0.001);
+    BOOST_CHECK_LT(hitch.p50, 25.0);
+
+    stats.clear();
+    BOOST_CHECK_EQUAL(stats.count(), 0u);
+}
@@ -0,0 +1,150 @@
+#include "common.hpp"
+#include <sstream>
+#include <boost/test/unit_test.hpp>
+#include <boost/chrono.hpp>
+
+#include "../profiler.hpp"
+#include "../timings.hpp"
+
+namespace util = ::vox::util;
+
+namespace {
+    unsigned countOf(util::Timings const& timings, std::string const& name) {
+        auto const entries = timings.entries();
+        for (auto it = entries.begin(); it != entries.end(); ++it) {
+            if (it->name == name) {
+                return it->count;
+            }
+        }
+
+        return 0;
+    }
+} //namespace anon
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(ProfilerFromThreads)
+{
+    util::Profiler::clear();
+
+    unsigned const THREADS = 4;
+    unsigned const SCOPES  = 10000; //spans several chunks per thread
+
+    boost::thread_group threads;
+    for (unsigned i = 0; i < THREADS; ++i) {
+        threads.create_thread([] {
+            VOX_PROFILE_THREAD("test worker");
+
+            for (unsigned j = 0; j < SCOPES; ++j) {
+                VOX_PROFILE_SCOPE("test/work");
+            }
+        });
+    }
+
+    threads.join_all();
+
+    util::Timings timings;
+    util::Profiler::summarize(timings);
+    BOOST_CHECK_EQUAL(countOf(timings, "cpu/test/work"), THREADS * SCOPES);
+
+    std::ostringstream trace;
+    util::Profiler::exportChromeTrace(trace);
+
+    std::string const json = trace.str();
+    BOOST_CHECK(json.find("\"traceEvents\"") != std::string::npos);
+    BOOST_CHECK(json.find("\"name\":\"test/work\",\"ph\":\"X\"") != std::string::npos);
+    BOOST_CHECK(json.find("\"name\":\"test worker\"") != std::string::npos);
+
+    //cleared events are gone, even from chunks still being written
+    util::Profiler::clear();
+
+    util::Timings cleared;
+    util::Profiler::summarize(cleared);
+    BOOST_CHECK_EQUAL(countOf(cleared, "cpu/test/work"), 0u);
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(ProfilerNesting)
+{
+    util::Profiler::clear();
+
+    {
+        VOX_PROFILE_SCOPE("test/outer");
+        boost::this_thread::sleep_for(boost::chrono::milliseconds(2));
+        {
+            VOX_PROFILE_SCOPE("test/inner");
+        }
+    }
+
+    util::Timings timings;
+    util::Profiler::summarize(timings);
+
+    auto const entries = timings.entries();
+    BOOST_REQUIRE_EQUAL(entries.size(), 2u);
+    BOOST_CHECK_EQUAL(entries[0].name, "cpu/test/inner");
+    BOOST_CHECK_EQUAL(entries[1].name, "cpu/test/outer");
+    BOOST_CHECK_GE(entries[1].total, 1.5);
+    BOOST_CHECK_LT(entries[0].total, entries[1].total);
+
+    util::Profiler::clear();
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(ProfilerDisabled)
+{
+    util::Profiler::clear();
+    util::Profiler::setEnabled(false);
+
+    {
+        VOX_PROFILE_SCOPE("test/disabled");
+    }
+
+    util::Profiler::setEnabled(true);
+
+    util::Timings timings;
+    util::Profiler::summarize(timings);
+    BOOST_CHECK_EQUAL(countOf(timings, "cpu/test/disabled"), 0u);
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(ProfilerKeepsRecent)
+{
+    util::Profiler::clear();
+    util::Profiler::setMaxChunks(2);
+
+    unsigned const SCOPES = util::PROFILE_CHUNK_EVENTS * 5;
+    for (unsigned i = 0; i < SCOPES; ++i) {
+        VOX_PROFILE_SCOPE("test/recent");
+    }
+
+    util::Timings timings;
+    util::Profiler::summarize(timings);
+
+    unsigned const kept = countOf(timings, "cpu/test/recent");
+    BOOST_CHECK_GT(kept, 0u);
+    BOOST_CHECK_LE(kept, util::PROFILE_CHUNK_EVENTS * 2);
+
+    util::Profiler::setMaxChunks(64);
+    util::Profiler::clear();
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(ProfilerOverhead)
+{
+    util::Profiler::clear();
+
+    unsigned const SCOPES = 1000000;
+
+    auto const begin = boost::chrono::steady_clock::now();
+    for (unsigned i = 0; i < SCOPES; ++i) {
+        VOX_PROFILE_SCOPE("test/overhead");
+    }
+    auto const elapsed = boost::chrono::steady_clock::now() - begin;
+
+    double const ns = boost::chrono::duration<double, boost::nano>(elapsed).count() / SCOPES;
+    BOOST_MESSAGE("profile scope: " << ns << "ns");
+
+    //the target is ~20ns; this only catches something badly wrong
+    BOOST_CHECK_LT(ns, 500.0);
+
+    util::Profiler::clear();
+}
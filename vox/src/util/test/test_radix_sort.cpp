@@ -0,0 +1,86 @@
+#include "common.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include "../radixSort.hpp"
+
+namespace util = ::vox::util;
+
+namespace {
+    struct Item {
+        unsigned long long key;
+        unsigned           order; //position before sorting
+    };
+
+    unsigned long long keyOf(Item const& item) { return item.key; }
+
+    unsigned nextRandom(unsigned& state) {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    }
+} //namespace anon
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(RadixSortStable)
+{
+    std::vector<Item> items;
+    std::vector<Item> scratch;
+
+    unsigned state = 1;
+    for (unsigned i = 0; i < 5000; ++i) {
+        //few distinct keys, spread over high and low bytes, so there are ties
+        unsigned long long const high = nextRandom(state) % 4;
+        unsigned long long const low  = nextRandom(state) % 50;
+
+        Item const item = { (high << 56) | (low << 8), i };
+        items.push_back(item);
+    }
+
+    std::vector<Item> expected(items);
+    std::stable_sort(expected.begin(), expected.end(), [](Item const& a, Item const& b) {
+        return a.key < b.key;
+    });
+
+    util::radixSort(items, scratch, &keyOf);
+
+    bool same = true;
+    for (unsigned i = 0; i < items.size(); ++i) {
+        same = same && items[i].key == expected[i].key && items[i].order == expected[i].order;
+    }
+
+    BOOST_CHECK(same);
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(RadixSortTrivial)
+{
+    std::vector<Item> items;
+    std::vector<Item> scratch;
+
+    util::radixSort(items, scratch, &keyOf);
+    BOOST_CHECK(items.empty());
+
+    //all equal: nothing moves
+    for (unsigned i = 0; i < 10; ++i) {
+        Item const item = { 42, i };
+        items.push_back(item);
+    }
+
+    util::radixSort(items, scratch, &keyOf);
+
+    for (unsigned i = 0; i < items.size(); ++i) {
+        BOOST_CHECK_EQUAL(items[i].order, i);
+    }
+
+    //an odd number of passes ends in scratch and is copied back
+    items.clear();
+    for (unsigned i = 0; i < 10; ++i) {
+        Item const item = { 9 - i, i };
+        items.push_back(item);
+    }
+
+    util::radixSort(items, scratch, &keyOf);
+
+    for (unsigned i = 0; i < items.size(); ++i) {
+        BOOST_CHECK_EQUAL(items[i].key, i);
+    }
+}
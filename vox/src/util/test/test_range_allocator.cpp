@@ -0,0 +1,146 @@
+#include "common.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include "../rangeAllocator.hpp"
+
+namespace util = ::vox::util;
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(RangeAllocatorBestFit)
+{
+    util::RangeAllocator ranges(1000, 8);
+
+    size_t a, b, c, d;
+    BOOST_REQUIRE(ranges.allocate(100, a));
+    BOOST_REQUIRE(ranges.allocate(10,  b));
+    BOOST_REQUIRE(ranges.allocate(300, c));
+    BOOST_REQUIRE(ranges.allocate(50,  d));
+
+    BOOST_CHECK_EQUAL(a, 0u);
+    BOOST_CHECK_EQUAL(b, 104u);
+    BOOST_CHECK_EQUAL(ranges.sizeOf(b), 16u);
+    BOOST_CHECK_EQUAL(ranges.used(), 104u + 16u + 304u + 56u);
+
+    //holes of 104 and 304; a request of 90 takes the smaller one
+    ranges.free(a);
+    ranges.free(c);
+
+    size_t e;
+    BOOST_REQUIRE(ranges.allocate(90, e));
+    BOOST_CHECK_EQUAL(e, 0u);
+
+    //nothing left is big enough
+    size_t f;
+    BOOST_CHECK(!ranges.allocate(600, f));
+    BOOST_CHECK_EQUAL(ranges.largestFree(), 1000u - 480u);
+
+    ranges.grow(2000);
+    BOOST_REQUIRE(ranges.allocate(600, f));
+    BOOST_CHECK_EQUAL(f, 480u);
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(RangeAllocatorCoalesce)
+{
+    util::RangeAllocator ranges(400);
+
+    size_t r[4];
+    for (int i = 0; i < 4; ++i) {
+        BOOST_REQUIRE(ranges.allocate(100, r[i]));
+    }
+
+    size_t x;
+    BOOST_CHECK(!ranges.allocate(1, x));
+
+    //freeing 1 and 2 in either order leaves one 200 range
+    ranges.free(r[2]);
+    ranges.free(r[1]);
+    BOOST_CHECK_EQUAL(ranges.largestFree(), 200u);
+    BOOST_CHECK_EQUAL(ranges.wasted(), 0u);
+
+    ranges.free(r[0]);
+    ranges.free(r[3]);
+    BOOST_CHECK_EQUAL(ranges.largestFree(), 400u);
+    BOOST_CHECK_EQUAL(ranges.rangeCount(), 0u);
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(RangeAllocatorCompact)
+{
+    util::RangeAllocator ranges(1000, 4);
+
+    std::vector<size_t> offsets(10);
+    for (size_t i = 0; i < offsets.size(); ++i) {
+        BOOST_REQUIRE(ranges.allocate(100, offsets[i]));
+    }
+
+    //every other range goes
+    for (size_t i = 0; i < offsets.size(); i += 2) {
+        ranges.free(offsets[i]);
+    }
+
+    BOOST_CHECK_EQUAL(ranges.largestFree(), 100u);
+    BOOST_CHECK_EQUAL(ranges.wasted(), 400u);
+
+    //apply the moves to a copy of the storage
+    std::vector<int> storage(1000, -1);
+    for (size_t i = 1; i < offsets.size(); i += 2) {
+        std::fill(storage.begin() + offsets[i], storage.begin() + offsets[i] + 100, static_cast<int>(i));
+    }
+
+    auto const moves = ranges.compact();
+    BOOST_CHECK_EQUAL(moves.size(), 5u);
+
+    for (auto it = moves.begin(); it != moves.end(); ++it) {
+        BOOST_CHECK(it->to < it->from);
+        std::copy(storage.begin() + it->from, storage.begin() + it->from + it->size, storage.begin() + it->to);
+    }
+
+    for (int i = 0; i < 5; ++i) {
+        BOOST_CHECK_EQUAL(storage[i * 100],      2 * i + 1);
+        BOOST_CHECK_EQUAL(storage[i * 100 + 99], 2 * i + 1);
+        BOOST_CHECK_EQUAL(ranges.sizeOf(i * 100), 100u);
+    }
+
+    BOOST_CHECK_EQUAL(ranges.largestFree(), 500u);
+    BOOST_CHECK_EQUAL(ranges.wasted(), 0u);
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(RangeAllocatorChurn)
+{
+    util::RangeAllocator ranges(1 << 20, 8);
+
+    std::vector<size_t> live;
+    unsigned state = 1;
+
+    for (unsigned i = 0; i < 20000; ++i) {
+        state = state * 1664525u + 1013904223u;
+
+        if (!live.empty() && (state >> 28) < 7) {
+            size_t const j = (state >> 8) % live.size();
+            ranges.free(live[j]);
+            live[j] = live.back();
+            live.pop_back();
+        } else {
+            size_t offset;
+            if (ranges.allocate(64 + (state >> 16) % 4096, offset)) {
+                live.push_back(offset);
+            }
+        }
+    }
+
+    //live ranges never overlap and the totals agree
+    std::sort(live.begin(), live.end());
+
+    size_t total = 0;
+    for (size_t i = 0; i < live.size(); ++i) {
+        total += ranges.sizeOf(live[i]);
+        if (i + 1 < live.size()) {
+            BOOST_CHECK(live[i] + ranges.sizeOf(live[i]) <= live[i + 1]);
+        }
+    }
+
+    BOOST_CHECK_EQUAL(total, ranges.used());
+    BOOST_CHECK_EQUAL(ranges.rangeCount(), live.size());
+}
@@ -0,0 +1,71 @@
+#include "common.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include "../resolutionScaler.hpp"
+
+namespace util = ::vox::util;
+
+namespace {
+    //run frames of a GPU that takes fullMs at scale 1 and proportionally
+    //less with fewer pixels; returns how often the scale changed over the
+    //last settle frames
+    unsigned simulate(util::ResolutionScaler& scaler, float fullMs, unsigned frames, unsigned settle) {
+        unsigned changes = 0;
+
+        for (unsigned i = 0; i < frames; ++i) {
+            float const before = scaler.scale();
+            float const after  = scaler.update(fullMs * before * before);
+
+            if (after != before && i + settle >= frames) {
+                ++changes;
+            }
+        }
+
+        return changes;
+    }
+} //namespace anon
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(ResolutionScalerConverges)
+{
+    util::ResolutionScaler scaler(16.0f, 0.5f, 1.0f);
+
+    //30ms at full size needs about sqrt(16/30) = 0.73
+    unsigned const changes = simulate(scaler, 30.0f, 300, 100);
+
+    BOOST_CHECK_EQUAL(changes, 0u);
+    BOOST_CHECK_LE(30.0f * scaler.scale() * scaler.scale(), 16.0f);
+    BOOST_CHECK_GE(scaler.scale(), 0.6f);
+    BOOST_CHECK_LE(scaler.scale(), 0.75f);
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(ResolutionScalerRecovers)
+{
+    util::ResolutionScaler scaler(16.0f, 0.5f, 1.0f);
+
+    simulate(scaler, 30.0f, 300, 0);
+    BOOST_REQUIRE_LT(scaler.scale(), 1.0f);
+
+    //load drops: back to full size, and no higher
+    unsigned const changes = simulate(scaler, 5.0f, 300, 100);
+
+    BOOST_CHECK_EQUAL(changes, 0u);
+    BOOST_CHECK_EQUAL(scaler.scale(), 1.0f);
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(ResolutionScalerBounds)
+{
+    util::ResolutionScaler scaler(16.0f, 0.5f, 1.0f);
+
+    //too slow even at the smallest scale
+    simulate(scaler, 200.0f, 300, 0);
+    BOOST_CHECK_EQUAL(scaler.scale(), 0.5f);
+
+    scaler.setBounds(0.6f, 0.8f);
+    BOOST_CHECK_EQUAL(scaler.scale(), 0.6f);
+
+    simulate(scaler, 1.0f, 300, 0);
+    BOOST_CHECK_CLOSE(scaler.scale(), 0.8f, 0.001f);
+}
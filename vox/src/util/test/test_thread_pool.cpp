@@ -0,0 +1,49 @@
+#include "common.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include "../threadPool.hpp"
+
+namespace util = ::vox::util;
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(ThreadPoolParallelForRethrows)
+{
+    util::ThreadPool pool(2);
+
+    BOOST_CHECK_THROW(
+        pool.parallelFor(100, [](unsigned first, unsigned) {
+            if (first == 50) {
+                throw std::runtime_error("range failed");
+            }
+        }, 10),
+        std::runtime_error
+    );
+
+    //the pool is still usable
+    unsigned volatile ran = 0;
+    pool.parallelFor(1, [&ran](unsigned, unsigned) { ran = 1; });
+    BOOST_CHECK_EQUAL(ran, 1u);
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(ThreadPoolKeepsEscapedError)
+{
+    util::ThreadPool pool(2);
+
+    BOOST_CHECK(!pool.takeError());
+
+    pool.enqueue([] { throw std::runtime_error("first"); });
+
+    //give a worker up to a second to run it
+    boost::exception_ptr error;
+    for (unsigned i = 0; i < 1000 && !error; ++i) {
+        boost::this_thread::sleep_for(boost::chrono::milliseconds(1));
+        error = pool.takeError();
+    }
+
+    BOOST_REQUIRE(error);
+    BOOST_CHECK_THROW(boost::rethrow_exception(error), std::runtime_error);
+
+    //taken: not reported twice
+    BOOST_CHECK(!pool.takeError());
+}
@@ -0,0 +1,88 @@
+#include "common.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include "../timings.hpp"
+
+namespace util = ::vox::util;
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(TimingsSummarize)
+{
+    util::Timings timings;
+
+    timings.record("gpu/chunks", 2.0);
+    timings.record("cpu/drain", 0.5);
+    timings.record("gpu/chunks", 4.0);
+    timings.record("gpu/chunks", 3.0);
+
+    auto const entries = timings.entries();
+    BOOST_REQUIRE_EQUAL(entries.size(), 2u);
+
+    //sorted by name
+    BOOST_CHECK_EQUAL(entries[0].name, "cpu/drain");
+    BOOST_CHECK_EQUAL(entries[1].name, "gpu/chunks");
+
+    BOOST_CHECK_EQUAL(entries[1].count, 3u);
+    BOOST_CHECK_CLOSE(entries[1].mean(), 3.0, 0.001);
+    BOOST_CHECK_CLOSE(entries[1].last, 3.0, 0.001);
+    BOOST_CHECK_CLOSE(entries[1].max, 4.0, 0.001);
+
+    BOOST_CHECK(timings.report().find("gpu/chunks") != std::string::npos);
+
+    timings.clear();
+    BOOST_CHECK(timings.entries().empty());
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(TimingsFromThreads)
+{
+    util::Timings timings;
+
+    unsigned const THREADS = 4;
+    unsigned const RECORDS = 10000;
+
+    boost::thread_group threads;
+    for (unsigned i = 0; i < THREADS; ++i) {
+        threads.create_thread([&timings] {
+            for (unsigned j = 0; j < RECORDS; ++j) {
+                timings.record("cpu/work", 1.0);
+            }
+        });
+    }
+
+    threads.join_all();
+
+    auto const entries = timings.entries();
+    BOOST_REQUIRE_EQUAL(entries.size(), 1u);
+    BOOST_CHECK_EQUAL(entries[0].count, THREADS * RECORDS);
+    BOOST_CHECK_CLOSE(entries[0].total, static_cast<double>(THREADS * RECORDS), 0.001);
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(TimingsById)
+{
+    util::Timings timings;
+
+    util::Timings::id_t const chunks = timings.id("gpu/chunks");
+    BOOST_CHECK_EQUAL(timings.id("gpu/chunks"), chunks);
+    BOOST_CHECK(timings.id("gpu/frame") != chunks);
+
+    timings.record(chunks, 2.0);
+    timings.record("gpu/chunks", 4.0);
+
+    //looked up but never recorded: not listed
+    auto entries = timings.entries();
+    BOOST_REQUIRE_EQUAL(entries.size(), 1u);
+    BOOST_CHECK_EQUAL(entries[0].name, "gpu/chunks");
+    BOOST_CHECK_EQUAL(entries[0].count, 2u);
+
+    //ids outlive a clear
+    timings.clear();
+    BOOST_CHECK(timings.entries().empty());
+
+    timings.record(chunks, 1.0);
+    entries = timings.entries();
+    BOOST_REQUIRE_EQUAL(entries.size(), 1u);
+    BOOST_CHECK_EQUAL(entries[0].count, 1u);
+    BOOST_CHECK_CLOSE(entries[0].max, 1.0, 0.001);
+}
@@ -0,0 +1,81 @@
+#include "common.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include "../tripleBuffer.hpp"
+
+namespace util = ::vox::util;
+
+namespace {
+    struct Value {
+        Value() : a(0), b(0) {}
+
+        unsigned a;
+        unsigned b; //always written to match a
+    };
+} //namespace anon
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(TripleBufferNewest)
+{
+    util::TripleBuffer<unsigned> buffer;
+
+    BOOST_CHECK(!buffer.acquire());
+    BOOST_CHECK_EQUAL(buffer.front(), 0u);
+
+    buffer.back() = 1;
+    buffer.publish();
+    buffer.back() = 2;
+    buffer.publish();
+
+    //1 was never read
+    BOOST_CHECK(buffer.acquire());
+    BOOST_CHECK_EQUAL(buffer.front(), 2u);
+
+    //nothing new; the old value stays
+    BOOST_CHECK(!buffer.acquire());
+    BOOST_CHECK_EQUAL(buffer.front(), 2u);
+
+    //the writer never gets the value being read
+    buffer.back() = 3;
+    BOOST_CHECK_EQUAL(buffer.front(), 2u);
+    buffer.publish();
+
+    BOOST_CHECK(buffer.acquire());
+    BOOST_CHECK_EQUAL(buffer.front(), 3u);
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(TripleBufferFromThreads)
+{
+    util::TripleBuffer<Value> buffer;
+
+    unsigned const VALUES = 200000;
+
+    boost::thread writer([&buffer] {
+        for (unsigned i = 1; i <= VALUES; ++i) {
+            Value& value = buffer.back();
+            value.a = i;
+            value.b = i;
+            buffer.publish();
+        }
+    });
+
+    unsigned last = 0;
+    bool     torn = false;
+
+    while (last < VALUES) {
+        if (!buffer.acquire()) {
+            continue;
+        }
+
+        Value const& value = buffer.front();
+
+        torn = torn || value.a != value.b || value.a <= last;
+        last = value.a;
+    }
+
+    writer.join();
+
+    BOOST_CHECK(!torn);
+    BOOST_CHECK_EQUAL(last, VALUES);
+}
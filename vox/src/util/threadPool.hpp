@@ -0,0 +1,183 @@
+#pragma once
+#ifndef VOX_UTIL_THREAD_POOL_HPP
+#define VOX_UTIL_THREAD_POOL_HPP
+
+#include <functional>
+#include <algorithm>
+#include <cassert>
+
+#include <boost/thread.hpp>
+#include <boost/exception_ptr.hpp>
+
+#include "blockingQueue.hpp"
+#include "profiler.hpp"
+
+namespace vox {
+    namespace util {
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Fixed set of worker threads consuming jobs from a shared queue
+    ////////////////////////////////////////////////////////////////////////////
+    class ThreadPool : private boost::noncopyable {
+    public:
+        typedef std::function<void ()>                     job_t;
+        typedef std::function<void (unsigned, unsigned)>   range_job_t;
+
+        //threads == 0 uses one thread per hardware thread
+        explicit ThreadPool(unsigned threads = 0) {
+            if (threads == 0) {
+                threads = std::max(1u, boost::thread::hardware_concurrency());
+            }
+
+            size_ = threads;
+
+            for (unsigned i = 0; i < size_; ++i) {
+                threads_.create_thread([this] { worker_(); });
+            }
+        }
+
+        ~ThreadPool() {
+            //an empty job tells a worker to exit
+            for (unsigned i = 0; i < size_; ++i) {
+                jobs_.enqueue(job_t());
+            }
+
+            threads_.join_all();
+        }
+
+        unsigned size() const { return size_; }
+
+        //run job on some worker. Jobs should handle their own exceptions;
+        //the first one a job lets escape is kept for takeError()
+        void enqueue(job_t job) {
+            assert(job);
+            jobs_.enqueue(std::move(job));
+        }
+
+        //the first exception an enqueued job let escape since the last call;
+        //empty if none did
+        boost::exception_ptr takeError() {
+            boost::lock_guard<boost::mutex> lock(errorMutex_);
+
+            boost::exception_ptr result;
+            std::swap(result, error_);
+
+            return result;
+        }
+
+        //call job(first, last) over [0, count) in ranges of at most grain
+        //elements and block until every range is done. The calling thread
+        //takes ranges too, so this is safe to call from inside a worker.
+        //The first exception thrown by job is rethrown here.
+        void parallelFor(unsigned count, range_job_t job, unsigned grain = 1) {
+            if (count == 0) {
+                return;
+            }
+
+            grain = std::max(1u, grain);
+
+            std::shared_ptr<range_state> state(new range_state(count, grain, std::move(job)));
+
+            unsigned const ranges  = (count + grain - 1) / grain;
+            unsigned const helpers = std::min(size_, ranges - 1);
+
+            for (unsigned i = 0; i < helpers; ++i) {
+                jobs_.enqueue([state] { state->run(); });
+            }
+
+            state->run();
+            state->wait();
+        }
+    private:
+        struct range_state : private boost::noncopyable {
+            range_state(unsigned count, unsigned grain, range_job_t job)
+                : count(count), grain(grain), next(0), done(0), job(std::move(job))
+            {
+            }
+
+            void run() {
+                for (;;) {
+                    unsigned first = 0;
+                    {//lock
+                        boost::lock_guard<boost::mutex> lock(mutex);
+                        if (next >= count) {
+                            return;
+                        }
+
+                        first = next;
+                        next  = std::min(count, next + grain);
+                    }//unlock
+
+                    unsigned const last = std::min(count, first + grain);
+
+                    try {
+                        job(first, last);
+                    } catch (...) {
+                        boost::lock_guard<boost::mutex> lock(mutex);
+                        if (!error) {
+                            error = boost::current_exception();
+                        }
+                    }
+
+                    {//lock
+                        boost::lock_guard<boost::mutex> lock(mutex);
+                        done += last - first;
+                        if (done == count) {
+                            finished.notify_all();
+                        }
+                    }//unlock
+                }
+            }
+
+            void wait() {
+                boost::unique_lock<boost::mutex> lock(mutex);
+                while (done != count) {
+                    finished.wait(lock);
+                }
+
+                if (error) {
+                    boost::rethrow_exception(error);
+                }
+            }
+
+            unsigned const            count;
+            unsigned const            grain;
+            unsigned                  next;
+            unsigned                  done;
+            range_job_t               job;
+            boost::exception_ptr      error;
+            boost::mutex              mutex;
+            boost::condition_variable finished;
+        };
+
+        void worker_() {
+            VOX_PROFILE_THREAD("worker");
+
+            for (;;) {
+                job_t job = jobs_.dequeue();
+                if (!job) {
+                    return;
+                }
+
+                try {
+                    job();
+                } catch (...) {
+                    boost::lock_guard<boost::mutex> lock(errorMutex_);
+                    if (!error_) {
+                        error_ = boost::current_exception();
+                    }
+                }
+            }
+        }
+
+        unsigned              size_;
+        boost::thread_group   threads_;
+        BlockingQueue<job_t>  jobs_;
+        boost::mutex          errorMutex_;
+        boost::exception_ptr  error_; //first escaped from an enqueued job
+    };
+
+    } //namespace util
+} //namespace vox
+
+#endif //VOX_UTIL_THREAD_POOL_HPP
@@ -0,0 +1,104 @@
+#include "common.hpp"
+#include "timings.hpp"
+
+#include <sstream>
+#include <algorithm>
+#include <boost/format.hpp>
+
+namespace util = ::vox::util;
+
+util::Timings::id_t
+util::Timings::id(std::string const& name)
+{
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    return id_(name);
+}
+
+void
+util::Timings::record(id_t const id, double const ms)
+{
+    boost::lock_guard<boost::mutex> lock(mutex_);
+
+    assert(id < entries_.size());
+    Entry& entry = entries_[id];
+
+    ++entry.count;
+    entry.total += ms;
+    entry.last   = ms;
+    entry.max    = std::max(entry.max, ms);
+}
+
+void
+util::Timings::record(std::string const& name, double const ms)
+{
+    record(id(name), ms);
+}
+
+std::vector<util::Timings::Entry>
+util::Timings::entries() const
+{
+    std::vector<Entry> result;
+
+    {//lock
+        boost::lock_guard<boost::mutex> lock(mutex_);
+
+        result.reserve(entries_.size());
+        for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+            if (it->count > 0) {
+                result.push_back(*it);
+            }
+        }
+    }//unlock
+
+    std::sort(result.begin(), result.end(), [](Entry const& a, Entry const& b) {
+        return a.name < b.name;
+    });
+
+    return result;
+}
+
+std::string
+util::Timings::report() const
+{
+    auto const all = entries();
+
+    std::ostringstream out;
+    out << boost::format("%-24s %8s %10s %10s %10s\n") % "name" % "count" % "mean ms" % "last ms" % "max ms";
+
+    for (auto it = all.begin(); it != all.end(); ++it) {
+        out << boost::format("%-24s %8u %10.3f %10.3f %10.3f\n")
+            % it->name % it->count % it->mean() % it->last % it->max;
+    }
+
+    return out.str();
+}
+
+void
+util::Timings::clear()
+{
+    boost::lock_guard<boost::mutex> lock(mutex_);
+
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+        it->count = 0;
+        it->total = 0.0;
+        it->last  = 0.0;
+        it->max   = 0.0;
+    }
+}
+
+util::Timings::id_t
+util::Timings::id_(std::string const& name)
+{
+    auto const it = ids_.find(name);
+    if (it != ids_.end()) {
+        return it->second;
+    }
+
+    id_t const result = static_cast<id_t>(entries_.size());
+
+    Entry const entry = { name, 0, 0.0, 0.0, 0.0 };
+    entries_.push_back(entry);
+    ids_.insert(std::make_pair(name, result));
+
+    return result;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#ifndef VOX_UTIL_TIMINGS_HPP
+#define VOX_UTIL_TIMINGS_HPP
+
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/utility.hpp>
+#include <boost/thread.hpp>
+
+namespace vox {
+    namespace util {
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Named durations from wherever they're measured, CPU or GPU, summed up
+    // per name for reporting. Names are grouped by a prefix up to the first
+    // '/', e.g. "gpu/chunks" or "cpu/drain". Every member is thread safe.
+    //
+    // Something recorded every frame should look its name up once with id()
+    // and record by id, which doesn't allocate or search.
+    ////////////////////////////////////////////////////////////////////////////
+    class Timings : private boost::noncopyable {
+    public:
+        typedef unsigned id_t;
+
+        struct Entry {
+            std::string name;
+            unsigned    count;
+            double      total; //ms
+            double      last;
+            double      max;
+
+            double mean() const { return count ? total / count : 0.0; }
+        };
+
+        //the id of name, the same for as long as the timings live
+        id_t id(std::string const& name);
+
+        void record(id_t id, double ms);
+        void record(std::string const& name, double ms);
+
+        //every name recorded since the last clear, sorted by name
+        std::vector<Entry> entries() const;
+        //one line per name: count, mean, last and max
+        std::string report() const;
+
+        //forget what was recorded; ids stay valid
+        void clear();
+    private:
+        id_t id_(std::string const& name);
+
+        mutable boost::mutex        mutex_;
+        std::vector<Entry>          entries_; //by id
+        std::map<std::string, id_t> ids_;
+    };
+
+    } //namespace util
+} //namespace vox
+
+#endif //VOX_UTIL_TIMINGS_HPP
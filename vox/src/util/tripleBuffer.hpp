@@ -0,0 +1,74 @@
+#pragma once
+#ifndef VOX_UTIL_TRIPLE_BUFFER_HPP
+#define VOX_UTIL_TRIPLE_BUFFER_HPP
+
+#include <algorithm>
+#include <boost/utility.hpp>
+#include <boost/thread.hpp>
+
+namespace vox {
+    namespace util {
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Hands the newest value from one writer thread to one reader thread
+    // without either waiting on the other. The writer fills back() in place
+    // and publishes it; the reader takes the newest published value with
+    // acquire() and reads it through front() until the next acquire. Values
+    // published in between are skipped.
+    //
+    // The three values are reused, so back() still holds whatever was
+    // written into it two publishes ago; the writer must overwrite all of it.
+    // Only swapping which value is which takes the lock.
+    ////////////////////////////////////////////////////////////////////////////
+    template <typename T>
+    class TripleBuffer : private boost::noncopyable {
+    public:
+        TripleBuffer()
+            : buffers_()
+            , back_(0)
+            , middle_(1)
+            , front_(2)
+            , fresh_(false)
+        {
+        }
+
+        //writer only
+        T& back() { return buffers_[back_]; }
+
+        //writer only; make back() the newest value
+        void publish() {
+            boost::lock_guard<boost::mutex> lock(mutex_);
+
+            std::swap(back_, middle_);
+            fresh_ = true;
+        }
+
+        //reader only; true if front() changed
+        bool acquire() {
+            boost::lock_guard<boost::mutex> lock(mutex_);
+
+            if (!fresh_) {
+                return false;
+            }
+
+            std::swap(front_, middle_);
+            fresh_ = false;
+
+            return true;
+        }
+
+        //reader only; a default T before the first acquire
+        T const& front() const { return buffers_[front_]; }
+    private:
+        T            buffers_[3];
+        unsigned     back_;
+        unsigned     middle_; //newest published, if fresh_
+        unsigned     front_;
+        bool         fresh_;
+        boost::mutex mutex_;
+    };
+
+    } //namespace util
+} //namespace vox
+
+#endif //VOX_UTIL_TRIPLE_BUFFER_HPP
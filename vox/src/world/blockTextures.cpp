@@ -0,0 +1,68 @@
+#include "common.hpp"
+#include "blockTextures.hpp"
+
+namespace world = ::vox::world;
+
+world::BlockTextures::BlockTextures()
+    : layers_(BLOCK_COUNT*FACE_COUNT, 0)
+{
+}
+
+world::BlockTextures
+world::BlockTextures::standard()
+{
+    BlockTextures result;
+
+    result.set(BLOCK_STONE, "stone");
+    result.set(BLOCK_DIRT,  "dirt");
+    result.set(BLOCK_GRASS, "grass_top", "grass_side", "dirt");
+    result.set(BLOCK_SAND,  "sand");
+    result.set(BLOCK_WATER, "water");
+    result.set(BLOCK_LAMP,  "lamp");
+
+    return result;
+}
+
+void
+world::BlockTextures::set(BlockId const id, std::string const& name)
+{
+    set(id, name, name, name);
+}
+
+void
+world::BlockTextures::set(BlockId const id, Face const face, std::string const& name)
+{
+    layers_[index(id, face)] = static_cast<int>(layerOf_(name));
+}
+
+void
+world::BlockTextures::set(
+    BlockId const      id,
+    std::string const& top,
+    std::string const& side,
+    std::string const& bottom
+) {
+    //in layer order: top, sides, bottom
+    set(id, FACE_POS_Y, top);
+    set(id, FACE_POS_X, side);
+    set(id, FACE_NEG_X, side);
+    set(id, FACE_POS_Z, side);
+    set(id, FACE_NEG_Z, side);
+    set(id, FACE_NEG_Y, bottom);
+}
+
+unsigned
+world::BlockTextures::layerOf_(std::string const& name)
+{
+    auto const it = byName_.find(name);
+    if (it != byName_.end()) {
+        return it->second;
+    }
+
+    unsigned const layer = layerCount();
+
+    names_.push_back(name);
+    byName_.insert(std::make_pair(name, layer));
+
+    return layer;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#ifndef VOX_WORLD_BLOCK_TEXTURES_HPP
+#define VOX_WORLD_BLOCK_TEXTURES_HPP
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "chunkMesher.hpp"
+
+namespace vox {
+    namespace world {
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Which texture each face of each block type shows. Every distinct
+    // texture name gets the next layer of the block texture array as it's
+    // first used, so blocks sharing a texture share a layer and the whole
+    // world samples one array texture indexed by layer(block, face).
+    //
+    // Faces that were never set show layer 0.
+    ////////////////////////////////////////////////////////////////////////////
+    class BlockTextures {
+    public:
+        BlockTextures();
+
+        //the textures of the current block types
+        static BlockTextures standard();
+
+        //every face of id shows name
+        void set(BlockId id, std::string const& name);
+        //face of id shows name
+        void set(BlockId id, Face face, std::string const& name);
+        //top, bottom and the four side faces of id
+        void set(BlockId id, std::string const& top, std::string const& side, std::string const& bottom);
+
+        unsigned layer(BlockId id, Face face) const {
+            return static_cast<unsigned>(layers_[index(id, face)]);
+        }
+
+        //layer(id, face) for every block type, face fastest
+        int const* layerTable() const { return &layers_[0]; }
+        unsigned   layerTableSize() const { return static_cast<unsigned>(layers_.size()); }
+
+        //texture name of each layer
+        std::vector<std::string> const& names() const { return names_; }
+        unsigned layerCount() const { return static_cast<unsigned>(names_.size()); }
+
+        static unsigned index(BlockId id, Face face) {
+            assert(id < BLOCK_COUNT && face < FACE_COUNT);
+            return id*FACE_COUNT + face;
+        }
+    private:
+        unsigned layerOf_(std::string const& name);
+
+        std::vector<int>                layers_;
+        std::vector<std::string>        names_;
+        std::map<std::string, unsigned> byName_;
+    };
+
+    } //namespace world
+} //namespace vox
+
+#endif //VOX_WORLD_BLOCK_TEXTURES_HPP
@@ -0,0 +1,42 @@
+#include "common.hpp"
+#include "chunk.hpp"
+
+namespace world = ::vox::world;
+namespace util  = ::vox::util;
+
+namespace {
+    //created on first use; chunks are made on worker threads and a function
+    //local static isn't safe to initialize concurrently
+    boost::once_flag      allocatorOnce = BOOST_ONCE_INIT;
+    util::SlabAllocator*  allocatorInstance = nullptr;
+
+    void createAllocator() {
+        //1MB slabs
+        static util::SlabAllocator instance(world::CHUNK_VOLUME * 2, 16);
+        allocatorInstance = &instance;
+    }
+} //namespace anon
+
+////////////////////////////////////////////////////////////////////////////////
+// Chunk
+////////////////////////////////////////////////////////////////////////////////
+util::SlabAllocator&
+world::Chunk::allocator()
+{
+    boost::call_once(allocatorOnce, &createAllocator);
+    return *allocatorInstance;
+}
+
+world::Chunk::Chunk(ChunkPos pos)
+    : pos_(pos)
+    , blocks_(static_cast<BlockId*>(allocator().allocate()))
+    , light_(blocks_ + CHUNK_VOLUME)
+{
+    std::fill(blocks_, blocks_ + CHUNK_VOLUME, static_cast<BlockId>(BLOCK_AIR));
+    std::fill(light_, light_ + CHUNK_VOLUME, static_cast<unsigned char>(0));
+}
+
+world::Chunk::~Chunk()
+{
+    allocator().deallocate(blocks_);
+}
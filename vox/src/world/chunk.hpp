@@ -0,0 +1,140 @@
+#pragma once
+#ifndef VOX_WORLD_CHUNK_HPP
+#define VOX_WORLD_CHUNK_HPP
+
+#include <memory>
+#include <algorithm>
+#include <cassert>
+#include <boost/utility.hpp>
+
+#include "../util/slabAllocator.hpp"
+
+namespace vox {
+    namespace world {
+
+    typedef unsigned char BlockId;
+
+    enum Block {
+        BLOCK_AIR   = 0,
+        BLOCK_STONE = 1,
+        BLOCK_DIRT  = 2,
+        BLOCK_GRASS = 3,
+        BLOCK_SAND  = 4,
+        BLOCK_WATER = 5,
+        BLOCK_LAMP  = 6,
+        BLOCK_COUNT,
+    };
+
+    //true if the block hides the faces of its neighbours, stops rays and
+    //blocks light
+    inline bool isOpaque(BlockId id) {
+        return id != BLOCK_AIR && id != BLOCK_WATER;
+    }
+
+    //light levels run from 0 (dark) to LIGHT_MAX
+    unsigned const LIGHT_MAX = 15;
+
+    //block light level emitted by the block
+    inline unsigned lightEmission(BlockId id) {
+        return id == BLOCK_LAMP ? LIGHT_MAX : 0;
+    }
+
+    //chunks are full height columns of blocks
+    unsigned const CHUNK_SIZE_X = 16;
+    unsigned const CHUNK_SIZE_Y = 128;
+    unsigned const CHUNK_SIZE_Z = 16;
+    unsigned const CHUNK_VOLUME = CHUNK_SIZE_X*CHUNK_SIZE_Y*CHUNK_SIZE_Z;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Position of a chunk column in chunk units
+    ////////////////////////////////////////////////////////////////////////////
+    struct ChunkPos {
+        ChunkPos() : x(0), z(0) {}
+        ChunkPos(int x, int z) : x(x), z(z) {}
+
+        bool operator<(ChunkPos const& rhs)  const { return x < rhs.x || (x == rhs.x && z < rhs.z); }
+        bool operator==(ChunkPos const& rhs) const { return x == rhs.x && z == rhs.z; }
+        bool operator!=(ChunkPos const& rhs) const { return !(*this == rhs); }
+
+        //world position of the chunk's (0, 0, 0) block
+        int blockX() const { return x * static_cast<int>(CHUNK_SIZE_X); }
+        int blockZ() const { return z * static_cast<int>(CHUNK_SIZE_Z); }
+
+        //the chunk containing the block at world (bx, bz)
+        static ChunkPos fromBlock(int bx, int bz) {
+            return ChunkPos(floorDiv_(bx, CHUNK_SIZE_X), floorDiv_(bz, CHUNK_SIZE_Z));
+        }
+
+        int x, z;
+    private:
+        static int floorDiv_(int value, unsigned size) {
+            int const n = static_cast<int>(size);
+            return value >= 0 ? value / n : -((n - 1 - value) / n);
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Block and light storage for a single chunk column. Blocks are stored
+    // with y varying fastest so a vertical column is contiguous. Each block
+    // has a light byte holding sky light in the high nibble and block light
+    // in the low nibble.
+    //
+    // Blocks and light share one buffer from a slab allocator common to all
+    // chunks, so streaming chunks in and out doesn't go through the heap.
+    ////////////////////////////////////////////////////////////////////////////
+    class Chunk : private boost::noncopyable {
+    public:
+        explicit Chunk(ChunkPos pos);
+        ~Chunk();
+
+        //the allocator chunk data comes from; one block per chunk
+        static util::SlabAllocator& allocator();
+
+        static unsigned index(unsigned x, unsigned y, unsigned z) {
+            assert(x < CHUNK_SIZE_X && y < CHUNK_SIZE_Y && z < CHUNK_SIZE_Z);
+            return (x*CHUNK_SIZE_Z + z)*CHUNK_SIZE_Y + y;
+        }
+
+        ChunkPos position() const { return pos_; }
+
+        BlockId get(unsigned x, unsigned y, unsigned z) const {
+            return blocks_[index(x, y, z)];
+        }
+
+        void set(unsigned x, unsigned y, unsigned z, BlockId id) {
+            blocks_[index(x, y, z)] = id;
+        }
+
+        //the CHUNK_SIZE_Y blocks of the column at (x, z)
+        BlockId*       column(unsigned x, unsigned z)       { return blocks_ + index(x, 0, z); }
+        BlockId const* column(unsigned x, unsigned z) const { return blocks_ + index(x, 0, z); }
+
+        BlockId*       blocks()       { return blocks_; }
+        BlockId const* blocks() const { return blocks_; }
+
+        unsigned skyLight(unsigned i)   const { return light_[i] >> 4; }
+        unsigned blockLight(unsigned i) const { return light_[i] & 0x0F; }
+
+        void setSkyLight(unsigned i, unsigned value) {
+            assert(value <= LIGHT_MAX);
+            light_[i] = static_cast<unsigned char>((light_[i] & 0x0F) | (value << 4));
+        }
+
+        void setBlockLight(unsigned i, unsigned value) {
+            assert(value <= LIGHT_MAX);
+            light_[i] = static_cast<unsigned char>((light_[i] & 0xF0) | value);
+        }
+
+        //packed sky and block light, indexed like blocks()
+        unsigned char*       light()       { return light_; }
+        unsigned char const* light() const { return light_; }
+    private:
+        ChunkPos       pos_;
+        BlockId*       blocks_;
+        unsigned char* light_;
+    };
+
+    } //namespace world
+} //namespace vox
+
+#endif //VOX_WORLD_CHUNK_HPP
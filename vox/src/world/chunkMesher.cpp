@@ -0,0 +1,239 @@
+#include "common.hpp"
+#include "chunkMesher.hpp"
+#include "../util/profiler.hpp"
+
+namespace world = ::vox::world;
+
+namespace {
+    int const FACE_DX[world::FACE_COUNT] = {1, -1, 0,  0, 0,  0};
+    int const FACE_DY[world::FACE_COUNT] = {0,  0, 1, -1, 0,  0};
+    int const FACE_DZ[world::FACE_COUNT] = {0,  0, 0,  0, 1, -1};
+
+    //unit cube corners of each face, counter clockwise seen from outside
+    unsigned char const FACE_CORNERS[world::FACE_COUNT][4][3] = {
+        {{1, 0, 1}, {1, 0, 0}, {1, 1, 0}, {1, 1, 1}}, //+x
+        {{0, 0, 0}, {0, 0, 1}, {0, 1, 1}, {0, 1, 0}}, //-x
+        {{0, 1, 1}, {1, 1, 1}, {1, 1, 0}, {0, 1, 0}}, //+y
+        {{0, 0, 0}, {1, 0, 0}, {1, 0, 1}, {0, 0, 1}}, //-y
+        {{0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}}, //+z
+        {{1, 0, 0}, {0, 0, 0}, {0, 1, 0}, {1, 1, 0}}, //-z
+    };
+
+    //two triangles per quad, split along the 0-2 or the 1-3 diagonal
+    unsigned const QUAD_INDICES[6]         = {0, 1, 2, 0, 2, 3};
+    unsigned const QUAD_INDICES_FLIPPED[6] = {1, 2, 3, 1, 3, 0};
+
+    int const STRIDE_X = static_cast<int>(world::ChunkMesher::PAD_Z * world::ChunkMesher::PAD_Y);
+    int const STRIDE_Z = static_cast<int>(world::ChunkMesher::PAD_Y);
+    int const STRIDE_Y = 1;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Padded array offsets, relative to a block, of the face neighbour and of
+    // the three blocks around each face corner that can occlude it.
+    ////////////////////////////////////////////////////////////////////////////
+    struct NeighbourOffsets {
+        NeighbourOffsets() {
+            int const stride[3] = {STRIDE_X, STRIDE_Y, STRIDE_Z};
+
+            for (unsigned f = 0; f < world::FACE_COUNT; ++f) {
+                int const d[3] = {FACE_DX[f], FACE_DY[f], FACE_DZ[f]};
+                face[f] = d[0]*STRIDE_X + d[1]*STRIDE_Y + d[2]*STRIDE_Z;
+
+                for (unsigned c = 0; c < 4; ++c) {
+                    int tangent[2];
+                    unsigned n = 0;
+
+                    for (unsigned axis = 0; axis < 3; ++axis) {
+                        if (d[axis] == 0) {
+                            tangent[n++] = (FACE_CORNERS[f][c][axis] ? 1 : -1) * stride[axis];
+                        }
+                    }
+
+                    side1[f][c]  = face[f] + tangent[0];
+                    side2[f][c]  = face[f] + tangent[1];
+                    corner[f][c] = face[f] + tangent[0] + tangent[1];
+                }
+            }
+        }
+
+        int face[world::FACE_COUNT];
+        int side1[world::FACE_COUNT][4];
+        int side2[world::FACE_COUNT][4];
+        int corner[world::FACE_COUNT][4];
+    };
+
+    NeighbourOffsets const OFFSETS;
+
+    //0 (fully occluded) to 3 (open) from the three blocks around a corner;
+    //two sides block the corner regardless of the diagonal
+    inline unsigned vertexAo(bool side1, bool side2, bool corner) {
+        if (side1 && side2) {
+            return 0;
+        }
+
+        return world::VERTEX_AO_MAX - (side1 + side2 + corner);
+    }
+
+    void emitFace(
+        world::vertex_vector_t& out,
+        unsigned x, unsigned y, unsigned z,
+        unsigned face,
+        world::BlockId id,
+        unsigned char light,
+        unsigned const (&ao)[4]
+    ) {
+        world::ChunkVertex corners[4];
+
+        for (unsigned c = 0; c < 4; ++c) {
+            world::ChunkVertex& v = corners[c];
+            v.x      = static_cast<unsigned char>(x + FACE_CORNERS[face][c][0]);
+            v.y      = static_cast<unsigned char>(y + FACE_CORNERS[face][c][1]);
+            v.z      = static_cast<unsigned char>(z + FACE_CORNERS[face][c][2]);
+            v.face   = static_cast<unsigned char>(face | ao[c] << world::VERTEX_AO_SHIFT);
+            v.light  = light;
+            v.block  = id;
+            v.pad[0] = v.pad[1] = 0;
+        }
+
+        //interpolating across the diagonal with the brighter ends makes the
+        //shading of the quad depend on its orientation; split along the other
+        //one instead
+        unsigned const* const indices = (ao[0] + ao[2] > ao[1] + ao[3]) ?
+            QUAD_INDICES_FLIPPED : QUAD_INDICES;
+
+        for (unsigned i = 0; i < 6; ++i) {
+            out.push_back(corners[indices[i]]);
+        }
+    }
+
+    //created on first use, see MeshPool::get
+    boost::once_flag          meshPoolOnce     = BOOST_ONCE_INIT;
+    vox::util::SizeClassPool* meshPoolInstance = nullptr;
+
+    void createMeshPool() {
+        //a chunk mesh is rarely under 2KB or over 1MB
+        static vox::util::SizeClassPool instance(2 * 1024, 1024 * 1024);
+        meshPoolInstance = &instance;
+    }
+} //namespace anon
+
+//meshes are built on worker threads and a function local static isn't safe
+//to initialize concurrently
+vox::util::SizeClassPool&
+world::MeshPool::get()
+{
+    boost::call_once(meshPoolOnce, &createMeshPool);
+    return *meshPoolInstance;
+}
+
+world::ChunkMesher::ChunkMesher()
+    : blocks_(PAD_X * PAD_Y * PAD_Z)
+    , light_(PAD_X * PAD_Y * PAD_Z)
+{
+}
+
+bool
+world::ChunkMesher::copy_(World const& world, ChunkPos const pos)
+{
+    World::chunk_ptr chunks[3][3];
+    for (int dx = -1; dx <= 1; ++dx) {
+        for (int dz = -1; dz <= 1; ++dz) {
+            chunks[dx + 1][dz + 1] = world.find(ChunkPos(pos.x + dx, pos.z + dz));
+        }
+    }
+
+    if (!chunks[1][1]) {
+        return false;
+    }
+
+    int const sx = static_cast<int>(CHUNK_SIZE_X);
+    int const sz = static_cast<int>(CHUNK_SIZE_Z);
+    int const sy = static_cast<int>(CHUNK_SIZE_Y);
+
+    unsigned char const skyLit = static_cast<unsigned char>(LIGHT_MAX << 4);
+
+    for (int x = -1; x <= sx; ++x) {
+        for (int z = -1; z <= sz; ++z) {
+            int const cx = x < 0 ? 0 : x < sx ? 1 : 2;
+            int const cz = z < 0 ? 0 : z < sz ? 1 : 2;
+            Chunk const* const chunk = chunks[cx][cz].get();
+
+            BlockId*       const blocks = &blocks_[padIndex(x, 0, z)];
+            unsigned char* const light  = &light_[padIndex(x, 0, z)];
+
+            //never show the underside of the world; above it is open sky
+            blocks[-1] = BLOCK_STONE;
+            light[-1]  = 0;
+            blocks[sy] = BLOCK_AIR;
+            light[sy]  = skyLit;
+
+            if (!chunk) {
+                std::fill(blocks, blocks + sy, static_cast<BlockId>(BLOCK_AIR));
+                std::fill(light, light + sy, skyLit);
+                continue;
+            }
+
+            unsigned const i = Chunk::index(x - (cx - 1)*sx, 0, z - (cz - 1)*sz);
+            std::copy(chunk->blocks() + i, chunk->blocks() + i + sy, blocks);
+            std::copy(chunk->light() + i, chunk->light() + i + sy, light);
+        }
+    }
+
+    return true;
+}
+
+void
+world::ChunkMesher::build(World const& world, ChunkPos const pos, ChunkMesh& mesh)
+{
+    VOX_PROFILE_SCOPE("mesh/build");
+
+    mesh.pos = pos;
+    mesh.vertices.clear();
+
+    if (!copy_(world, pos)) {
+        return;
+    }
+
+    BlockId const*       const blocks = &blocks_[0];
+    unsigned char const* const light  = &light_[0];
+
+    for (unsigned x = 0; x < CHUNK_SIZE_X; ++x) {
+        for (unsigned z = 0; z < CHUNK_SIZE_Z; ++z) {
+            int i = padIndex(x, 0, z);
+
+            for (unsigned y = 0; y < CHUNK_SIZE_Y; ++y, ++i) {
+                BlockId const id = blocks[i];
+                if (id == BLOCK_AIR) {
+                    continue;
+                }
+
+                for (unsigned face = 0; face < FACE_COUNT; ++face) {
+                    BlockId const other = blocks[i + OFFSETS.face[face]];
+
+                    //hidden behind an opaque block or inside a body of water
+                    if (isOpaque(other) || other == id) {
+                        continue;
+                    }
+
+                    unsigned ao[4];
+                    for (unsigned c = 0; c < 4; ++c) {
+                        ao[c] = vertexAo(
+                            isOpaque(blocks[i + OFFSETS.side1[face][c]]),
+                            isOpaque(blocks[i + OFFSETS.side2[face][c]]),
+                            isOpaque(blocks[i + OFFSETS.corner[face][c]])
+                        );
+                    }
+
+                    emitFace(mesh.vertices, x, y, z, face, id, light[i + OFFSETS.face[face]], ao);
+                }
+            }
+        }
+    }
+}
+
+void
+world::buildMesh(World const& world, ChunkPos const pos, ChunkMesh& mesh)
+{
+    ChunkMesher mesher;
+    mesher.build(world, pos, mesh);
+}
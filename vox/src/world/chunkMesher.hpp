@@ -0,0 +1,95 @@
+#pragma once
+#ifndef VOX_WORLD_CHUNK_MESHER_HPP
+#define VOX_WORLD_CHUNK_MESHER_HPP
+
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+#include "world.hpp"
+#include "../util/slabAllocator.hpp"
+
+namespace vox {
+    namespace world {
+
+    enum Face {
+        FACE_POS_X,
+        FACE_NEG_X,
+        FACE_POS_Y,
+        FACE_NEG_Y,
+        FACE_POS_Z,
+        FACE_NEG_Z,
+        FACE_COUNT,
+    };
+
+    unsigned const VERTEX_AO_SHIFT = 6;
+    unsigned const VERTEX_AO_MAX   = 3; //unoccluded
+
+    ////////////////////////////////////////////////////////////////////////////
+    // 8 byte vertex of a chunk mesh. Positions are relative to the chunk
+    // origin. light is the packed sky/block light of the block the face
+    // looks into, so the shader only has to scale it by the time of day.
+    ////////////////////////////////////////////////////////////////////////////
+    struct ChunkVertex {
+        unsigned char x, y, z;
+        unsigned char face;  //Face in bits 0-2, ambient occlusion in bits 6-7
+        unsigned char light; //sky light << 4 | block light
+        unsigned char block; //BlockId
+        unsigned char pad[2];
+
+        unsigned faceId() const { return face & 0x07; }
+        unsigned ao()     const { return face >> VERTEX_AO_SHIFT; }
+    };
+
+    static_assert(sizeof(ChunkVertex) == 8, "ChunkVertex must be tightly packed");
+
+    //pool the vertex buffers of all meshes come from, so meshes built and
+    //thrown away while streaming reuse the same memory
+    struct MeshPool {
+        static util::SizeClassPool& get();
+    };
+
+    typedef std::vector<ChunkVertex, util::PoolAllocator<ChunkVertex, MeshPool>> vertex_vector_t;
+
+    struct ChunkMesh {
+        ChunkPos        pos;
+        vertex_vector_t vertices; //triangle list
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Builds the visible faces of a chunk with per vertex ambient occlusion.
+    // The chunk and its eight neighbours are first copied into a padded
+    // block/light array, so every neighbour lookup while meshing, including
+    // those across chunk borders, is a fixed offset from the current block.
+    // A missing neighbour is treated as open air.
+    //
+    // A mesher holds the padded copy between calls; use one per thread.
+    ////////////////////////////////////////////////////////////////////////////
+    class ChunkMesher : private boost::noncopyable {
+    public:
+        ChunkMesher();
+
+        void build(World const& world, ChunkPos pos, ChunkMesh& mesh);
+
+        static unsigned const PAD_X = CHUNK_SIZE_X + 2;
+        static unsigned const PAD_Y = CHUNK_SIZE_Y + 2;
+        static unsigned const PAD_Z = CHUNK_SIZE_Z + 2;
+
+        //index into the padded arrays of chunk local (x, y, z), each of
+        //which may be one block outside the chunk
+        static int padIndex(int x, int y, int z) {
+            return ((x + 1)*static_cast<int>(PAD_Z) + (z + 1))*static_cast<int>(PAD_Y) + (y + 1);
+        }
+    private:
+        bool copy_(World const& world, ChunkPos pos);
+
+        std::vector<BlockId>       blocks_;
+        std::vector<unsigned char> light_;
+    };
+
+    //build with a temporary mesher
+    void buildMesh(World const& world, ChunkPos pos, ChunkMesh& mesh);
+
+    } //namespace world
+} //namespace vox
+
+#endif //VOX_WORLD_CHUNK_MESHER_HPP
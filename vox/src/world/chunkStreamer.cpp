@@ -0,0 +1,664 @@
+#include "common.hpp"
+#include "chunkStreamer.hpp"
+
+#include <cmath>
+
+#include "lighting.hpp"
+#include "regionFile.hpp"
+#include "terrainGenerator.hpp"
+#include "../util/threadPool.hpp"
+
+namespace world = ::vox::world;
+
+namespace {
+    size_t const CHUNK_BYTES = sizeof(world::Chunk) + world::CHUNK_VOLUME * 2;
+
+    //mesh size assumed before any chunk has been meshed
+    size_t const DEFAULT_MESH_BYTES = 64 * 1024;
+
+    //ranks chunks outside the view cone after every chunk inside it
+    float const OUT_OF_VIEW = 1.0e9f;
+
+    //number of chunk positions within radius of a chunk
+    unsigned countInRadius(unsigned radius) {
+        int const r = static_cast<int>(radius);
+
+        unsigned count = 0;
+        for (int dx = -r; dx <= r; ++dx) {
+            for (int dz = -r; dz <= r; ++dz) {
+                count += (dx*dx + dz*dz <= r*r);
+            }
+        }
+
+        return count;
+    }
+
+    template <typename F>
+    void forNeighbours(world::ChunkPos const pos, F f) {
+        for (int dx = -1; dx <= 1; ++dx) {
+            for (int dz = -1; dz <= 1; ++dz) {
+                if (dx != 0 || dz != 0) {
+                    f(world::ChunkPos(pos.x + dx, pos.z + dz));
+                }
+            }
+        }
+    }
+} //namespace anon
+
+world::ChunkStreamer::ChunkStreamer(
+    World&                  world,
+    LightEngine&            light,
+    TerrainGenerator const& generator,
+    RegionStorage*          storage,
+    util::ThreadPool&       pool,
+    StreamerParams const&   params
+)
+    : world_(world)
+    , light_(light)
+    , generator_(generator)
+    , storage_(storage)
+    , pool_(pool)
+    , params_(params)
+    , center_(0, 0)
+    , radius_(params.loadRadius)
+    , nextGeneration_(0)
+    , inFlight_(0)
+    , stopping_(false)
+    , latencyTotal_(0.0)
+    , latencyCount_(0)
+{
+    light_.setOnChunkChanged([this](ChunkPos pos) { lit_(pos); });
+}
+
+world::ChunkStreamer::~ChunkStreamer()
+{
+    {//lock
+        boost::unique_lock<boost::mutex> lock(mutex_);
+
+        stopping_ = true;
+        pending_  = std::priority_queue<Job>();
+
+        while (inFlight_ != 0) {
+            finished_.wait(lock);
+        }
+    }//unlock
+
+    //a load job may have just scheduled lighting
+    while (!light_.isIdle()) {
+        boost::this_thread::yield();
+    }
+
+    light_.setOnChunkChanged(LightEngine::callback_t());
+}
+
+void
+world::ChunkStreamer::setOnMeshReady(mesh_callback_t callback)
+{
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    onMeshReady_ = callback;
+}
+
+void
+world::ChunkStreamer::setOnUnload(unload_callback_t callback)
+{
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    onUnload_ = callback;
+}
+
+bool
+world::ChunkStreamer::inRadius_(ChunkPos const pos, unsigned const radius) const
+{
+    int const dx = pos.x - center_.x;
+    int const dz = pos.z - center_.z;
+    int const r  = static_cast<int>(radius);
+
+    return dx*dx + dz*dz <= r*r;
+}
+
+float
+world::ChunkStreamer::priority_(ChunkPos const pos) const
+{
+    float const dx = pos.blockX() + CHUNK_SIZE_X * 0.5f - camera_.position.x();
+    float const dz = pos.blockZ() + CHUNK_SIZE_Z * 0.5f - camera_.position.z();
+
+    float const distance2 = dx*dx + dz*dz;
+    float const distance  = std::sqrt(distance2);
+
+    float const viewX   = camera_.direction.x();
+    float const viewZ   = camera_.direction.z();
+    float const viewLen = std::sqrt(viewX*viewX + viewZ*viewZ);
+
+    //the chunks around the camera and everything when looking straight up or
+    //down count as in view
+    bool const inView = distance < CHUNK_SIZE_X * 1.5f
+                     || viewLen < 1.0e-3f
+                     || (dx*viewX + dz*viewZ) / (distance * viewLen) >= camera_.cosHalfFov;
+
+    return (inView ? 0.0f : OUT_OF_VIEW) + distance2;
+}
+
+bool
+world::ChunkStreamer::meshReady_(ChunkPos const pos) const
+{
+    auto const it = entries_.find(pos);
+    if (it == entries_.end() || it->second.stage != STAGE_LOADED || !it->second.lit) {
+        return false;
+    }
+
+    //neighbours that aren't wanted are meshed against as air
+    bool ready = true;
+    forNeighbours(pos, [&](ChunkPos n) {
+        auto const other = entries_.find(n);
+        if (other != entries_.end() && (other->second.stage != STAGE_LOADED || !other->second.lit)) {
+            ready = false;
+        }
+    });
+
+    return ready;
+}
+
+size_t
+world::ChunkStreamer::memoryInUse_() const
+{
+    size_t result = unsaved_.size() * CHUNK_BYTES;
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+        if (it->second.stage == STAGE_LOADED) {
+            result += CHUNK_BYTES + it->second.meshBytes;
+        }
+    }
+
+    return result;
+}
+
+void
+world::ChunkStreamer::pushMesh_(ChunkPos const pos, Entry const& entry)
+{
+    Job job;
+    job.priority = entry.priority;
+    job.type     = JOB_MESH;
+    job.pos      = pos;
+
+    pending_.push(job);
+}
+
+void
+world::ChunkStreamer::markDirty_(ChunkPos const pos)
+{
+    auto const it = entries_.find(pos);
+    if (it == entries_.end() || it->second.stage != STAGE_LOADED) {
+        return;
+    }
+
+    it->second.dirty = true;
+    pushMesh_(pos, it->second);
+}
+
+void
+world::ChunkStreamer::evict_(entries_t::iterator const it, std::vector<ChunkPos>& unloaded)
+{
+    ChunkPos const pos = it->first;
+
+    if (it->second.stage == STAGE_LOADED) {
+        auto const chunk = world_.find(pos);
+
+        unloaded.push_back(pos);
+        ++counters_.evicted;
+
+        //stays in the world until it's saved, so a failed save loses nothing
+        if (storage_ && chunk) {
+            unsaved_[pos] = true;
+
+            ++inFlight_;
+            pool_.enqueue([this, pos, chunk] { save_(pos, chunk); });
+        } else {
+            world_.erase(pos);
+        }
+    }
+
+    //any job still running for it sees the entry gone and drops its result
+    entries_.erase(it);
+}
+
+void
+world::ChunkStreamer::save_(ChunkPos const pos, World::chunk_ptr const chunk)
+{
+    bool saved = false;
+
+    try {
+        storage_->save(*chunk);
+        saved = true;
+    } catch (...) {
+        //counted below; update() tries again
+    }
+
+    {//lock
+        boost::lock_guard<boost::mutex> lock(mutex_);
+
+        if (saved) {
+            world_.erase(pos);
+            unsaved_.erase(pos);
+        } else {
+            unsaved_[pos] = false;
+            ++counters_.saveFailed;
+        }
+    }//unlock
+
+    finish_();
+}
+
+void
+world::ChunkStreamer::update(StreamCamera const& camera)
+{
+    std::vector<ChunkPos> unloaded;
+    unload_callback_t     onUnload;
+
+    {//lock
+        boost::lock_guard<boost::mutex> lock(mutex_);
+
+        camera_ = camera;
+        center_ = ChunkPos::fromBlock(
+            static_cast<int>(std::floor(camera.position.x())),
+            static_cast<int>(std::floor(camera.position.z()))
+        );
+
+        //shrink the radius until the chunks in it fit the budget, going by
+        //the average size of the meshes built so far
+        size_t   meshBytes = 0;
+        unsigned meshes    = 0;
+        for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+            if (it->second.everVisible) {
+                meshBytes += it->second.meshBytes;
+                ++meshes;
+            }
+        }
+
+        size_t const perChunk = CHUNK_BYTES + (meshes ? meshBytes / meshes : DEFAULT_MESH_BYTES);
+
+        radius_ = params_.loadRadius;
+        while (radius_ > 1 && countInRadius(radius_) * perChunk > params_.memoryBudget) {
+            --radius_;
+        }
+
+        //drop everything past the margin, then whatever is needed to get
+        //back under budget starting with the furthest chunks past the radius
+        for (auto it = entries_.begin(); it != entries_.end(); ) {
+            auto const next = std::next(it);
+            if (!inRadius_(it->first, radius_ + params_.unloadMargin)) {
+                evict_(it, unloaded);
+            }
+            it = next;
+        }
+
+        size_t memory = memoryInUse_();
+        if (memory > params_.memoryBudget) {
+            std::vector<std::pair<int, ChunkPos>> outside;
+            for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+                if (!inRadius_(it->first, radius_)) {
+                    int const dx = it->first.x - center_.x;
+                    int const dz = it->first.z - center_.z;
+                    outside.push_back(std::make_pair(dx*dx + dz*dz, it->first));
+                }
+            }
+
+            std::sort(outside.begin(), outside.end(),
+                [](std::pair<int, ChunkPos> const& a, std::pair<int, ChunkPos> const& b) {
+                    return a.first > b.first;
+                }
+            );
+
+            for (auto it = outside.begin(); it != outside.end() && memory > params_.memoryBudget; ++it) {
+                auto const entry = entries_.find(it->second);
+                if (entry->second.stage == STAGE_LOADED) {
+                    memory -= CHUNK_BYTES + entry->second.meshBytes;
+                }
+
+                evict_(entry, unloaded);
+            }
+        }
+
+        //save again whatever failed to save before
+        for (auto it = unsaved_.begin(); it != unsaved_.end(); ++it) {
+            auto const chunk = world_.find(it->first);
+            if (it->second || !chunk) {
+                continue;
+            }
+
+            ChunkPos const pos = it->first;
+            it->second = true;
+
+            ++inFlight_;
+            pool_.enqueue([this, pos, chunk] { save_(pos, chunk); });
+        }
+
+        //request everything in the radius; a chunk still being saved is
+        //requested once it's saved, so what's loaded isn't stale
+        auto const now = clock::now();
+        int const r = static_cast<int>(radius_);
+
+        for (int dx = -r; dx <= r; ++dx) {
+            for (int dz = -r; dz <= r; ++dz) {
+                ChunkPos const pos(center_.x + dx, center_.z + dz);
+                if (!inRadius_(pos, radius_) || entries_.count(pos) || unsaved_.count(pos)) {
+                    continue;
+                }
+
+                Entry& entry = entries_[pos];
+                entry.generation = nextGeneration_++;
+                entry.requested  = now;
+            }
+        }
+
+        //and rank the outstanding work from the new camera position
+        pending_ = std::priority_queue<Job>();
+
+        for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+            Entry& entry = it->second;
+            entry.priority = priority_(it->first);
+
+            if (entry.stage == STAGE_QUEUED) {
+                Job job;
+                job.priority = entry.priority;
+                job.type     = JOB_LOAD;
+                job.pos      = it->first;
+
+                pending_.push(job);
+            } else if (entry.stage == STAGE_LOADED && entry.dirty && !entry.meshing) {
+                //a finished mesh gets the chunk on screen sooner than a load
+                Job job;
+                job.priority = entry.priority * 0.5f;
+                job.type     = JOB_MESH;
+                job.pos      = it->first;
+
+                pending_.push(job);
+            }
+        }
+
+        dispatch_();
+
+        onUnload = onUnload_;
+    }//unlock
+
+    if (onUnload) {
+        std::for_each(unloaded.begin(), unloaded.end(), onUnload);
+    }
+}
+
+void
+world::ChunkStreamer::dispatch_()
+{
+    while (!stopping_ && inFlight_ < params_.maxInFlight && !pending_.empty()) {
+        Job const job = pending_.top();
+        pending_.pop();
+
+        auto const it = entries_.find(job.pos);
+        if (it == entries_.end()) {
+            continue;
+        }
+
+        Entry&         entry      = it->second;
+        ChunkPos const pos        = job.pos;
+        unsigned const generation = entry.generation;
+
+        if (job.type == JOB_LOAD) {
+            if (entry.stage != STAGE_QUEUED) {
+                continue;
+            }
+
+            entry.stage = STAGE_LOADING;
+
+            ++inFlight_;
+            pool_.enqueue([this, pos, generation] { load_(pos, generation); });
+        } else {
+            //stale duplicates and chunks still waiting on a neighbour; the
+            //neighbour queues the mesh again once it is lit
+            if (!entry.dirty || entry.meshing || !meshReady_(pos)) {
+                continue;
+            }
+
+            entry.dirty   = false;
+            entry.meshing = true;
+
+            ++inFlight_;
+            pool_.enqueue([this, pos, generation] { mesh_(pos, generation); });
+        }
+    }
+}
+
+void
+world::ChunkStreamer::finish_()
+{
+    boost::lock_guard<boost::mutex> lock(mutex_);
+
+    --inFlight_;
+    dispatch_();
+
+    finished_.notify_all();
+}
+
+void
+world::ChunkStreamer::load_(ChunkPos const pos, unsigned const generation)
+{
+    try {
+        World::chunk_ptr chunk;
+        if (storage_) {
+            chunk = storage_->load(pos);
+        }
+
+        bool const stored = !!chunk;
+        if (!stored) {
+            chunk.reset(new Chunk(pos));
+            generator_.generate(*chunk);
+        }
+
+        bool needsLight = false;
+
+        {//lock
+            boost::lock_guard<boost::mutex> lock(mutex_);
+
+            auto const it = entries_.find(pos);
+            if (it == entries_.end() || it->second.generation != generation) {
+                ++counters_.cancelled;
+            } else {
+                world_.insert(chunk);
+                it->second.stage = STAGE_LOADED;
+                ++counters_.completed;
+
+                if (stored) {
+                    //saved light is already consistent with its neighbours
+                    it->second.lit = true;
+                    markDirty_(pos);
+                    forNeighbours(pos, [this](ChunkPos n) { markDirty_(n); });
+                } else {
+                    light_.requestChunk(pos);
+                    needsLight = true;
+                }
+            }
+        }//unlock
+
+        if (needsLight) {
+            light_.schedule(pool_);
+        }
+    } catch (...) {
+        boost::lock_guard<boost::mutex> lock(mutex_);
+
+        //queued again by the next update
+        auto const it = entries_.find(pos);
+        if (it != entries_.end() && it->second.generation == generation && it->second.stage == STAGE_LOADING) {
+            it->second.stage = STAGE_QUEUED;
+        }
+
+        ++counters_.loadFailed;
+    }
+
+    finish_();
+}
+
+void
+world::ChunkStreamer::lit_(ChunkPos const pos)
+{
+    boost::lock_guard<boost::mutex> lock(mutex_);
+
+    auto const it = entries_.find(pos);
+    if (it == entries_.end() || it->second.stage != STAGE_LOADED) {
+        return;
+    }
+
+    //the first time a chunk is lit its neighbours lose the faces that were
+    //against air and may now be ready to mesh themselves
+    if (!it->second.lit) {
+        it->second.lit = true;
+        forNeighbours(pos, [this](ChunkPos n) { markDirty_(n); });
+    }
+
+    markDirty_(pos);
+    dispatch_();
+}
+
+std::unique_ptr<world::ChunkMesher>
+world::ChunkStreamer::acquireMesher_()
+{
+    {//lock
+        boost::lock_guard<boost::mutex> lock(mutex_);
+
+        if (!meshers_.empty()) {
+            std::unique_ptr<ChunkMesher> result(std::move(meshers_.back()));
+            meshers_.pop_back();
+            return result;
+        }
+    }//unlock
+
+    return std::unique_ptr<ChunkMesher>(new ChunkMesher());
+}
+
+void
+world::ChunkStreamer::releaseMesher_(std::unique_ptr<ChunkMesher> mesher)
+{
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    meshers_.push_back(std::move(mesher));
+}
+
+void
+world::ChunkStreamer::mesh_(ChunkPos const pos, unsigned const generation)
+{
+    try {
+        std::shared_ptr<ChunkMesh> mesh(new ChunkMesh());
+
+        std::unique_ptr<ChunkMesher> mesher = acquireMesher_();
+        mesher->build(world_, pos, *mesh);
+        releaseMesher_(std::move(mesher));
+
+        bool            current = false;
+        mesh_callback_t callback;
+
+        {//lock
+            boost::lock_guard<boost::mutex> lock(mutex_);
+
+            auto const it = entries_.find(pos);
+            if (it == entries_.end() || it->second.generation != generation) {
+                ++counters_.cancelled;
+            } else {
+                Entry& entry = it->second;
+
+                entry.meshing   = false;
+                entry.visible   = false;
+                entry.meshBytes = mesh->vertices.size() * sizeof(ChunkVertex);
+                ++counters_.completed;
+
+                //changed again while this mesh was being built
+                if (entry.dirty) {
+                    pushMesh_(pos, entry);
+                }
+
+                current  = true;
+                callback = onMeshReady_;
+            }
+        }//unlock
+
+        if (current) {
+            if (callback) {
+                callback(mesh, [this, pos, generation] { visible_(pos, generation); });
+            } else {
+                visible_(pos, generation);
+            }
+        }
+    } catch (...) {
+        boost::lock_guard<boost::mutex> lock(mutex_);
+
+        //meshed again by the next update
+        auto const it = entries_.find(pos);
+        if (it != entries_.end() && it->second.generation == generation && it->second.meshing) {
+            it->second.meshing = false;
+            it->second.dirty   = true;
+        }
+
+        ++counters_.meshFailed;
+    }
+
+    finish_();
+}
+
+void
+world::ChunkStreamer::visible_(ChunkPos const pos, unsigned const generation)
+{
+    boost::lock_guard<boost::mutex> lock(mutex_);
+
+    auto const it = entries_.find(pos);
+    if (it == entries_.end() || it->second.generation != generation) {
+        return;
+    }
+
+    Entry& entry = it->second;
+    entry.visible = true;
+
+    if (!entry.everVisible) {
+        entry.everVisible = true;
+
+        double const latency =
+            boost::chrono::duration<double>(clock::now() - entry.requested).count();
+
+        latencyTotal_ += latency;
+        ++latencyCount_;
+        counters_.latencyMax = std::max(counters_.latencyMax, latency);
+    }
+}
+
+world::StreamerMetrics
+world::ChunkStreamer::metrics() const
+{
+    boost::lock_guard<boost::mutex> lock(mutex_);
+
+    StreamerMetrics result = counters_;
+
+    result.pending     = static_cast<unsigned>(pending_.size());
+    result.inFlight    = inFlight_;
+    result.memoryInUse = memoryInUse_();
+    result.loadRadius  = radius_;
+    result.latencyMean = latencyCount_ ? latencyTotal_ / latencyCount_ : 0.0;
+    result.unsaved     = static_cast<unsigned>(unsaved_.size());
+
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+        result.loaded  += it->second.stage == STAGE_LOADED;
+        result.visible += it->second.visible;
+    }
+
+    return result;
+}
+
+bool
+world::ChunkStreamer::isIdle() const
+{
+    boost::lock_guard<boost::mutex> lock(mutex_);
+
+    if (inFlight_ != 0) {
+        return false;
+    }
+
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+        Entry const& entry = it->second;
+        if (entry.stage != STAGE_LOADED || !entry.lit || (entry.dirty && meshReady_(it->first))) {
+            return false;
+        }
+    }
+
+    return true;
+}
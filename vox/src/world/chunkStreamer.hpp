@@ -0,0 +1,228 @@
+#pragma once
+#ifndef VOX_WORLD_CHUNK_STREAMER_HPP
+#define VOX_WORLD_CHUNK_STREAMER_HPP
+
+#include <map>
+#include <queue>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <boost/thread.hpp>
+#include <boost/chrono.hpp>
+#include <Eigen/Core>
+
+#include "world.hpp"
+#include "chunkMesher.hpp"
+
+namespace vox {
+    namespace util { class ThreadPool; }
+
+    namespace world {
+
+    class LightEngine;
+    class RegionStorage;
+    class TerrainGenerator;
+
+    struct StreamerParams {
+        StreamerParams()
+            : loadRadius(8)
+            , unloadMargin(2)
+            , maxInFlight(4)
+            , memoryBudget(256 * 1024 * 1024)
+        {
+        }
+
+        unsigned loadRadius;   //in chunks around the camera
+        unsigned unloadMargin; //chunks are kept until this far outside the load radius
+        unsigned maxInFlight;  //jobs handed to the pool at once
+        size_t   memoryBudget; //bytes of chunk data and mesh vertices
+    };
+
+    struct StreamerMetrics {
+        StreamerMetrics()
+            : pending(0), inFlight(0), loaded(0), visible(0), memoryInUse(0)
+            , loadRadius(0), completed(0), cancelled(0), evicted(0)
+            , unsaved(0), saveFailed(0), loadFailed(0), meshFailed(0)
+            , latencyMean(0.0), latencyMax(0.0)
+        {
+        }
+
+        unsigned pending;     //jobs waiting for a worker
+        unsigned inFlight;    //jobs on a worker
+        unsigned loaded;      //chunks in the world
+        unsigned visible;     //chunks whose current mesh was uploaded
+        size_t   memoryInUse; //bytes of chunk data and mesh vertices
+        unsigned loadRadius;  //after shrinking to fit the memory budget
+        unsigned completed;   //jobs whose result was used
+        unsigned cancelled;   //jobs whose result was thrown away
+        unsigned evicted;     //chunks unloaded
+        unsigned unsaved;     //evicted chunks kept in the world until they're saved
+        unsigned saveFailed;  //saves that threw; the chunk is kept and saved again
+        unsigned loadFailed;  //loads that threw; the chunk is loaded again
+        unsigned meshFailed;  //meshes that threw; the chunk is meshed again
+        double   latencyMean; //seconds from a chunk being requested to its first mesh being visible
+        double   latencyMax;
+    };
+
+    //camera the load order is computed from; chunks inside the view cone
+    //are loaded before any outside of it
+    struct StreamCamera {
+        StreamCamera()
+            : position(0.0f, 0.0f, 0.0f)
+            , direction(0.0f, 0.0f, -1.0f)
+            , cosHalfFov(0.5f)
+        {
+        }
+
+        Eigen::Vector3f position;
+        Eigen::Vector3f direction;
+        float           cosHalfFov;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Keeps the chunks within a radius of the camera loaded and meshed.
+    //
+    // Each chunk goes through load (from storage, or generated), light and
+    // mesh jobs on the pool. update() ranks the outstanding jobs by whether
+    // the chunk is in view and then by distance, and at most maxInFlight of
+    // them are on the pool at once so a camera move re-ranks everything not
+    // yet started. A chunk that leaves the radius is dropped along with any
+    // of its jobs still queued; results of jobs already running are thrown
+    // away. A chunk is meshed once it and its loaded neighbours are lit, and
+    // again whenever lighting changes it or a neighbour.
+    //
+    // If the chunks in the load radius wouldn't fit the memory budget the
+    // radius shrinks until they do.
+    //
+    // With storage, an evicted chunk stays in the world until it has been
+    // saved, and isn't loaded again meanwhile. Jobs that throw are counted
+    // in the metrics and tried again on a later update; a save that keeps
+    // failing keeps its chunk in the world.
+    //
+    // Finished meshes are handed to the mesh callback on a worker thread,
+    // together with a function to call once the mesh is on screen; the
+    // renderer must not call it after the streamer is destroyed. The
+    // streamer takes over the light engine's chunk changed callback.
+    ////////////////////////////////////////////////////////////////////////////
+    class ChunkStreamer : private boost::noncopyable {
+    public:
+        typedef std::shared_ptr<ChunkMesh const>                                mesh_ptr;
+        typedef std::function<void (mesh_ptr mesh, std::function<void ()> onVisible)> mesh_callback_t;
+        typedef std::function<void (ChunkPos pos)>                              unload_callback_t;
+
+        //storage may be nullptr, in which case every chunk is generated
+        ChunkStreamer(
+            World&                  world,
+            LightEngine&            light,
+            TerrainGenerator const& generator,
+            RegionStorage*          storage,
+            util::ThreadPool&       pool,
+            StreamerParams const&   params = StreamerParams()
+        );
+
+        //waits for running jobs and lighting to finish
+        ~ChunkStreamer();
+
+        void setOnMeshReady(mesh_callback_t callback);
+        void setOnUnload(unload_callback_t callback);
+
+        //re-rank and start jobs for the current camera; call once per frame
+        void update(StreamCamera const& camera);
+
+        StreamerMetrics metrics() const;
+
+        //no jobs queued or running
+        bool isIdle() const;
+    private:
+        typedef boost::chrono::steady_clock clock;
+
+        enum Stage {
+            STAGE_QUEUED,  //waiting to be loaded
+            STAGE_LOADING,
+            STAGE_LOADED,  //in the world
+        };
+
+        struct Entry {
+            Entry() : stage(STAGE_QUEUED), generation(0), lit(false), dirty(false)
+                    , meshing(false), visible(false), everVisible(false), meshBytes(0), priority(0.0f) {}
+
+            Stage             stage;
+            unsigned          generation;  //changes when the entry is replaced
+            bool              lit;
+            bool              dirty;       //needs a new mesh
+            bool              meshing;
+            bool              visible;     //the latest mesh is on screen
+            bool              everVisible;
+            size_t            meshBytes;
+            float             priority;    //lower first
+            clock::time_point requested;
+        };
+
+        enum JobType { JOB_LOAD, JOB_MESH };
+
+        struct Job {
+            float    priority;
+            JobType  type;
+            ChunkPos pos;
+
+            bool operator<(Job const& rhs) const {
+                return priority > rhs.priority; //lowest on top of the heap
+            }
+        };
+
+        typedef std::map<ChunkPos, Entry> entries_t;
+
+        float priority_(ChunkPos pos) const;
+        bool  inRadius_(ChunkPos pos, unsigned radius) const;
+        bool  meshReady_(ChunkPos pos) const;
+
+        size_t memoryInUse_() const;
+
+        void markDirty_(ChunkPos pos);
+        void pushMesh_(ChunkPos pos, Entry const& entry);
+        void evict_(entries_t::iterator it, std::vector<ChunkPos>& unloaded);
+        void save_(ChunkPos pos, World::chunk_ptr chunk);
+        void dispatch_();
+        void finish_();
+
+        void load_(ChunkPos pos, unsigned generation);
+        void mesh_(ChunkPos pos, unsigned generation);
+        void lit_(ChunkPos pos);
+        void visible_(ChunkPos pos, unsigned generation);
+
+        std::unique_ptr<ChunkMesher> acquireMesher_();
+        void releaseMesher_(std::unique_ptr<ChunkMesher> mesher);
+
+        World&                  world_;
+        LightEngine&            light_;
+        TerrainGenerator const& generator_;
+        RegionStorage*          storage_;
+        util::ThreadPool&       pool_;
+        StreamerParams const    params_;
+
+        mutable boost::mutex      mutex_;
+        boost::condition_variable finished_;
+
+        mesh_callback_t   onMeshReady_;
+        unload_callback_t onUnload_;
+
+        StreamCamera             camera_;
+        ChunkPos                 center_;
+        unsigned                 radius_;
+        unsigned                 nextGeneration_;
+        entries_t                entries_;
+        std::priority_queue<Job> pending_;
+        std::map<ChunkPos, bool> unsaved_; //evicted but still in the world; true while being saved
+        unsigned                 inFlight_;
+        bool                     stopping_;
+        StreamerMetrics          counters_;
+        double                   latencyTotal_;
+        unsigned                 latencyCount_;
+
+        std::vector<std::unique_ptr<ChunkMesher>> meshers_;
+    };
+
+    } //namespace world
+} //namespace vox
+
+#endif //VOX_WORLD_CHUNK_STREAMER_HPP
@@ -0,0 +1,497 @@
+#include "common.hpp"
+#include "lighting.hpp"
+
+#include <deque>
+
+#include "../util/threadPool.hpp"
+
+namespace world = ::vox::world;
+
+namespace {
+    enum Channel {
+        CHANNEL_SKY,
+        CHANNEL_BLOCK,
+    };
+
+    int const DX[6] = {1, -1, 0,  0, 0,  0};
+    int const DY[6] = {0,  0, 1, -1, 0,  0};
+    int const DZ[6] = {0,  0, 0,  0, 1, -1};
+
+    unsigned const DIR_DOWN = 3;
+
+    struct Node {
+        Node(int x, int y, int z, unsigned value = 0) : x(x), y(y), z(z), value(value) {}
+
+        int      x, y, z;
+        unsigned value; //light before removal; unused when adding
+    };
+
+    typedef std::deque<Node> queue_t;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Light flood fill over world positions. Recently used chunks are kept in
+    // a small cache so crossing chunk borders doesn't hit the world map.
+    ////////////////////////////////////////////////////////////////////////////
+    class Propagator : private boost::noncopyable {
+    public:
+        explicit Propagator(world::World& w)
+            : world_(w), chunk_(nullptr), index_(0)
+        {
+        }
+
+        //point at the block at (x, y, z); false if it isn't loaded
+        bool seek(int x, int y, int z) {
+            if (y < 0 || y >= static_cast<int>(world::CHUNK_SIZE_Y)) {
+                return false;
+            }
+
+            auto const pos = world::ChunkPos::fromBlock(x, z);
+            chunk_ = find_(pos);
+
+            if (!chunk_) {
+                return false;
+            }
+
+            index_ = world::Chunk::index(x - pos.blockX(), y, z - pos.blockZ());
+            return true;
+        }
+
+        world::BlockId block() const { return chunk_->blocks()[index_]; }
+
+        unsigned get(Channel c) const {
+            return c == CHANNEL_SKY ? chunk_->skyLight(index_) : chunk_->blockLight(index_);
+        }
+
+        void set(Channel c, unsigned value) {
+            if (c == CHANNEL_SKY) {
+                chunk_->setSkyLight(index_, value);
+            } else {
+                chunk_->setBlockLight(index_, value);
+            }
+
+            touch(chunk_->position());
+        }
+
+        //note that the light of the chunk at pos changed
+        void touch(world::ChunkPos pos) {
+            if (std::find(touched_.begin(), touched_.end(), pos) == touched_.end()) {
+                touched_.push_back(pos);
+            }
+        }
+
+        void add(Channel c) {
+            while (!addQueue(c).empty()) {
+                Node const node = addQueue(c).front();
+                addQueue(c).pop_front();
+
+                if (!seek(node.x, node.y, node.z)) {
+                    continue;
+                }
+
+                unsigned const light = get(c);
+                if (light <= 1) {
+                    continue;
+                }
+
+                for (unsigned dir = 0; dir < 6; ++dir) {
+                    int const x = node.x + DX[dir];
+                    int const y = node.y + DY[dir];
+                    int const z = node.z + DZ[dir];
+
+                    if (!seek(x, y, z) || world::isOpaque(block())) {
+                        continue;
+                    }
+
+                    //full sky light falls straight down without dimming
+                    unsigned const next =
+                        (c == CHANNEL_SKY && dir == DIR_DOWN && light == world::LIGHT_MAX) ?
+                            world::LIGHT_MAX : light - 1;
+
+                    if (get(c) < next) {
+                        set(c, next);
+                        addQueue(c).push_back(Node(x, y, z));
+                    }
+                }
+            }
+        }
+
+        void remove(Channel c) {
+            while (!removeQueue(c).empty()) {
+                Node const node = removeQueue(c).front();
+                removeQueue(c).pop_front();
+
+                for (unsigned dir = 0; dir < 6; ++dir) {
+                    int const x = node.x + DX[dir];
+                    int const y = node.y + DY[dir];
+                    int const z = node.z + DZ[dir];
+
+                    if (!seek(x, y, z)) {
+                        continue;
+                    }
+
+                    unsigned const light = get(c);
+                    if (light == 0) {
+                        continue;
+                    }
+
+                    bool const dependent = light < node.value || (
+                        c == CHANNEL_SKY && dir == DIR_DOWN &&
+                        node.value == world::LIGHT_MAX && light == world::LIGHT_MAX
+                    );
+
+                    if (dependent) {
+                        set(c, 0);
+                        removeQueue(c).push_back(Node(x, y, z, light));
+
+                        //emitters are their own source; put them back
+                        unsigned const emission = world::lightEmission(block());
+                        if (c == CHANNEL_BLOCK && emission > 0) {
+                            set(c, emission);
+                            addQueue(c).push_back(Node(x, y, z));
+                        }
+                    } else {
+                        //lit by some other source; spread it into the gap
+                        addQueue(c).push_back(Node(x, y, z));
+                    }
+                }
+            }
+        }
+
+        //queue the block at (x, y, z) to spread its light if it has any
+        void pushIfLit(int x, int y, int z) {
+            if (!seek(x, y, z)) {
+                return;
+            }
+
+            if (get(CHANNEL_SKY) > 1) {
+                addQueue(CHANNEL_SKY).push_back(Node(x, y, z));
+            }
+
+            if (get(CHANNEL_BLOCK) > 1) {
+                addQueue(CHANNEL_BLOCK).push_back(Node(x, y, z));
+            }
+        }
+
+        queue_t& addQueue(Channel c)    { return c == CHANNEL_SKY ? skyAdd_ : blockAdd_; }
+        queue_t& removeQueue(Channel c) { return c == CHANNEL_SKY ? skyRemove_ : blockRemove_; }
+
+        std::vector<world::ChunkPos> const& touched() const { return touched_; }
+    private:
+        world::Chunk* find_(world::ChunkPos pos) {
+            if (chunk_ && chunk_->position() == pos) {
+                return chunk_;
+            }
+
+            for (auto it = cache_.begin(); it != cache_.end(); ++it) {
+                if ((*it)->position() == pos) {
+                    return it->get();
+                }
+            }
+
+            auto const chunk = world_.find(pos);
+            if (chunk) {
+                cache_.push_back(chunk);
+            }
+
+            return chunk.get();
+        }
+
+        world::World&                        world_;
+        world::Chunk*                        chunk_;
+        unsigned                             index_;
+        std::vector<world::World::chunk_ptr> cache_;
+        std::vector<world::ChunkPos>         touched_;
+
+        queue_t skyAdd_,    blockAdd_;
+        queue_t skyRemove_, blockRemove_;
+    };
+
+    void lightChunk(Propagator& p, world::World& w, world::ChunkPos pos) {
+        using namespace world;
+
+        auto const chunk = w.find(pos);
+        if (!chunk) {
+            return;
+        }
+
+        std::fill(chunk->light(), chunk->light() + CHUNK_VOLUME, static_cast<unsigned char>(0));
+        p.touch(pos);
+
+        //sky light: every block above the first opaque block of a column is
+        //fully lit. Only those that have a shaded horizontal neighbour need to
+        //spread any further.
+        unsigned top[CHUNK_SIZE_X][CHUNK_SIZE_Z];
+
+        for (unsigned x = 0; x < CHUNK_SIZE_X; ++x) {
+            for (unsigned z = 0; z < CHUNK_SIZE_Z; ++z) {
+                BlockId const* const column = chunk->column(x, z);
+
+                unsigned y = CHUNK_SIZE_Y;
+                while (y > 0 && !isOpaque(column[y - 1])) {
+                    --y;
+                }
+
+                top[x][z] = y;
+
+                unsigned char* const light = chunk->light() + Chunk::index(x, 0, z);
+                for (; y < CHUNK_SIZE_Y; ++y) {
+                    light[y] = static_cast<unsigned char>(LIGHT_MAX << 4);
+                }
+            }
+        }
+
+        int const bx = pos.blockX();
+        int const bz = pos.blockZ();
+
+        //light only spreads over the border into loaded neighbours; the others
+        //pull it in when they are lit themselves
+        bool const loaded[4] = {
+            !!w.find(ChunkPos(pos.x - 1, pos.z)), !!w.find(ChunkPos(pos.x + 1, pos.z)),
+            !!w.find(ChunkPos(pos.x, pos.z - 1)), !!w.find(ChunkPos(pos.x, pos.z + 1)),
+        };
+
+        for (unsigned x = 0; x < CHUNK_SIZE_X; ++x) {
+            for (unsigned z = 0; z < CHUNK_SIZE_Z; ++z) {
+                unsigned reach = 0;
+
+                if (x > 0)                reach = std::max(reach, top[x - 1][z]);
+                else if (loaded[0])       reach = CHUNK_SIZE_Y;
+                if (x + 1 < CHUNK_SIZE_X) reach = std::max(reach, top[x + 1][z]);
+                else if (loaded[1])       reach = CHUNK_SIZE_Y;
+                if (z > 0)                reach = std::max(reach, top[x][z - 1]);
+                else if (loaded[2])       reach = CHUNK_SIZE_Y;
+                if (z + 1 < CHUNK_SIZE_Z) reach = std::max(reach, top[x][z + 1]);
+                else if (loaded[3])       reach = CHUNK_SIZE_Y;
+
+                for (unsigned y = top[x][z]; y < reach; ++y) {
+                    p.addQueue(CHANNEL_SKY).push_back(Node(bx + x, y, bz + z));
+                }
+            }
+        }
+
+        //block light from emitters
+        for (unsigned i = 0; i < CHUNK_VOLUME; ++i) {
+            unsigned const emission = lightEmission(chunk->blocks()[i]);
+            if (emission == 0) {
+                continue;
+            }
+
+            chunk->setBlockLight(i, emission);
+
+            unsigned const y = i % CHUNK_SIZE_Y;
+            unsigned const z = (i / CHUNK_SIZE_Y) % CHUNK_SIZE_Z;
+            unsigned const x = i / (CHUNK_SIZE_Y*CHUNK_SIZE_Z);
+            p.addQueue(CHANNEL_BLOCK).push_back(Node(bx + x, y, bz + z));
+        }
+
+        //let light already in the neighbours flow across the border
+        int const lastX = static_cast<int>(CHUNK_SIZE_X);
+        int const lastZ = static_cast<int>(CHUNK_SIZE_Z);
+
+        for (int y = 0; y < static_cast<int>(CHUNK_SIZE_Y); ++y) {
+            for (int i = 0; i < lastZ; ++i) {
+                p.pushIfLit(bx - 1,     y, bz + i);
+                p.pushIfLit(bx + lastX, y, bz + i);
+            }
+
+            for (int i = 0; i < lastX; ++i) {
+                p.pushIfLit(bx + i, y, bz - 1);
+                p.pushIfLit(bx + i, y, bz + lastZ);
+            }
+        }
+
+        p.add(CHANNEL_SKY);
+        p.add(CHANNEL_BLOCK);
+    }
+
+    void blockChanged(Propagator& p, int x, int y, int z, world::BlockId oldId) {
+        using namespace world;
+
+        if (!p.seek(x, y, z)) {
+            return;
+        }
+
+        BlockId const id = p.block();
+
+        //light only cares about opacity and emission
+        if (isOpaque(id) == isOpaque(oldId) && lightEmission(id) == lightEmission(oldId)) {
+            return;
+        }
+
+        //whatever light was here may have been feeding the neighbourhood
+        unsigned const oldBlock = p.get(CHANNEL_BLOCK);
+        if (oldBlock > 0) {
+            p.set(CHANNEL_BLOCK, 0);
+            p.removeQueue(CHANNEL_BLOCK).push_back(Node(x, y, z, oldBlock));
+        }
+
+        unsigned const oldSky = p.get(CHANNEL_SKY);
+        if (oldSky > 0 && isOpaque(id)) {
+            p.set(CHANNEL_SKY, 0);
+            p.removeQueue(CHANNEL_SKY).push_back(Node(x, y, z, oldSky));
+        }
+
+        p.remove(CHANNEL_SKY);
+        p.remove(CHANNEL_BLOCK);
+
+        if (p.seek(x, y, z)) {
+            unsigned const emission = lightEmission(id);
+            if (emission > 0) {
+                p.set(CHANNEL_BLOCK, emission);
+                p.addQueue(CHANNEL_BLOCK).push_back(Node(x, y, z));
+            }
+
+            //a transparent block lets the neighbours' light back in
+            if (!isOpaque(id)) {
+                if (y + 1 == static_cast<int>(CHUNK_SIZE_Y)) {
+                    p.set(CHANNEL_SKY, LIGHT_MAX);
+                    p.addQueue(CHANNEL_SKY).push_back(Node(x, y, z));
+                }
+
+                for (unsigned dir = 0; dir < 6; ++dir) {
+                    p.pushIfLit(x + DX[dir], y + DY[dir], z + DZ[dir]);
+                }
+            }
+        }
+
+        p.add(CHANNEL_SKY);
+        p.add(CHANNEL_BLOCK);
+    }
+} //namespace anon
+
+world::LightEngine::LightEngine(World& world)
+    : world_(world)
+    , onChunkChanged_()
+    , running_(false)
+{
+}
+
+world::LightEngine::~LightEngine()
+{
+    boost::unique_lock<boost::mutex> lock(mutex_);
+    while (running_) {
+        idle_.wait(lock);
+    }
+}
+
+void
+world::LightEngine::setOnChunkChanged(callback_t callback)
+{
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    onChunkChanged_ = callback;
+}
+
+void
+world::LightEngine::requestChunk(ChunkPos pos)
+{
+    Request request;
+    request.type  = Request::REQUEST_CHUNK;
+    request.chunk = pos;
+    request.x = request.y = request.z = 0;
+    request.oldId = BLOCK_AIR;
+
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    pending_.push_back(request);
+}
+
+void
+world::LightEngine::requestBlockChange(int x, int y, int z, BlockId oldId)
+{
+    Request request;
+    request.type  = Request::REQUEST_BLOCK;
+    request.chunk = ChunkPos::fromBlock(x, z);
+    request.x     = x;
+    request.y     = y;
+    request.z     = z;
+    request.oldId = oldId;
+
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    pending_.push_back(request);
+}
+
+bool
+world::LightEngine::isIdle() const
+{
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    return !running_ && pending_.empty();
+}
+
+void
+world::LightEngine::process()
+{
+    std::vector<Request> requests;
+
+    {//lock
+        boost::lock_guard<boost::mutex> lock(mutex_);
+        assert(!running_ && "process() while a batch is scheduled");
+        requests.swap(pending_);
+    }//unlock
+
+    run_(requests);
+}
+
+void
+world::LightEngine::schedule(util::ThreadPool& pool)
+{
+    {//lock
+        boost::lock_guard<boost::mutex> lock(mutex_);
+        if (running_ || pending_.empty()) {
+            return;
+        }
+
+        running_ = true;
+    }//unlock
+
+    pool.enqueue([this] {
+        for (;;) {
+            std::vector<Request> requests;
+
+            {//lock
+                boost::lock_guard<boost::mutex> lock(mutex_);
+                if (pending_.empty()) {
+                    running_ = false;
+                    idle_.notify_all();
+                    return;
+                }
+
+                requests.swap(pending_);
+            }//unlock
+
+            try {
+                run_(requests);
+            } catch (...) {
+                //nothing may wait on a batch that won't finish; the pool
+                //keeps the exception for its owner
+                boost::lock_guard<boost::mutex> lock(mutex_);
+                running_ = false;
+                idle_.notify_all();
+                throw;
+            }
+        }
+    });
+}
+
+void
+world::LightEngine::run_(std::vector<Request> const& requests)
+{
+    Propagator propagator(world_);
+
+    for (auto it = requests.begin(); it != requests.end(); ++it) {
+        if (it->type == Request::REQUEST_CHUNK) {
+            lightChunk(propagator, world_, it->chunk);
+        } else {
+            blockChanged(propagator, it->x, it->y, it->z, it->oldId);
+        }
+    }
+
+    callback_t callback;
+    {//lock
+        boost::lock_guard<boost::mutex> lock(mutex_);
+        callback = onChunkChanged_;
+    }//unlock
+
+    if (callback) {
+        auto const& touched = propagator.touched();
+        std::for_each(touched.begin(), touched.end(), callback);
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+#ifndef VOX_WORLD_LIGHTING_HPP
+#define VOX_WORLD_LIGHTING_HPP
+
+#include <vector>
+#include <functional>
+#include <boost/thread.hpp>
+
+#include "world.hpp"
+
+namespace vox {
+    namespace util { class ThreadPool; }
+
+    namespace world {
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Breadth first flood fill of sky and block light. Light spreads across
+    // chunk borders into whatever neighbours are loaded, and block edits are
+    // applied incrementally: a removal pass darkens everything that depended
+    // on the old light, then an add pass refills it from the remaining
+    // sources.
+    //
+    // Requests are queued and run either on the calling thread (process) or
+    // on a pool worker (schedule). At most one batch runs at a time so light
+    // writes spilling into neighbouring chunks never race each other.
+    ////////////////////////////////////////////////////////////////////////////
+    class LightEngine : private boost::noncopyable {
+    public:
+        typedef std::function<void (ChunkPos)> callback_t;
+
+        explicit LightEngine(World& world);
+        //waits for a scheduled batch to finish
+        ~LightEngine();
+
+        //called on the lighting thread for every chunk whose light changed
+        void setOnChunkChanged(callback_t callback);
+
+        //compute light for a chunk that was just inserted into the world
+        void requestChunk(ChunkPos pos);
+        //relight after the block at (x, y, z) was changed from oldId to its
+        //current value
+        void requestBlockChange(int x, int y, int z, BlockId oldId);
+
+        //run pending requests on the calling thread
+        void process();
+        //run pending requests on a worker of pool. If a batch throws the
+        //rest of it is dropped and the exception goes to pool.takeError()
+        void schedule(util::ThreadPool& pool);
+
+        bool isIdle() const;
+    private:
+        struct Request {
+            enum Type { REQUEST_CHUNK, REQUEST_BLOCK } type;
+
+            ChunkPos chunk;
+            int      x, y, z;
+            BlockId  oldId;
+        };
+
+        void run_(std::vector<Request> const& requests);
+
+        World&     world_;
+        callback_t onChunkChanged_;
+
+        mutable boost::mutex      mutex_;
+        boost::condition_variable idle_;
+        std::vector<Request>      pending_;
+        bool                      running_;
+    };
+
+    } //namespace world
+} //namespace vox
+
+#endif //VOX_WORLD_LIGHTING_HPP
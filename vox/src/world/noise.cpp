@@ -0,0 +1,468 @@
+#include "common.hpp"
+#include "noise.hpp"
+
+#include <cmath>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE4_1__)
+#   define VOX_NOISE_SSE41
+#   include <smmintrin.h>
+#endif
+
+#if defined(VOX_MSVC)
+#   include <intrin.h>
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#   include <cpuid.h>
+#endif
+
+namespace world = ::vox::world;
+
+namespace {
+    unsigned const PRIME_X  = 501125321u;
+    unsigned const PRIME_Y  = 1136930381u;
+    unsigned const PRIME_Z  = 1720413743u;
+    unsigned const HASH_MUL = 0x27d4eb2du;
+
+    float const F2 = 0.366025403784f; //(sqrt(3) - 1) / 2
+    float const G2 = 0.211324865405f; //(3 - sqrt(3)) / 6
+    float const F3 = 1.0f / 3.0f;
+    float const G3 = 1.0f / 6.0f;
+
+    float const SCALE2 = 70.0f;
+    float const SCALE3 = 32.0f;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // scalar
+    ////////////////////////////////////////////////////////////////////////////
+    inline unsigned hash(unsigned seed, unsigned xp, unsigned yp) {
+        unsigned const h = (seed ^ xp ^ yp) * HASH_MUL;
+        return h ^ (h >> 15);
+    }
+
+    inline unsigned hash(unsigned seed, unsigned xp, unsigned yp, unsigned zp) {
+        unsigned const h = (seed ^ xp ^ yp ^ zp) * HASH_MUL;
+        return h ^ (h >> 15);
+    }
+
+    //one of 8 directions: the 4 diagonals and the 4 axes
+    inline float grad(unsigned h, float x, float y) {
+        float const a = (h & 1) ? -x : x;
+        float const b = (h & 2) ? -y : y;
+        return (h & 4) ? a + b : ((h & 8) ? a : b);
+    }
+
+    //the 12 cube edge directions of improved perlin noise
+    inline float grad(unsigned h, float x, float y, float z) {
+        h &= 15;
+        float const u = h < 8 ? x : y;
+        float const v = h < 4 ? y : ((h & 13) == 12 ? x : z);
+        return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
+    }
+
+    inline float corner(unsigned h, float x, float y) {
+        float t = std::max(0.5f - x*x - y*y, 0.0f);
+        t *= t;
+        return t*t*grad(h, x, y);
+    }
+
+    inline float corner(unsigned h, float x, float y, float z) {
+        float t = std::max(0.6f - x*x - y*y - z*z, 0.0f);
+        t *= t;
+        return t*t*grad(h, x, y, z);
+    }
+
+    float simplex2(unsigned seed, float x, float y) {
+        float const s  = (x + y) * F2;
+        float const fi = std::floor(x + s);
+        float const fj = std::floor(y + s);
+        float const t  = (fi + fj) * G2;
+
+        float const x0 = x - (fi - t);
+        float const y0 = y - (fj - t);
+
+        float const i1 = x0 > y0 ? 1.0f : 0.0f;
+        float const j1 = 1.0f - i1;
+
+        float const x1 = x0 - i1 + G2;
+        float const y1 = y0 - j1 + G2;
+        float const x2 = x0 - 1.0f + 2.0f*G2;
+        float const y2 = y0 - 1.0f + 2.0f*G2;
+
+        unsigned const ip = static_cast<unsigned>(static_cast<int>(fi)) * PRIME_X;
+        unsigned const jp = static_cast<unsigned>(static_cast<int>(fj)) * PRIME_Y;
+
+        unsigned const h0 = hash(seed, ip, jp);
+        unsigned const h1 = hash(seed, ip + (i1 != 0.0f ? PRIME_X : 0), jp + (j1 != 0.0f ? PRIME_Y : 0));
+        unsigned const h2 = hash(seed, ip + PRIME_X, jp + PRIME_Y);
+
+        return SCALE2 * (corner(h0, x0, y0) + corner(h1, x1, y1) + corner(h2, x2, y2));
+    }
+
+    float simplex3(unsigned seed, float x, float y, float z) {
+        float const s  = (x + y + z) * F3;
+        float const fi = std::floor(x + s);
+        float const fj = std::floor(y + s);
+        float const fk = std::floor(z + s);
+        float const t  = (fi + fj + fk) * G3;
+
+        float const x0 = x - (fi - t);
+        float const y0 = y - (fj - t);
+        float const z0 = z - (fk - t);
+
+        //offsets of the second and third simplex corners, branch free so the
+        //vector version can do the same thing with masks
+        bool const xy = x0 >= y0;
+        bool const xz = x0 >= z0;
+        bool const yz = y0 >= z0;
+
+        unsigned const i1 = xy && xz,   j1 = !xy && yz,  k1 = !xz && !yz;
+        unsigned const i2 = xy || xz,   j2 = !xy || yz,  k2 = !xz || !yz;
+
+        float const x1 = x0 - i1 + G3,        y1 = y0 - j1 + G3,        z1 = z0 - k1 + G3;
+        float const x2 = x0 - i2 + 2.0f*G3,   y2 = y0 - j2 + 2.0f*G3,   z2 = z0 - k2 + 2.0f*G3;
+        float const x3 = x0 - 1.0f + 3.0f*G3, y3 = y0 - 1.0f + 3.0f*G3, z3 = z0 - 1.0f + 3.0f*G3;
+
+        unsigned const ip = static_cast<unsigned>(static_cast<int>(fi)) * PRIME_X;
+        unsigned const jp = static_cast<unsigned>(static_cast<int>(fj)) * PRIME_Y;
+        unsigned const kp = static_cast<unsigned>(static_cast<int>(fk)) * PRIME_Z;
+
+        unsigned const h0 = hash(seed, ip, jp, kp);
+        unsigned const h1 = hash(seed, ip + i1*PRIME_X, jp + j1*PRIME_Y, kp + k1*PRIME_Z);
+        unsigned const h2 = hash(seed, ip + i2*PRIME_X, jp + j2*PRIME_Y, kp + k2*PRIME_Z);
+        unsigned const h3 = hash(seed, ip + PRIME_X, jp + PRIME_Y, kp + PRIME_Z);
+
+        return SCALE3 * (
+            corner(h0, x0, y0, z0) + corner(h1, x1, y1, z1) +
+            corner(h2, x2, y2, z2) + corner(h3, x3, y3, z3)
+        );
+    }
+
+#if defined(VOX_NOISE_SSE41)
+    ////////////////////////////////////////////////////////////////////////////
+    // sse4.1, 4 points at a time; mirrors the scalar code above
+    ////////////////////////////////////////////////////////////////////////////
+    inline __m128i hash4(__m128i seed, __m128i xp, __m128i yp) {
+        __m128i const h = _mm_mullo_epi32(
+            _mm_xor_si128(seed, _mm_xor_si128(xp, yp)), _mm_set1_epi32(HASH_MUL)
+        );
+        return _mm_xor_si128(h, _mm_srli_epi32(h, 15));
+    }
+
+    inline __m128i hash4(__m128i seed, __m128i xp, __m128i yp, __m128i zp) {
+        __m128i const h = _mm_mullo_epi32(
+            _mm_xor_si128(_mm_xor_si128(seed, xp), _mm_xor_si128(yp, zp)), _mm_set1_epi32(HASH_MUL)
+        );
+        return _mm_xor_si128(h, _mm_srli_epi32(h, 15));
+    }
+
+    //all ones in lanes where (h & bit) != 0
+    inline __m128 bitMask4(__m128i h, int bit) {
+        __m128i const b = _mm_set1_epi32(bit);
+        return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(h, b), b));
+    }
+
+    //negate lanes where (h & bit) != 0
+    inline __m128 flipSign4(__m128 v, __m128i h, int bit) {
+        __m128 const sign = _mm_and_ps(bitMask4(h, bit), _mm_set1_ps(-0.0f));
+        return _mm_xor_ps(v, sign);
+    }
+
+    inline __m128 grad4(__m128i h, __m128 x, __m128 y) {
+        __m128 const a    = flipSign4(x, h, 1);
+        __m128 const b    = flipSign4(y, h, 2);
+        __m128 const axis = _mm_blendv_ps(b, a, bitMask4(h, 8));
+        return _mm_blendv_ps(axis, _mm_add_ps(a, b), bitMask4(h, 4));
+    }
+
+    inline __m128 grad4(__m128i h, __m128 x, __m128 y, __m128 z) {
+        h = _mm_and_si128(h, _mm_set1_epi32(15));
+
+        __m128 const lt8  = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(8)));
+        __m128 const lt4  = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(4)));
+        __m128 const is12 = _mm_castsi128_ps(
+            _mm_cmpeq_epi32(_mm_and_si128(h, _mm_set1_epi32(13)), _mm_set1_epi32(12))
+        );
+
+        __m128 const u = _mm_blendv_ps(y, x, lt8);
+        __m128 const v = _mm_blendv_ps(_mm_blendv_ps(z, x, is12), y, lt4);
+
+        return _mm_add_ps(flipSign4(u, h, 1), flipSign4(v, h, 2));
+    }
+
+    inline __m128 corner4(__m128i h, __m128 x, __m128 y) {
+        __m128 t = _mm_sub_ps(_mm_set1_ps(0.5f), _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)));
+        t = _mm_max_ps(t, _mm_setzero_ps());
+        t = _mm_mul_ps(t, t);
+        return _mm_mul_ps(_mm_mul_ps(t, t), grad4(h, x, y));
+    }
+
+    inline __m128 corner4(__m128i h, __m128 x, __m128 y, __m128 z) {
+        __m128 t = _mm_sub_ps(
+            _mm_set1_ps(0.6f),
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z))
+        );
+        t = _mm_max_ps(t, _mm_setzero_ps());
+        t = _mm_mul_ps(t, t);
+        return _mm_mul_ps(_mm_mul_ps(t, t), grad4(h, x, y, z));
+    }
+
+    //1.0f in lanes where mask is set, 0.0f elsewhere
+    inline __m128 maskToOne4(__m128 mask) {
+        return _mm_and_ps(mask, _mm_set1_ps(1.0f));
+    }
+
+    //PRIME in lanes where mask is set, 0 elsewhere
+    inline __m128i maskToPrime4(__m128 mask, unsigned prime) {
+        return _mm_and_si128(_mm_castps_si128(mask), _mm_set1_epi32(prime));
+    }
+
+    __m128 simplex2x4(__m128i seed, __m128 x, __m128 y) {
+        __m128 const s  = _mm_mul_ps(_mm_add_ps(x, y), _mm_set1_ps(F2));
+        __m128 const fi = _mm_floor_ps(_mm_add_ps(x, s));
+        __m128 const fj = _mm_floor_ps(_mm_add_ps(y, s));
+        __m128 const t  = _mm_mul_ps(_mm_add_ps(fi, fj), _mm_set1_ps(G2));
+
+        __m128 const x0 = _mm_sub_ps(x, _mm_sub_ps(fi, t));
+        __m128 const y0 = _mm_sub_ps(y, _mm_sub_ps(fj, t));
+
+        __m128 const mask = _mm_cmpgt_ps(x0, y0);
+        __m128 const i1   = maskToOne4(mask);
+        __m128 const j1   = _mm_sub_ps(_mm_set1_ps(1.0f), i1);
+
+        __m128 const g2  = _mm_set1_ps(G2);
+        __m128 const g22 = _mm_set1_ps(2.0f*G2 - 1.0f);
+
+        __m128 const x1 = _mm_add_ps(_mm_sub_ps(x0, i1), g2);
+        __m128 const y1 = _mm_add_ps(_mm_sub_ps(y0, j1), g2);
+        __m128 const x2 = _mm_add_ps(x0, g22);
+        __m128 const y2 = _mm_add_ps(y0, g22);
+
+        __m128i const ip = _mm_mullo_epi32(_mm_cvttps_epi32(fi), _mm_set1_epi32(PRIME_X));
+        __m128i const jp = _mm_mullo_epi32(_mm_cvttps_epi32(fj), _mm_set1_epi32(PRIME_Y));
+
+        __m128i const px = _mm_set1_epi32(PRIME_X);
+        __m128i const py = _mm_set1_epi32(PRIME_Y);
+
+        __m128i const h0 = hash4(seed, ip, jp);
+        __m128i const h1 = hash4(seed,
+            _mm_add_epi32(ip, maskToPrime4(mask, PRIME_X)),
+            _mm_add_epi32(jp, _mm_andnot_si128(_mm_castps_si128(mask), py))
+        );
+        __m128i const h2 = hash4(seed, _mm_add_epi32(ip, px), _mm_add_epi32(jp, py));
+
+        __m128 const n = _mm_add_ps(
+            _mm_add_ps(corner4(h0, x0, y0), corner4(h1, x1, y1)),
+            corner4(h2, x2, y2)
+        );
+
+        return _mm_mul_ps(n, _mm_set1_ps(SCALE2));
+    }
+
+    __m128 simplex3x4(__m128i seed, __m128 x, __m128 y, __m128 z) {
+        __m128 const s  = _mm_mul_ps(_mm_add_ps(_mm_add_ps(x, y), z), _mm_set1_ps(F3));
+        __m128 const fi = _mm_floor_ps(_mm_add_ps(x, s));
+        __m128 const fj = _mm_floor_ps(_mm_add_ps(y, s));
+        __m128 const fk = _mm_floor_ps(_mm_add_ps(z, s));
+        __m128 const t  = _mm_mul_ps(_mm_add_ps(_mm_add_ps(fi, fj), fk), _mm_set1_ps(G3));
+
+        __m128 const x0 = _mm_sub_ps(x, _mm_sub_ps(fi, t));
+        __m128 const y0 = _mm_sub_ps(y, _mm_sub_ps(fj, t));
+        __m128 const z0 = _mm_sub_ps(z, _mm_sub_ps(fk, t));
+
+        __m128 const xy = _mm_cmpge_ps(x0, y0);
+        __m128 const xz = _mm_cmpge_ps(x0, z0);
+        __m128 const yz = _mm_cmpge_ps(y0, z0);
+
+        __m128 const mi1 = _mm_and_ps(xy, xz);
+        __m128 const mj1 = _mm_andnot_ps(xy, yz);
+        __m128 const mk1 = _mm_andnot_ps(_mm_or_ps(xz, yz), _mm_castsi128_ps(_mm_set1_epi32(-1)));
+        __m128 const mi2 = _mm_or_ps(xy, xz);
+        __m128 const mj2 = _mm_or_ps(_mm_andnot_ps(xy, _mm_castsi128_ps(_mm_set1_epi32(-1))), yz);
+        __m128 const mk2 = _mm_andnot_ps(_mm_and_ps(xz, yz), _mm_castsi128_ps(_mm_set1_epi32(-1)));
+
+        __m128 const g3  = _mm_set1_ps(G3);
+        __m128 const g32 = _mm_set1_ps(2.0f*G3);
+        __m128 const g33 = _mm_set1_ps(3.0f*G3 - 1.0f);
+
+        __m128 const x1 = _mm_add_ps(_mm_sub_ps(x0, maskToOne4(mi1)), g3);
+        __m128 const y1 = _mm_add_ps(_mm_sub_ps(y0, maskToOne4(mj1)), g3);
+        __m128 const z1 = _mm_add_ps(_mm_sub_ps(z0, maskToOne4(mk1)), g3);
+        __m128 const x2 = _mm_add_ps(_mm_sub_ps(x0, maskToOne4(mi2)), g32);
+        __m128 const y2 = _mm_add_ps(_mm_sub_ps(y0, maskToOne4(mj2)), g32);
+        __m128 const z2 = _mm_add_ps(_mm_sub_ps(z0, maskToOne4(mk2)), g32);
+        __m128 const x3 = _mm_add_ps(x0, g33);
+        __m128 const y3 = _mm_add_ps(y0, g33);
+        __m128 const z3 = _mm_add_ps(z0, g33);
+
+        __m128i const ip = _mm_mullo_epi32(_mm_cvttps_epi32(fi), _mm_set1_epi32(PRIME_X));
+        __m128i const jp = _mm_mullo_epi32(_mm_cvttps_epi32(fj), _mm_set1_epi32(PRIME_Y));
+        __m128i const kp = _mm_mullo_epi32(_mm_cvttps_epi32(fk), _mm_set1_epi32(PRIME_Z));
+
+        __m128i const h0 = hash4(seed, ip, jp, kp);
+        __m128i const h1 = hash4(seed,
+            _mm_add_epi32(ip, maskToPrime4(mi1, PRIME_X)),
+            _mm_add_epi32(jp, maskToPrime4(mj1, PRIME_Y)),
+            _mm_add_epi32(kp, maskToPrime4(mk1, PRIME_Z))
+        );
+        __m128i const h2 = hash4(seed,
+            _mm_add_epi32(ip, maskToPrime4(mi2, PRIME_X)),
+            _mm_add_epi32(jp, maskToPrime4(mj2, PRIME_Y)),
+            _mm_add_epi32(kp, maskToPrime4(mk2, PRIME_Z))
+        );
+        __m128i const h3 = hash4(seed,
+            _mm_add_epi32(ip, _mm_set1_epi32(PRIME_X)),
+            _mm_add_epi32(jp, _mm_set1_epi32(PRIME_Y)),
+            _mm_add_epi32(kp, _mm_set1_epi32(PRIME_Z))
+        );
+
+        __m128 const n = _mm_add_ps(
+            _mm_add_ps(corner4(h0, x0, y0, z0), corner4(h1, x1, y1, z1)),
+            _mm_add_ps(corner4(h2, x2, y2, z2), corner4(h3, x3, y3, z3))
+        );
+
+        return _mm_mul_ps(n, _mm_set1_ps(SCALE3));
+    }
+#endif //VOX_NOISE_SSE41
+} //namespace anon
+
+world::SimdLevel
+world::detectSimd()
+{
+#if defined(VOX_NOISE_SSE41) && defined(VOX_MSVC)
+    int info[4];
+    __cpuid(info, 1);
+
+    return (info[2] & (1 << 19)) ? SIMD_SSE41 : SIMD_NONE;
+#elif defined(VOX_NOISE_SSE41) && defined(__GNUC__)
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return SIMD_NONE;
+    }
+
+    return (ecx & bit_SSE4_1) ? SIMD_SSE41 : SIMD_NONE;
+#else
+    return SIMD_NONE;
+#endif
+}
+
+world::Noise::Noise(unsigned seed, SimdLevel simd)
+    : seed_(seed)
+    , simd_(simd)
+{
+#if !defined(VOX_NOISE_SSE41)
+    simd_ = SIMD_NONE;
+#endif
+}
+
+float
+world::Noise::simplex2(float x, float y) const
+{
+    return ::simplex2(seed_, x, y);
+}
+
+float
+world::Noise::simplex3(float x, float y, float z) const
+{
+    return ::simplex3(seed_, x, y, z);
+}
+
+void
+world::Noise::simplex2(float const* x, float const* y, float* out, unsigned n) const
+{
+    unsigned i = 0;
+
+#if defined(VOX_NOISE_SSE41)
+    if (simd_ == SIMD_SSE41) {
+        __m128i const seed = _mm_set1_epi32(seed_);
+
+        for (; i + 4 <= n; i += 4) {
+            _mm_storeu_ps(out + i, simplex2x4(seed, _mm_loadu_ps(x + i), _mm_loadu_ps(y + i)));
+        }
+    }
+#endif
+
+    for (; i < n; ++i) {
+        out[i] = ::simplex2(seed_, x[i], y[i]);
+    }
+}
+
+void
+world::Noise::simplex3(float const* x, float const* y, float const* z, float* out, unsigned n) const
+{
+    unsigned i = 0;
+
+#if defined(VOX_NOISE_SSE41)
+    if (simd_ == SIMD_SSE41) {
+        __m128i const seed = _mm_set1_epi32(seed_);
+
+        for (; i + 4 <= n; i += 4) {
+            _mm_storeu_ps(out + i, simplex3x4(seed,
+                _mm_loadu_ps(x + i), _mm_loadu_ps(y + i), _mm_loadu_ps(z + i)
+            ));
+        }
+    }
+#endif
+
+    for (; i < n; ++i) {
+        out[i] = ::simplex3(seed_, x[i], y[i], z[i]);
+    }
+}
+
+float
+world::Noise::fbm2(float x, float y, FbmParams const& params) const
+{
+    float sum       = 0.0f;
+    float amplitude = 1.0f;
+    float total     = 0.0f;
+    float frequency = params.frequency;
+
+    for (unsigned octave = 0; octave < params.octaves; ++octave) {
+        sum       += amplitude * ::simplex2(seed_ + octave, x*frequency, y*frequency);
+        total     += amplitude;
+        amplitude *= params.gain;
+        frequency *= params.lacunarity;
+    }
+
+    return total > 0.0f ? sum * (1.0f / total) : 0.0f;
+}
+
+void
+world::Noise::fbm2(float const* x, float const* y, float* out, unsigned n, FbmParams const& params) const
+{
+    assert(n <= BATCH_MAX);
+
+    float sx[BATCH_MAX];
+    float sy[BATCH_MAX];
+    float value[BATCH_MAX];
+
+    std::fill(out, out + n, 0.0f);
+
+    float amplitude = 1.0f;
+    float total     = 0.0f;
+    float frequency = params.frequency;
+
+    for (unsigned octave = 0; octave < params.octaves; ++octave) {
+        for (unsigned i = 0; i < n; ++i) {
+            sx[i] = x[i]*frequency;
+            sy[i] = y[i]*frequency;
+        }
+
+        //each octave is decorrelated by a different seed
+        Noise const octaveNoise(seed_ + octave, simd_);
+        octaveNoise.simplex2(sx, sy, value, n);
+
+        for (unsigned i = 0; i < n; ++i) {
+            out[i] += amplitude*value[i];
+        }
+
+        total     += amplitude;
+        amplitude *= params.gain;
+        frequency *= params.lacunarity;
+    }
+
+    if (total > 0.0f) {
+        float const scale = 1.0f / total;
+        for (unsigned i = 0; i < n; ++i) {
+            out[i] *= scale;
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+#ifndef VOX_WORLD_NOISE_HPP
+#define VOX_WORLD_NOISE_HPP
+
+namespace vox {
+    namespace world {
+
+    enum SimdLevel {
+        SIMD_NONE,
+        SIMD_SSE41,
+    };
+
+    //best instruction set supported by the cpu we are running on
+    SimdLevel detectSimd();
+
+    struct FbmParams {
+        FbmParams() : octaves(4), frequency(1.0f), lacunarity(2.0f), gain(0.5f) {}
+
+        FbmParams(unsigned octaves, float frequency, float lacunarity = 2.0f, float gain = 0.5f)
+            : octaves(octaves), frequency(frequency), lacunarity(lacunarity), gain(gain)
+        {
+        }
+
+        unsigned octaves;
+        float    frequency;  //frequency of the first octave
+        float    lacunarity; //frequency multiplier per octave
+        float    gain;       //amplitude multiplier per octave
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Seeded simplex gradient noise in [-1, 1]. Lattice gradients come from
+    // an integer hash rather than a permutation table so the batched versions
+    // vectorize without gathers. Batched and single point results agree to
+    // within rounding, whichever instruction set is used.
+    ////////////////////////////////////////////////////////////////////////////
+    class Noise {
+    public:
+        explicit Noise(unsigned seed, SimdLevel simd = detectSimd());
+
+        unsigned  seed() const { return seed_; }
+        SimdLevel simd() const { return simd_; }
+
+        float simplex2(float x, float y) const;
+        float simplex3(float x, float y, float z) const;
+
+        //out[i] = simplex2(x[i], y[i]) for i in [0, n)
+        void simplex2(float const* x, float const* y, float* out, unsigned n) const;
+        //out[i] = simplex3(x[i], y[i], z[i]) for i in [0, n)
+        void simplex3(float const* x, float const* y, float const* z, float* out, unsigned n) const;
+
+        //fractal sum of octaves, normalized back to [-1, 1]
+        float fbm2(float x, float y, FbmParams const& params) const;
+
+        //out[i] = fbm2(x[i], y[i], params); n is limited to BATCH_MAX
+        void fbm2(float const* x, float const* y, float* out, unsigned n, FbmParams const& params) const;
+
+        static unsigned const BATCH_MAX = 1024;
+    private:
+        unsigned  seed_;
+        SimdLevel simd_;
+    };
+
+    } //namespace world
+} //namespace vox
+
+#endif //VOX_WORLD_NOISE_HPP
@@ -0,0 +1,153 @@
+#include "common.hpp"
+#include "raycast.hpp"
+
+#include <limits>
+#include <cmath>
+
+#include "../util/threadPool.hpp"
+
+namespace world = ::vox::world;
+
+namespace {
+    //remembers the chunk of the last lookup so a ray only touches the
+    //world's chunk map when it crosses a chunk border
+    class ChunkCursor {
+    public:
+        explicit ChunkCursor(world::World const& w)
+            : world_(w), pos_(), chunk_(), valid_(false)
+        {
+        }
+
+        world::BlockId get(int x, int y, int z) {
+            if (y < 0 || y >= static_cast<int>(world::CHUNK_SIZE_Y)) {
+                return world::BLOCK_AIR;
+            }
+
+            auto const pos = world::ChunkPos::fromBlock(x, z);
+            if (!valid_ || pos != pos_) {
+                chunk_ = world_.find(pos);
+                pos_   = pos;
+                valid_ = true;
+            }
+
+            if (!chunk_) {
+                return world::BLOCK_AIR;
+            }
+
+            return chunk_->get(x - pos.blockX(), y, z - pos.blockZ());
+        }
+    private:
+        world::World const&     world_;
+        world::ChunkPos         pos_;
+        world::World::chunk_ptr chunk_;
+        bool                    valid_;
+    };
+} //namespace anon
+
+world::RayHit
+world::castRay(World const& world, Ray const& ray)
+{
+    RayHit result;
+
+    float const length = ray.direction.norm();
+    if (length == 0.0f || !(ray.maxDistance >= 0.0f)) {
+        return result;
+    }
+
+    Eigen::Vector3f const dir = ray.direction / length;
+    float const infinity = std::numeric_limits<float>::infinity();
+
+    int   pos[3];
+    int   step[3];
+    float tMax[3];
+    float tDelta[3];
+
+    for (unsigned axis = 0; axis < 3; ++axis) {
+        float const origin = ray.origin[axis];
+        pos[axis] = static_cast<int>(std::floor(origin));
+
+        if (dir[axis] > 0.0f) {
+            step[axis]   = 1;
+            tDelta[axis] = 1.0f / dir[axis];
+            tMax[axis]   = (static_cast<float>(pos[axis] + 1) - origin) * tDelta[axis];
+        } else if (dir[axis] < 0.0f) {
+            step[axis]   = -1;
+            tDelta[axis] = -1.0f / dir[axis];
+            tMax[axis]   = (origin - static_cast<float>(pos[axis])) * tDelta[axis];
+        } else {
+            step[axis]   = 0;
+            tDelta[axis] = infinity;
+            tMax[axis]   = infinity;
+        }
+    }
+
+    ChunkCursor cursor(world);
+
+    int   lastAxis = -1;
+    float t        = 0.0f;
+
+    for (;;) {
+        BlockId const id = cursor.get(pos[0], pos[1], pos[2]);
+
+        if (isOpaque(id)) {
+            result.hit      = true;
+            result.block    = Eigen::Vector3i(pos[0], pos[1], pos[2]);
+            result.distance = t;
+            result.id       = id;
+
+            if (lastAxis >= 0) {
+                result.normal[lastAxis] = -step[lastAxis];
+            }
+
+            return result;
+        }
+
+        unsigned const axis =
+            tMax[0] < tMax[1] ?
+                (tMax[0] < tMax[2] ? 0 : 2) :
+                (tMax[1] < tMax[2] ? 1 : 2);
+
+        t = tMax[axis];
+        if (t > ray.maxDistance) {
+            break;
+        }
+
+        pos[axis]  += step[axis];
+        tMax[axis] += tDelta[axis];
+        lastAxis    = axis;
+
+        //nothing left to hit once the ray leaves the top or bottom of the world
+        int const height = static_cast<int>(CHUNK_SIZE_Y);
+        if ((pos[1] < 0 && step[1] <= 0) || (pos[1] >= height && step[1] >= 0)) {
+            break;
+        }
+    }
+
+    return result;
+}
+
+void
+world::castRays(
+    World const&            world,
+    std::vector<Ray> const& rays,
+    std::vector<RayHit>&    hits,
+    util::ThreadPool&       pool
+) {
+    hits.resize(rays.size());
+
+    if (rays.empty()) {
+        return;
+    }
+
+    //rays are cheap; batch enough of them per job to hide the queue overhead
+    unsigned const grain = 256;
+
+    Ray const* const in  = &rays[0];
+    RayHit* const    out = &hits[0];
+
+    pool.parallelFor(rays.size(), [&world, in, out](unsigned first, unsigned last) {
+        for (unsigned i = first; i < last; ++i) {
+            out[i] = castRay(world, in[i]);
+        }
+    }, grain);
+}
@@ -0,0 +1,55 @@
+#pragma once
+#ifndef VOX_WORLD_RAYCAST_HPP
+#define VOX_WORLD_RAYCAST_HPP
+
+#include <vector>
+#include <Eigen/Core>
+
+#include "world.hpp"
+
+namespace vox {
+    namespace util { class ThreadPool; }
+
+    namespace world {
+
+    struct Ray {
+        Ray() : origin(0.0f, 0.0f, 0.0f), direction(0.0f, 0.0f, -1.0f), maxDistance(64.0f) {}
+
+        Ray(Eigen::Vector3f const& origin, Eigen::Vector3f const& direction, float maxDistance)
+            : origin(origin), direction(direction), maxDistance(maxDistance)
+        {
+        }
+
+        Eigen::Vector3f origin;
+        Eigen::Vector3f direction;   //need not be normalized
+        float           maxDistance; //in blocks, along the normalized direction
+    };
+
+    struct RayHit {
+        RayHit() : hit(false), block(0, 0, 0), normal(0, 0, 0), distance(0.0f), id(BLOCK_AIR) {}
+
+        bool            hit;
+        Eigen::Vector3i block;    //world position of the block hit
+        Eigen::Vector3i normal;   //outward normal of the face entered; zero if the ray started inside the block
+        float           distance; //distance from the origin to the face entered
+        BlockId         id;
+    };
+
+    //Amanatides-Woo traversal of the voxel grid, returning the first opaque
+    //block along ray. Chunks are looked up only when the ray crosses a chunk
+    //border; unloaded chunks are treated as empty.
+    RayHit castRay(World const& world, Ray const& ray);
+
+    //castRay for each of rays, spread over the workers of pool.
+    //hits is resized to rays.size().
+    void castRays(
+        World const&             world,
+        std::vector<Ray> const&  rays,
+        std::vector<RayHit>&     hits,
+        util::ThreadPool&        pool
+    );
+
+    } //namespace world
+} //namespace vox
+
+#endif //VOX_WORLD_RAYCAST_HPP
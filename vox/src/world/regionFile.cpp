@@ -0,0 +1,339 @@
+#include "common.hpp"
+#include "regionFile.hpp"
+
+namespace world = ::vox::world;
+namespace ipc   = ::boost::interprocess;
+
+namespace {
+    size_t const RAW_SIZE = world::CHUNK_VOLUME * 2; //blocks then light
+
+    void rleEncode(unsigned char const* in, size_t size, std::vector<unsigned char>& out) {
+        for (size_t i = 0; i < size; ) {
+            unsigned char const value = in[i];
+
+            size_t run = 1;
+            while (run < 255 && i + run < size && in[i + run] == value) {
+                ++run;
+            }
+
+            out.push_back(static_cast<unsigned char>(run));
+            out.push_back(value);
+
+            i += run;
+        }
+    }
+
+    //decode exactly size bytes from the start of in; the number of input
+    //bytes used, or 0 if in is too short or a run overshoots size
+    size_t rleDecode(unsigned char const* in, size_t inSize, unsigned char* out, size_t size) {
+        unsigned char* const end = out + size;
+
+        size_t i = 0;
+        while (out != end) {
+            if (i + 2 > inSize) {
+                return 0;
+            }
+
+            size_t const run = in[i];
+            if (run == 0 || run > static_cast<size_t>(end - out)) {
+                return 0;
+            }
+
+            std::fill(out, out + run, in[i + 1]);
+            out += run;
+            i   += 2;
+        }
+
+        return i;
+    }
+
+    unsigned sectorsFor(size_t bytes) {
+        return static_cast<unsigned>((bytes + world::REGION_SECTOR_SIZE - 1) / world::REGION_SECTOR_SIZE);
+    }
+} //namespace anon
+
+////////////////////////////////////////////////////////////////////////////////
+// RegionFile
+////////////////////////////////////////////////////////////////////////////////
+world::RegionFile::RegionFile(std::string const& fileName)
+    : fileName_(fileName)
+    , entries_(REGION_CHUNKS)
+{
+    static_assert(sizeof(Entry) == 8, "region table entries must be 8 bytes");
+
+    {//create an empty region with a zeroed table
+        std::ifstream exists(fileName_, std::ios::binary);
+        if (!exists) {
+            std::ofstream out(fileName_, std::ios::binary);
+            std::vector<char> const header(HEADER_SECTORS * REGION_SECTOR_SIZE);
+            out.write(&header[0], header.size());
+
+            if (!out) {
+                BOOST_THROW_EXCEPTION(error::storage_error()
+                    << error::storage_error::file_name(fileName_)
+                );
+            }
+        }
+    }
+
+    file_.open(fileName_, std::ios::binary | std::ios::in | std::ios::out);
+    if (!file_) {
+        BOOST_THROW_EXCEPTION(error::storage_error()
+            << error::storage_error::file_name(fileName_)
+        );
+    }
+
+    map_();
+
+    size_t const fileSize = view_.get_size();
+    if (fileSize < HEADER_SECTORS * REGION_SECTOR_SIZE) {
+        BOOST_THROW_EXCEPTION(error::corrupt_region()
+            << error::storage_error::file_name(fileName_)
+        );
+    }
+
+    std::memcpy(&entries_[0], view_.get_address(), REGION_CHUNKS * sizeof(Entry));
+
+    used_.assign(sectorsFor(fileSize), false);
+    std::fill(used_.begin(), used_.begin() + HEADER_SECTORS, true);
+
+    for (unsigned i = 0; i < REGION_CHUNKS; ++i) {
+        Entry const& e = entries_[i];
+        if (e.size == 0) {
+            continue;
+        }
+
+        unsigned const count = sectorsFor(e.size);
+        if (e.sector < HEADER_SECTORS || e.sector + count > used_.size()) {
+            BOOST_THROW_EXCEPTION(error::corrupt_region()
+                << error::storage_error::file_name(fileName_)
+                << error::corrupt_region::chunk_x(i / REGION_SIZE)
+                << error::corrupt_region::chunk_z(i % REGION_SIZE)
+            );
+        }
+
+        std::fill(used_.begin() + e.sector, used_.begin() + e.sector + count, true);
+    }
+}
+
+unsigned
+world::RegionFile::index_(ChunkPos const pos) const
+{
+    RegionPos const region = RegionPos::fromChunk(pos);
+
+    unsigned const x = static_cast<unsigned>(pos.x - region.x * static_cast<int>(REGION_SIZE));
+    unsigned const z = static_cast<unsigned>(pos.z - region.z * static_cast<int>(REGION_SIZE));
+
+    return x * REGION_SIZE + z;
+}
+
+void
+world::RegionFile::map_()
+{
+    //mapped_region isn't assignable before boost 1.48
+    ipc::file_mapping mapping(fileName_.c_str(), ipc::read_only);
+    ipc::mapped_region view(mapping, ipc::read_only);
+
+    mapping_.swap(mapping);
+    view_.swap(view);
+}
+
+bool
+world::RegionFile::has(ChunkPos const pos) const
+{
+    boost::shared_lock<boost::shared_mutex> lock(mutex_);
+    return entries_[index_(pos)].size != 0;
+}
+
+bool
+world::RegionFile::load(Chunk& chunk) const
+{
+    boost::shared_lock<boost::shared_mutex> lock(mutex_);
+
+    Entry const& e = entries_[index_(chunk.position())];
+    if (e.size == 0) {
+        return false;
+    }
+
+    unsigned char const* const data =
+        static_cast<unsigned char const*>(view_.get_address()) + e.sector * REGION_SECTOR_SIZE;
+
+    unsigned char const  codec = data[0];
+    unsigned char const* body  = data + 1;
+    size_t const         size  = e.size - 1;
+
+    bool ok = false;
+
+    if (codec == CODEC_NONE && size == RAW_SIZE) {
+        std::copy(body, body + CHUNK_VOLUME, chunk.blocks());
+        std::copy(body + CHUNK_VOLUME, body + RAW_SIZE, chunk.light());
+        ok = true;
+    } else if (codec == CODEC_RLE) {
+        //blocks and light are encoded separately so no run spans the two
+        size_t const used = rleDecode(body, size, chunk.blocks(), CHUNK_VOLUME);
+        ok = used != 0
+          && rleDecode(body + used, size - used, chunk.light(), CHUNK_VOLUME) == size - used;
+    }
+
+    if (!ok) {
+        BOOST_THROW_EXCEPTION(error::corrupt_region()
+            << error::storage_error::file_name(fileName_)
+            << error::corrupt_region::chunk_x(chunk.position().x)
+            << error::corrupt_region::chunk_z(chunk.position().z)
+        );
+    }
+
+    return true;
+}
+
+unsigned
+world::RegionFile::allocate_(unsigned const sectors)
+{
+    //first fit
+    unsigned run = 0;
+    for (unsigned i = HEADER_SECTORS; i < used_.size(); ++i) {
+        run = used_[i] ? 0 : run + 1;
+        if (run == sectors) {
+            return i + 1 - sectors;
+        }
+    }
+
+    //grow the file, reusing any free sectors at its end
+    unsigned const first = static_cast<unsigned>(used_.size()) - run;
+    used_.resize(first + sectors, false);
+
+    return first;
+}
+
+void
+world::RegionFile::save(Chunk const& chunk, Codec const codec)
+{
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+
+    buffer_.clear();
+    buffer_.push_back(static_cast<unsigned char>(CODEC_NONE));
+
+    if (codec == CODEC_RLE) {
+        rleEncode(chunk.blocks(), CHUNK_VOLUME, buffer_);
+        rleEncode(chunk.light(), CHUNK_VOLUME, buffer_);
+
+        if (buffer_.size() - 1 < RAW_SIZE) {
+            buffer_[0] = static_cast<unsigned char>(CODEC_RLE);
+        } else {
+            buffer_.resize(1);
+        }
+    }
+
+    if (buffer_[0] == CODEC_NONE) {
+        buffer_.insert(buffer_.end(), chunk.blocks(), chunk.blocks() + CHUNK_VOLUME);
+        buffer_.insert(buffer_.end(), chunk.light(), chunk.light() + CHUNK_VOLUME);
+    }
+
+    unsigned const size  = static_cast<unsigned>(buffer_.size());
+    unsigned const count = sectorsFor(size);
+
+    //pad to whole sectors so the file always ends on a sector boundary
+    buffer_.resize(count * REGION_SECTOR_SIZE, 0);
+
+    Entry& e = entries_[index_(chunk.position())];
+    size_t const oldFileSectors = used_.size();
+
+    if (e.size != 0) {
+        std::fill(used_.begin() + e.sector, used_.begin() + e.sector + sectorsFor(e.size), false);
+    }
+
+    Entry updated;
+    updated.sector = (e.size != 0 && sectorsFor(e.size) >= count) ? e.sector : allocate_(count);
+    updated.size   = size;
+
+    std::fill(used_.begin() + updated.sector, used_.begin() + updated.sector + count, true);
+
+    bool const grows = used_.size() > oldFileSectors;
+    if (grows) {
+        //a file can't always be extended while a view of it is open
+        ipc::mapped_region().swap(view_);
+    }
+
+    //data first, so a crash before the table write leaves the old chunk
+    file_.seekp(static_cast<std::streamoff>(updated.sector) * REGION_SECTOR_SIZE);
+    file_.write(reinterpret_cast<char const*>(&buffer_[0]), buffer_.size());
+    file_.flush();
+
+    file_.seekp(static_cast<std::streamoff>(index_(chunk.position())) * sizeof(Entry));
+    file_.write(reinterpret_cast<char const*>(&updated), sizeof(Entry));
+    file_.flush();
+
+    if (!file_) {
+        BOOST_THROW_EXCEPTION(error::storage_error()
+            << error::storage_error::file_name(fileName_)
+        );
+    }
+
+    e = updated;
+
+    if (grows) {
+        map_();
+    }
+}
+
+unsigned
+world::RegionFile::sectorCount() const
+{
+    boost::shared_lock<boost::shared_mutex> lock(mutex_);
+    return static_cast<unsigned>(used_.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// RegionStorage
+////////////////////////////////////////////////////////////////////////////////
+world::RegionStorage::RegionStorage(std::string const& directory)
+    : directory_(directory)
+{
+}
+
+std::string
+world::RegionStorage::fileName(RegionPos const pos) const
+{
+    return (boost::format("%s/r.%d.%d.vxr") % directory_ % pos.x % pos.z).str();
+}
+
+world::RegionFile*
+world::RegionStorage::region_(ChunkPos const pos, bool const create)
+{
+    RegionPos const region = RegionPos::fromChunk(pos);
+
+    boost::lock_guard<boost::mutex> lock(mutex_);
+
+    auto const it = regions_.find(region);
+    if (it != regions_.end()) {
+        return it->second.get();
+    }
+
+    std::string const name = fileName(region);
+    if (!create && !std::ifstream(name, std::ios::binary)) {
+        return nullptr;
+    }
+
+    std::shared_ptr<RegionFile> file(new RegionFile(name));
+    regions_[region] = file;
+
+    return file.get();
+}
+
+world::World::chunk_ptr
+world::RegionStorage::load(ChunkPos const pos)
+{
+    RegionFile* const region = region_(pos, false);
+    if (!region || !region->has(pos)) {
+        return World::chunk_ptr();
+    }
+
+    World::chunk_ptr chunk(new Chunk(pos));
+    return region->load(*chunk) ? chunk : World::chunk_ptr();
+}
+
+void
+world::RegionStorage::save(Chunk const& chunk)
+{
+    region_(chunk.position(), true)->save(chunk);
+}
@@ -0,0 +1,151 @@
+#pragma once
+#ifndef VOX_WORLD_REGION_FILE_HPP
+#define VOX_WORLD_REGION_FILE_HPP
+
+#include <map>
+#include <vector>
+#include <string>
+#include <memory>
+#include <fstream>
+#include <boost/thread.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "exception.hpp"
+#include "world.hpp"
+
+namespace vox {
+    namespace world {
+        namespace error {
+            struct storage_error : virtual vox::exception {
+                VOX_DEFINE_EXCEPTION_INFO(file_name, ::std::string);
+            };
+
+            struct corrupt_region : virtual storage_error {
+                VOX_DEFINE_EXCEPTION_INFO(chunk_x, int);
+                VOX_DEFINE_EXCEPTION_INFO(chunk_z, int);
+            };
+        } //namespace error
+
+    unsigned const REGION_SIZE        = 32;   //chunks per side of a region
+    unsigned const REGION_CHUNKS      = REGION_SIZE * REGION_SIZE;
+    unsigned const REGION_SECTOR_SIZE = 4096;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Position of a region in units of REGION_SIZE chunks.
+    ////////////////////////////////////////////////////////////////////////////
+    struct RegionPos {
+        RegionPos() : x(0), z(0) {}
+        RegionPos(int x, int z) : x(x), z(z) {}
+
+        bool operator<(RegionPos const& rhs) const {
+            return x < rhs.x || (x == rhs.x && z < rhs.z);
+        }
+
+        bool operator==(RegionPos const& rhs) const {
+            return x == rhs.x && z == rhs.z;
+        }
+
+        //the region containing chunk pos
+        static RegionPos fromChunk(ChunkPos pos) {
+            return RegionPos(floorDiv_(pos.x), floorDiv_(pos.z));
+        }
+
+        int x, z;
+    private:
+        static int floorDiv_(int value) {
+            int const n = static_cast<int>(REGION_SIZE);
+            return value >= 0 ? value / n : -((n - 1 - value) / n);
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // A file holding up to REGION_SIZE x REGION_SIZE chunks.
+    //
+    // The file is a sequence of REGION_SECTOR_SIZE byte sectors. The first
+    // sectors hold a table with the first sector and byte size of every
+    // chunk; a size of 0 means the chunk was never saved. Each chunk is a
+    // codec byte followed by its blocks and light, compressed by that codec.
+    // Saving a chunk rewrites it in place when it still fits its sectors,
+    // otherwise it moves to the first free run of sectors large enough, or
+    // to the end of the file.
+    //
+    // Chunks are read straight out of a read only mapping of the file, so a
+    // load is a page fault and a decompression. Writes go through a file
+    // stream, data first and the table entry last, after which the mapping
+    // is refreshed if the file grew.
+    //
+    // Table entries are stored in native (little endian) byte order.
+    ////////////////////////////////////////////////////////////////////////////
+    class RegionFile : private boost::noncopyable {
+    public:
+        enum Codec {
+            CODEC_NONE, //raw blocks then light
+            CODEC_RLE,  //(run length, value) byte pairs over the raw data
+        };
+
+        //opens fileName, creating an empty region if it doesn't exist
+        explicit RegionFile(std::string const& fileName);
+
+        bool has(ChunkPos pos) const;
+
+        //read the chunk at chunk.position(); false if it was never saved
+        bool load(Chunk& chunk) const;
+        //codec is a preference; chunks that don't compress are stored raw
+        void save(Chunk const& chunk, Codec codec = CODEC_RLE);
+
+        //size of the file in sectors, including free ones
+        unsigned sectorCount() const;
+    private:
+        struct Entry {
+            unsigned sector; //first sector of the chunk
+            unsigned size;   //in bytes; 0 if not present
+        };
+
+        static unsigned const HEADER_SECTORS =
+            (REGION_CHUNKS * sizeof(Entry) + REGION_SECTOR_SIZE - 1) / REGION_SECTOR_SIZE;
+
+        unsigned index_(ChunkPos pos) const;
+        unsigned allocate_(unsigned sectors);
+        void     map_();
+
+        std::string fileName_;
+
+        mutable boost::shared_mutex mutex_;
+
+        std::fstream                       file_;
+        boost::interprocess::file_mapping  mapping_;
+        boost::interprocess::mapped_region view_;
+        std::vector<Entry>                 entries_;
+        std::vector<bool>                  used_; //per sector
+        std::vector<unsigned char>         buffer_;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Chunk persistence over a directory of region files, opened on first
+    // use and kept open. Safe to call from multiple threads.
+    ////////////////////////////////////////////////////////////////////////////
+    class RegionStorage : private boost::noncopyable {
+    public:
+        //directory must exist
+        explicit RegionStorage(std::string const& directory);
+
+        //nullptr if the chunk was never saved
+        World::chunk_ptr load(ChunkPos pos);
+        void save(Chunk const& chunk);
+
+        std::string fileName(RegionPos pos) const;
+    private:
+        //nullptr if the region doesn't exist and create is false
+        RegionFile* region_(ChunkPos pos, bool create);
+
+        std::string directory_;
+
+        boost::mutex                                     mutex_;
+        std::map<RegionPos, std::shared_ptr<RegionFile>> regions_;
+    };
+
+    } //namespace world
+} //namespace vox
+
+#endif //VOX_WORLD_REGION_FILE_HPP
@@ -0,0 +1,153 @@
+#include "common.hpp"
+#include "simulation.hpp"
+#include "chunkStreamer.hpp"
+#include "../util/profiler.hpp"
+
+#include <cmath>
+#include <Eigen/Geometry>
+
+namespace world = ::vox::world;
+
+namespace {
+    float const PI = 3.14159265f;
+} //namespace anon
+
+Eigen::Vector3f
+world::CameraState::direction() const
+{
+    float const cosPitch = std::cos(pitch);
+
+    return Eigen::Vector3f(
+        -std::sin(yaw) * cosPitch,
+         std::sin(pitch),
+        -std::cos(yaw) * cosPitch
+    );
+}
+
+Eigen::Matrix4f
+world::CameraState::view() const
+{
+    Eigen::Affine3f const result =
+        Eigen::AngleAxisf(-pitch, Eigen::Vector3f::UnitX()) *
+        Eigen::AngleAxisf(-yaw,   Eigen::Vector3f::UnitY()) *
+        Eigen::Translation3f(-position);
+
+    return result.matrix();
+}
+
+world::CameraState
+world::CameraState::lerp(CameraState const& a, CameraState const& b, float const t)
+{
+    //the yaw difference wrapped into [-pi, pi)
+    float const turn = b.yaw - a.yaw - 2.0f * PI * std::floor((b.yaw - a.yaw + PI) / (2.0f * PI));
+
+    CameraState result;
+    result.position = a.position + (b.position - a.position) * t;
+    result.yaw      = a.yaw + turn * t;
+    result.pitch    = a.pitch + (b.pitch - a.pitch) * t;
+
+    return result;
+}
+
+Eigen::Matrix4f
+world::RenderSnapshot::view(clock::time_point const now) const
+{
+    if (tickLength == clock::duration::zero()) {
+        return current.view();
+    }
+
+    double const t = boost::chrono::duration<double>(now - time).count() /
+                     boost::chrono::duration<double>(tickLength).count();
+
+    return CameraState::lerp(
+        previous, current, static_cast<float>(std::min(std::max(t, 0.0), 1.0))
+    ).view();
+}
+
+world::Simulation::Simulation(ChunkStreamer& streamer, float const hz)
+    : streamer_(streamer)
+    , hz_(hz)
+    , pacer_(hz)
+    , velocity_(0.0f, 0.0f, 0.0f)
+    , ticks_(0)
+    , running_(false)
+{
+    assert(hz > 0.0f);
+}
+
+world::Simulation::~Simulation()
+{
+    stop();
+}
+
+void
+world::Simulation::start()
+{
+    if (thread_) {
+        return;
+    }
+
+    running_ = true;
+    thread_.reset(new boost::thread([this] { main_(); }));
+}
+
+void
+world::Simulation::stop()
+{
+    if (!thread_) {
+        return;
+    }
+
+    running_ = false;
+    thread_->join();
+    thread_.reset();
+}
+
+void
+world::Simulation::main_()
+{
+    VOX_PROFILE_THREAD("simulation");
+
+    while (running_) {
+        pacer_.beginFrame();
+
+        {
+            VOX_PROFILE_SCOPE("sim/tick");
+
+            while (!tasks_.isEmpty()) {
+                tasks_.dequeue()();
+            }
+
+            tick_();
+        }
+
+        pacer_.endFrame();
+    }
+}
+
+void
+world::Simulation::tick_()
+{
+    CameraState const previous = camera_;
+
+    camera_.position += velocity_ / hz_;
+
+    StreamCamera stream;
+    stream.position  = camera_.position;
+    stream.direction = camera_.direction();
+
+    streamer_.update(stream);
+
+    ++ticks_;
+
+    RenderSnapshot& snapshot = snapshots_.back();
+    snapshot.tick       = ticks_;
+    snapshot.time       = RenderSnapshot::clock::now();
+    snapshot.tickLength = boost::chrono::duration_cast<RenderSnapshot::clock::duration>(
+        boost::chrono::duration<double>(1.0 / hz_)
+    );
+    snapshot.previous   = previous;
+    snapshot.current    = camera_;
+
+    snapshots_.publish();
+}
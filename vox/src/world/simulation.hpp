@@ -0,0 +1,122 @@
+#pragma once
+#ifndef VOX_WORLD_SIMULATION_HPP
+#define VOX_WORLD_SIMULATION_HPP
+
+#include <memory>
+#include <functional>
+#include <boost/utility.hpp>
+#include <boost/thread.hpp>
+#include <boost/chrono.hpp>
+#include <Eigen/Core>
+
+#include "../util/blockingQueue.hpp"
+#include "../util/framePacer.hpp"
+#include "../util/tripleBuffer.hpp"
+
+namespace vox {
+    namespace world {
+
+    class ChunkStreamer;
+
+    struct CameraState {
+        CameraState()
+            : position(0.0f, 0.0f, 0.0f)
+            , yaw(0.0f)
+            , pitch(0.0f)
+        {
+        }
+
+        Eigen::Vector3f position;
+        float           yaw;   //radians about +y; 0 looks down -z
+        float           pitch; //radians; positive looks up
+
+        Eigen::Vector3f direction() const;
+        Eigen::Matrix4f view() const;
+
+        //t of the way from a to b, turning the short way round
+        static CameraState lerp(CameraState const& a, CameraState const& b, float t);
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Everything the renderer needs from one simulation tick. It's never
+    // changed once published, so the render thread reads it without locks.
+    ////////////////////////////////////////////////////////////////////////////
+    struct RenderSnapshot {
+        typedef boost::chrono::steady_clock clock;
+
+        RenderSnapshot()
+            : tick(0)
+            , tickLength(clock::duration::zero())
+        {
+        }
+
+        unsigned          tick;       //0 until the first tick
+        clock::time_point time;       //when the tick was simulated
+        clock::duration   tickLength;
+        CameraState       previous;   //as of the tick before
+        CameraState       current;
+
+        //the view a tick behind now, blended between previous and current,
+        //so it moves smoothly however the frame and tick rates line up
+        Eigen::Matrix4f view(clock::time_point now) const;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Runs the world at a fixed tick rate on its own thread: moves the
+    // camera, keeps chunks streaming around it, and publishes a snapshot of
+    // each tick for the render thread. Rendering never waits on a tick and
+    // ticks never wait on a frame.
+    ////////////////////////////////////////////////////////////////////////////
+    class Simulation : private boost::noncopyable {
+    public:
+        typedef util::TripleBuffer<RenderSnapshot> mailbox_t;
+
+        //streamer must outlive this and is only updated from its thread
+        explicit Simulation(ChunkStreamer& streamer, float hz = 30.0f);
+        //stops
+        ~Simulation();
+
+        void start();
+        //wait for the current tick to finish
+        void stop();
+
+        //jump to camera without blending from where it was
+        void setCamera(CameraState const& camera) {
+            tasks_.enqueue(
+                [this, camera] { camera_ = camera; }
+            );
+        }
+
+        //blocks per second
+        void setVelocity(Eigen::Vector3f const& velocity) {
+            tasks_.enqueue(
+                [this, velocity] { velocity_ = velocity; }
+            );
+        }
+
+        //for one reader, the render thread
+        mailbox_t& snapshots() { return snapshots_; }
+
+        float rate() const { return hz_; }
+    private:
+        void main_();
+        void tick_();
+
+        ChunkStreamer&    streamer_;
+        float             hz_;
+        util::FramePacer  pacer_;
+        CameraState       camera_;
+        Eigen::Vector3f   velocity_;
+        unsigned          ticks_;
+        mailbox_t         snapshots_;
+
+        util::BlockingQueue<std::function<void ()>> tasks_;
+
+        bool volatile                  running_;
+        std::unique_ptr<boost::thread> thread_;
+    };
+
+    } //namespace world
+} //namespace vox
+
+#endif //VOX_WORLD_SIMULATION_HPP
@@ -0,0 +1,120 @@
+#include "common.hpp"
+#include "terrainGenerator.hpp"
+
+#include "../util/threadPool.hpp"
+
+namespace world = ::vox::world;
+
+world::TerrainGenerator::TerrainGenerator(
+    unsigned             seed,
+    TerrainParams const& params,
+    SimdLevel            simd
+)
+    : params_(params)
+    , heightNoise_(seed, simd)
+    , warpNoiseX_(seed + 0x1000, simd)
+    , warpNoiseZ_(seed + 0x2000, simd)
+    , caveNoise_(seed + 0x3000, simd)
+{
+    assert(params_.seaLevel < CHUNK_SIZE_Y);
+}
+
+void
+world::TerrainGenerator::generate(Chunk& chunk) const
+{
+    unsigned const COLUMNS = CHUNK_SIZE_X*CHUNK_SIZE_Z;
+    static_assert(COLUMNS <= Noise::BATCH_MAX, "chunk too large for a noise batch");
+
+    float x[COLUMNS];
+    float z[COLUMNS];
+    float warpX[COLUMNS];
+    float warpZ[COLUMNS];
+    float height[COLUMNS];
+
+    //surface height for every column in one batch
+    for (unsigned cx = 0; cx < CHUNK_SIZE_X; ++cx) {
+        for (unsigned cz = 0; cz < CHUNK_SIZE_Z; ++cz) {
+            unsigned const i = cx*CHUNK_SIZE_Z + cz;
+            x[i] = static_cast<float>(chunk.position().blockX() + static_cast<int>(cx));
+            z[i] = static_cast<float>(chunk.position().blockZ() + static_cast<int>(cz));
+        }
+    }
+
+    warpNoiseX_.fbm2(x, z, warpX, COLUMNS, params_.warp);
+    warpNoiseZ_.fbm2(x, z, warpZ, COLUMNS, params_.warp);
+
+    for (unsigned i = 0; i < COLUMNS; ++i) {
+        warpX[i] = x[i] + params_.warpStrength*warpX[i];
+        warpZ[i] = z[i] + params_.warpStrength*warpZ[i];
+    }
+
+    heightNoise_.fbm2(warpX, warpZ, height, COLUMNS, params_.height);
+
+    //cave noise, one column at a time
+    float caveX[CHUNK_SIZE_Y];
+    float caveY[CHUNK_SIZE_Y];
+    float caveZ[CHUNK_SIZE_Y];
+    float cave[CHUNK_SIZE_Y];
+
+    for (unsigned y = 0; y < CHUNK_SIZE_Y; ++y) {
+        caveY[y] = static_cast<float>(y)*params_.caveFrequency;
+    }
+
+    int const maxHeight = static_cast<int>(CHUNK_SIZE_Y) - 1;
+
+    for (unsigned cx = 0; cx < CHUNK_SIZE_X; ++cx) {
+        for (unsigned cz = 0; cz < CHUNK_SIZE_Z; ++cz) {
+            unsigned const i = cx*CHUNK_SIZE_Z + cz;
+
+            int const h = static_cast<int>(
+                static_cast<float>(params_.baseHeight) + params_.heightRange*height[i]
+            );
+            unsigned const top = static_cast<unsigned>(std::min(std::max(h, 1), maxHeight));
+
+            BlockId* const column = chunk.column(cx, cz);
+
+            //strata
+            bool const beach = top <= params_.seaLevel + 1;
+            unsigned const soil = top > 4 ? top - 4 : 0;
+
+            std::fill(column, column + soil, static_cast<BlockId>(BLOCK_STONE));
+            std::fill(column + soil, column + top, static_cast<BlockId>(beach ? BLOCK_SAND : BLOCK_DIRT));
+            column[top] = static_cast<BlockId>(beach ? BLOCK_SAND : BLOCK_GRASS);
+
+            unsigned const water = std::max(top + 1, params_.seaLevel);
+            std::fill(column + top + 1, column + water, static_cast<BlockId>(BLOCK_WATER));
+            std::fill(column + water, column + CHUNK_SIZE_Y, static_cast<BlockId>(BLOCK_AIR));
+
+            //caves; leave the bottom layer and the surface block alone
+            if (top > 1) {
+                unsigned const count = top - 1;
+
+                std::fill(caveX, caveX + count, x[i]*params_.caveFrequency);
+                std::fill(caveZ, caveZ + count, z[i]*params_.caveFrequency);
+
+                caveNoise_.simplex3(caveX, caveY + 1, caveZ, cave, count);
+
+                for (unsigned y = 0; y < count; ++y) {
+                    if (cave[y] > params_.caveThreshold) {
+                        column[y + 1] = BLOCK_AIR;
+                    }
+                }
+            }
+        }
+    }
+}
+
+void
+world::TerrainGenerator::generate(
+    World&                       world,
+    std::vector<ChunkPos> const& positions,
+    util::ThreadPool&            pool
+) const {
+    pool.parallelFor(positions.size(), [this, &world, &positions](unsigned first, unsigned last) {
+        for (unsigned i = first; i < last; ++i) {
+            std::shared_ptr<Chunk> chunk(new Chunk(positions[i]));
+            generate(*chunk);
+            world.insert(chunk);
+        }
+    });
+}
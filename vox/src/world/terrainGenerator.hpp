@@ -0,0 +1,71 @@
+#pragma once
+#ifndef VOX_WORLD_TERRAIN_GENERATOR_HPP
+#define VOX_WORLD_TERRAIN_GENERATOR_HPP
+
+#include <vector>
+
+#include "noise.hpp"
+#include "world.hpp"
+
+namespace vox {
+    namespace util { class ThreadPool; }
+
+    namespace world {
+
+    struct TerrainParams {
+        TerrainParams()
+            : seaLevel(48)
+            , baseHeight(56)
+            , heightRange(36.0f)
+            , height(5, 1.0f / 256.0f)
+            , warp(3, 1.0f / 512.0f)
+            , warpStrength(64.0f)
+            , caveFrequency(1.0f / 24.0f)
+            , caveThreshold(0.62f)
+        {
+        }
+
+        unsigned  seaLevel;      //columns below this are flooded with water
+        unsigned  baseHeight;    //height of a column where the height noise is 0
+        float     heightRange;   //height noise of +-1 moves the surface this far
+        FbmParams height;        //surface height
+        FbmParams warp;          //domain warp applied to the height lookup
+        float     warpStrength;  //domain warp offset in blocks
+        float     caveFrequency; //frequency of the 3d cave noise
+        float     caveThreshold; //cave noise above this carves out air
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Fills chunk columns from a domain warped fbm heightmap with 3d noise
+    // caves. Generation is deterministic for a given seed and the generator
+    // holds no mutable state, so a single instance may be shared by any
+    // number of worker threads.
+    ////////////////////////////////////////////////////////////////////////////
+    class TerrainGenerator : private boost::noncopyable {
+    public:
+        explicit TerrainGenerator(
+            unsigned             seed,
+            TerrainParams const& params = TerrainParams(),
+            SimdLevel            simd   = detectSimd()
+        );
+
+        TerrainParams const& params() const { return params_; }
+
+        //overwrite every block of chunk
+        void generate(Chunk& chunk) const;
+
+        //create, generate and insert a chunk for each of positions in
+        //parallel, blocking until all of them are in world
+        void generate(World& world, std::vector<ChunkPos> const& positions, util::ThreadPool& pool) const;
+    private:
+        TerrainParams params_;
+        Noise         heightNoise_;
+        Noise         warpNoiseX_;
+        Noise         warpNoiseZ_;
+        Noise         caveNoise_;
+    };
+
+    } //namespace world
+} //namespace vox
+
+#endif //VOX_WORLD_TERRAIN_GENERATOR_HPP
@@ -0,0 +1,59 @@
+#include "common.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include "../blockTextures.hpp"
+
+namespace world = ::vox::world;
+
+BOOST_AUTO_TEST_CASE(BlockTexturesShareLayers)
+{
+    world::BlockTextures textures;
+
+    textures.set(world::BLOCK_STONE, "stone");
+    textures.set(world::BLOCK_GRASS, "grass_top", "grass_side", "dirt");
+    textures.set(world::BLOCK_DIRT, "dirt");
+
+    //stone, grass_top, grass_side, dirt
+    BOOST_CHECK_EQUAL(textures.layerCount(), 4u);
+    BOOST_CHECK_EQUAL(textures.names()[3], "dirt");
+
+    for (unsigned f = 0; f < world::FACE_COUNT; ++f) {
+        world::Face const face = static_cast<world::Face>(f);
+
+        BOOST_CHECK_EQUAL(textures.layer(world::BLOCK_STONE, face), 0u);
+        BOOST_CHECK_EQUAL(textures.layer(world::BLOCK_DIRT, face), 3u);
+    }
+
+    BOOST_CHECK_EQUAL(textures.layer(world::BLOCK_GRASS, world::FACE_POS_Y), 1u);
+    BOOST_CHECK_EQUAL(textures.layer(world::BLOCK_GRASS, world::FACE_NEG_Z), 2u);
+    BOOST_CHECK_EQUAL(textures.layer(world::BLOCK_GRASS, world::FACE_NEG_Y), 3u);
+
+    //never set
+    BOOST_CHECK_EQUAL(textures.layer(world::BLOCK_SAND, world::FACE_POS_X), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(BlockTexturesStandardTable)
+{
+    world::BlockTextures const textures = world::BlockTextures::standard();
+
+    BOOST_REQUIRE_EQUAL(textures.layerTableSize(), world::BLOCK_COUNT*world::FACE_COUNT);
+
+    for (unsigned id = world::BLOCK_AIR + 1; id < world::BLOCK_COUNT; ++id) {
+        for (unsigned f = 0; f < world::FACE_COUNT; ++f) {
+            world::Face const face = static_cast<world::Face>(f);
+            unsigned const    layer = textures.layer(static_cast<world::BlockId>(id), face);
+
+            BOOST_CHECK_LT(layer, textures.layerCount());
+            BOOST_CHECK_EQUAL(
+                textures.layerTable()[world::BlockTextures::index(static_cast<world::BlockId>(id), face)],
+                static_cast<int>(layer)
+            );
+        }
+    }
+
+    //grass shares its bottom with dirt
+    BOOST_CHECK_EQUAL(
+        textures.layer(world::BLOCK_GRASS, world::FACE_NEG_Y),
+        textures.layer(world::BLOCK_DIRT, world::FACE_POS_Y)
+    );
+}
@@ -0,0 +1,200 @@
+#include "common.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include "../chunkStreamer.hpp"
+#include "../lighting.hpp"
+#include "../regionFile.hpp"
+#include "../terrainGenerator.hpp"
+#include "../../util/threadPool.hpp"
+
+namespace world = ::vox::world;
+
+namespace {
+    //stands in for the render thread: records meshes and shows them at once
+    struct MeshSink {
+        void onMesh(world::ChunkStreamer::mesh_ptr mesh, std::function<void ()> onVisible) {
+            {//lock
+                boost::lock_guard<boost::mutex> lock(mutex);
+                order.push_back(mesh->pos);
+                meshed.insert(mesh->pos);
+            }//unlock
+
+            onVisible();
+        }
+
+        void onUnload(world::ChunkPos pos) {
+            boost::lock_guard<boost::mutex> lock(mutex);
+            meshed.erase(pos);
+        }
+
+        boost::mutex                 mutex;
+        std::vector<world::ChunkPos> order;
+        std::set<world::ChunkPos>    meshed;
+    };
+
+    void connect(world::ChunkStreamer& streamer, MeshSink& sink) {
+        streamer.setOnMeshReady([&sink](world::ChunkStreamer::mesh_ptr mesh, std::function<void ()> onVisible) {
+            sink.onMesh(mesh, onVisible);
+        });
+
+        streamer.setOnUnload([&sink](world::ChunkPos pos) { sink.onUnload(pos); });
+    }
+
+    void runUntilIdle(world::ChunkStreamer& streamer, world::StreamCamera const& camera) {
+        do {
+            streamer.update(camera);
+            boost::this_thread::yield();
+        } while (!streamer.isIdle());
+    }
+
+    world::StreamCamera cameraAt(float x, float z) {
+        world::StreamCamera camera;
+        camera.position  = Eigen::Vector3f(x, 80.0f, z);
+        camera.direction = Eigen::Vector3f(1.0f, 0.0f, 0.0f);
+        return camera;
+    }
+} //namespace anon
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(StreamerLoadsRadius)
+{
+    world::World             w;
+    world::LightEngine       light(w);
+    world::TerrainGenerator  generator(5);
+    vox::util::ThreadPool    pool(2);
+    MeshSink                 sink;
+
+    world::StreamerParams params;
+    params.loadRadius = 3;
+
+    world::ChunkStreamer streamer(w, light, generator, nullptr, pool, params);
+    connect(streamer, sink);
+
+    runUntilIdle(streamer, cameraAt(8.0f, 8.0f));
+
+    //the 29 chunks within 3 of the origin chunk
+    auto const metrics = streamer.metrics();
+    BOOST_CHECK_EQUAL(w.size(), 29u);
+    BOOST_CHECK_EQUAL(metrics.loaded, 29u);
+    BOOST_CHECK_EQUAL(metrics.visible, 29u);
+    BOOST_CHECK_EQUAL(metrics.inFlight, 0u);
+    BOOST_CHECK(metrics.memoryInUse > 29u * world::CHUNK_VOLUME * 2);
+    BOOST_CHECK(metrics.latencyMean > 0.0 && metrics.latencyMean <= metrics.latencyMax);
+
+    BOOST_CHECK_EQUAL(sink.meshed.size(), 29u);
+    BOOST_CHECK(sink.meshed.count(world::ChunkPos(3, 0)));
+    BOOST_CHECK(!sink.meshed.count(world::ChunkPos(3, 1)));
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(StreamerPriority)
+{
+    world::World             w;
+    world::LightEngine       light(w);
+    world::TerrainGenerator  generator(5);
+    vox::util::ThreadPool    pool(1);
+    MeshSink                 sink;
+
+    world::StreamerParams params;
+    params.loadRadius  = 4;
+    params.maxInFlight = 1;
+
+    world::ChunkStreamer streamer(w, light, generator, nullptr, pool, params);
+    connect(streamer, sink);
+
+    //looking down +x, so the chunks ahead are meshed before those behind
+    runUntilIdle(streamer, cameraAt(8.0f, 8.0f));
+
+    BOOST_REQUIRE(!sink.order.empty());
+
+    auto const ahead  = std::find(sink.order.begin(), sink.order.end(), world::ChunkPos(3, 0));
+    auto const behind = std::find(sink.order.begin(), sink.order.end(), world::ChunkPos(-3, 0));
+    BOOST_CHECK(ahead < behind);
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(StreamerMoveAndEvict)
+{
+    world::World             w;
+    world::LightEngine       light(w);
+    world::TerrainGenerator  generator(5);
+    vox::util::ThreadPool    pool(2);
+    MeshSink                 sink;
+
+    world::StreamerParams params;
+    params.loadRadius   = 2;
+    params.unloadMargin = 1;
+
+    world::ChunkStreamer streamer(w, light, generator, nullptr, pool, params);
+    connect(streamer, sink);
+
+    runUntilIdle(streamer, cameraAt(8.0f, 8.0f));
+
+    //the origin is settled; start loading around a second position and
+    //jump away before waiting on any of it. Nothing from either position
+    //may stay behind
+    streamer.update(cameraAt(8.0f + 16.0f * 5, 8.0f));
+    runUntilIdle(streamer, cameraAt(8.0f + 16.0f * 50, 8.0f));
+
+    auto const metrics = streamer.metrics();
+    BOOST_CHECK_EQUAL(w.size(), 13u);
+    BOOST_CHECK_EQUAL(metrics.loaded, 13u);
+    BOOST_CHECK(metrics.evicted >= 13u);
+    BOOST_CHECK(!w.find(world::ChunkPos(0, 0)));
+    BOOST_CHECK(w.find(world::ChunkPos(50, 0)));
+
+    BOOST_CHECK_EQUAL(sink.meshed.size(), 13u);
+    BOOST_CHECK(!sink.meshed.count(world::ChunkPos(0, 0)));
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(StreamerSaveFailure)
+{
+    world::World             w;
+    world::LightEngine       light(w);
+    world::TerrainGenerator  generator(5);
+    vox::util::ThreadPool    pool(2);
+
+    //every save throws: the directory doesn't exist
+    world::RegionStorage storage("./no_such_directory");
+
+    world::StreamerParams params;
+    params.loadRadius   = 2;
+    params.unloadMargin = 1;
+
+    world::ChunkStreamer streamer(w, light, generator, &storage, pool, params);
+
+    runUntilIdle(streamer, cameraAt(8.0f, 8.0f));
+    runUntilIdle(streamer, cameraAt(8.0f + 16.0f * 50, 8.0f));
+
+    //the origin's chunks were evicted but are still in the world
+    auto const metrics = streamer.metrics();
+    BOOST_CHECK_EQUAL(metrics.loaded, 13u);
+    BOOST_CHECK_EQUAL(metrics.unsaved, 13u);
+    BOOST_CHECK(metrics.saveFailed >= 13u);
+    BOOST_CHECK_EQUAL(w.size(), 26u);
+    BOOST_CHECK(w.find(world::ChunkPos(0, 0)));
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(StreamerMemoryBudget)
+{
+    world::World             w;
+    world::LightEngine       light(w);
+    world::TerrainGenerator  generator(5);
+    vox::util::ThreadPool    pool(2);
+
+    world::StreamerParams params;
+    params.loadRadius   = 8;
+    params.memoryBudget = 40 * world::CHUNK_VOLUME * 2;
+
+    world::ChunkStreamer streamer(w, light, generator, nullptr, pool, params);
+
+    runUntilIdle(streamer, cameraAt(8.0f, 8.0f));
+    runUntilIdle(streamer, cameraAt(8.0f, 8.0f));
+
+    auto const metrics = streamer.metrics();
+    BOOST_CHECK(metrics.loadRadius < params.loadRadius);
+    BOOST_CHECK(metrics.memoryInUse <= params.memoryBudget);
+    BOOST_CHECK(metrics.loaded > 0u);
+}
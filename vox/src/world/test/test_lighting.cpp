@@ -0,0 +1,148 @@
+#include "common.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include "../lighting.hpp"
+#include "../chunkMesher.hpp"
+#include "../../util/threadPool.hpp"
+
+namespace world = ::vox::world;
+
+namespace {
+    //flat stone floor at y < 10 over a 2x2 chunk area with a roof at y = 20
+    //covering the x < 0 half
+    void makeWorld(world::World& w, world::LightEngine& light) {
+        for (int cx = -1; cx <= 0; ++cx) {
+            for (int cz = -1; cz <= 0; ++cz) {
+                std::shared_ptr<world::Chunk> chunk(new world::Chunk(world::ChunkPos(cx, cz)));
+
+                for (unsigned x = 0; x < world::CHUNK_SIZE_X; ++x) {
+                    for (unsigned z = 0; z < world::CHUNK_SIZE_Z; ++z) {
+                        std::fill(chunk->column(x, z), chunk->column(x, z) + 10, world::BLOCK_STONE);
+                        if (cx < 0) {
+                            chunk->set(x, 20, z, world::BLOCK_STONE);
+                        }
+                    }
+                }
+
+                w.insert(chunk);
+                light.requestChunk(chunk->position());
+            }
+        }
+
+        light.process();
+    }
+
+    unsigned skyAt(world::World const& w, int x, int y, int z) {
+        auto const pos = world::ChunkPos::fromBlock(x, z);
+        return w.find(pos)->skyLight(world::Chunk::index(x - pos.blockX(), y, z - pos.blockZ()));
+    }
+
+    unsigned blockAt(world::World const& w, int x, int y, int z) {
+        auto const pos = world::ChunkPos::fromBlock(x, z);
+        return w.find(pos)->blockLight(world::Chunk::index(x - pos.blockX(), y, z - pos.blockZ()));
+    }
+
+    void setBlock(world::World& w, world::LightEngine& light, int x, int y, int z, world::BlockId id) {
+        auto const pos   = world::ChunkPos::fromBlock(x, z);
+        auto const chunk = w.find(pos);
+        auto const old   = chunk->get(x - pos.blockX(), y, z - pos.blockZ());
+
+        chunk->set(x - pos.blockX(), y, z - pos.blockZ(), id);
+        light.requestBlockChange(x, y, z, old);
+    }
+} //namespace anon
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(LightSky)
+{
+    world::World w;
+    world::LightEngine light(w);
+    makeWorld(w, light);
+
+    //open sky is fully lit down to the floor
+    BOOST_CHECK_EQUAL(skyAt(w, 5, 10, 5), world::LIGHT_MAX);
+    BOOST_CHECK_EQUAL(skyAt(w, 5, 9, 5), 0u);
+
+    //under the roof light falls off with distance from its edge, across the
+    //chunk border at x = 0
+    BOOST_CHECK_EQUAL(skyAt(w, -1, 10, 5), world::LIGHT_MAX - 1);
+    BOOST_CHECK_EQUAL(skyAt(w, -4, 10, 5), world::LIGHT_MAX - 4);
+    BOOST_CHECK_EQUAL(skyAt(w, -16, 15, 5), 0u);
+
+    //cutting a hole in the roof lets the sky straight down
+    setBlock(w, light, -8, 20, -8, world::BLOCK_AIR);
+    light.process();
+    BOOST_CHECK_EQUAL(skyAt(w, -8, 10, -8), world::LIGHT_MAX);
+    BOOST_CHECK_EQUAL(skyAt(w, -9, 10, -8), world::LIGHT_MAX - 1);
+
+    //and closing it leaves only the light from the edge of the roof
+    setBlock(w, light, -8, 20, -8, world::BLOCK_STONE);
+    light.process();
+    BOOST_CHECK_EQUAL(skyAt(w, -8, 10, -8), world::LIGHT_MAX - 8);
+    BOOST_CHECK_EQUAL(skyAt(w, -9, 10, -8), world::LIGHT_MAX - 9);
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(LightBlock)
+{
+    world::World w;
+    world::LightEngine light(w);
+    makeWorld(w, light);
+
+    vox::util::ThreadPool pool(2);
+
+    std::vector<world::ChunkPos> changed;
+    boost::mutex changedMutex;
+    light.setOnChunkChanged([&](world::ChunkPos pos) {
+        boost::lock_guard<boost::mutex> lock(changedMutex);
+        changed.push_back(pos);
+    });
+
+    //a lamp next to the chunk border lights both sides
+    setBlock(w, light, 1, 12, 1, world::BLOCK_LAMP);
+    light.schedule(pool);
+    while (!light.isIdle()) {
+        boost::this_thread::yield();
+    }
+
+    BOOST_CHECK_EQUAL(blockAt(w, 1, 12, 1), world::LIGHT_MAX);
+    BOOST_CHECK_EQUAL(blockAt(w, 0, 12, 1), world::LIGHT_MAX - 1);
+    BOOST_CHECK_EQUAL(blockAt(w, -3, 12, 1), world::LIGHT_MAX - 4);
+    BOOST_CHECK_EQUAL(blockAt(w, 1, 12, -2), world::LIGHT_MAX - 3);
+    BOOST_CHECK(changed.size() == 4);
+
+    //removing it clears everything it lit
+    setBlock(w, light, 1, 12, 1, world::BLOCK_AIR);
+    light.schedule(pool);
+    while (!light.isIdle()) {
+        boost::this_thread::yield();
+    }
+
+    BOOST_CHECK_EQUAL(blockAt(w, 1, 12, 1), 0u);
+    BOOST_CHECK_EQUAL(blockAt(w, -3, 12, 1), 0u);
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(LightBakedIntoMesh)
+{
+    world::World w;
+    world::LightEngine light(w);
+
+    std::shared_ptr<world::Chunk> chunk(new world::Chunk(world::ChunkPos(0, 0)));
+    chunk->set(4, 0, 4, world::BLOCK_STONE);
+    w.insert(chunk);
+    light.requestChunk(chunk->position());
+    light.process();
+
+    world::ChunkMesh mesh;
+    world::buildMesh(w, chunk->position(), mesh);
+
+    //5 faces, the bottom one is against the bottom of the world
+    BOOST_REQUIRE_EQUAL(mesh.vertices.size(), 5u*6u);
+
+    for (auto it = mesh.vertices.begin(); it != mesh.vertices.end(); ++it) {
+        BOOST_CHECK(it->faceId() != world::FACE_NEG_Y);
+        BOOST_CHECK_EQUAL(it->light >> 4, world::LIGHT_MAX);
+        BOOST_CHECK_EQUAL(it->block, world::BLOCK_STONE);
+    }
+}
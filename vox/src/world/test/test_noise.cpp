@@ -0,0 +1,102 @@
+#include "common.hpp"
+#include <boost/test/unit_test.hpp>
+#include <boost/chrono.hpp>
+#include <boost/random.hpp>
+
+#include "../noise.hpp"
+
+namespace world = ::vox::world;
+
+namespace {
+    struct Samples {
+        explicit Samples(unsigned n)
+            : x(n), y(n), z(n), out(n)
+        {
+            boost::mt19937 rng(42);
+            boost::uniform_real<float> coord(-1000.0f, 1000.0f);
+
+            for (unsigned i = 0; i < n; ++i) {
+                x[i] = coord(rng);
+                y[i] = coord(rng);
+                z[i] = coord(rng);
+            }
+        }
+
+        std::vector<float> x, y, z, out;
+    };
+
+    double secondsSince(boost::chrono::steady_clock::time_point start) {
+        return boost::chrono::duration<double>(boost::chrono::steady_clock::now() - start).count();
+    }
+} //namespace anon
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(NoiseBatchMatchesScalar)
+{
+    unsigned const n = 4099; //not a multiple of the vector width
+    Samples s(n);
+
+    world::Noise const noise(7);
+
+    noise.simplex2(&s.x[0], &s.y[0], &s.out[0], n);
+    for (unsigned i = 0; i < n; ++i) {
+        float const expected = noise.simplex2(s.x[i], s.y[i]);
+        BOOST_CHECK_SMALL(s.out[i] - expected, 1e-4f);
+        BOOST_CHECK(expected >= -1.0f && expected <= 1.0f);
+    }
+
+    noise.simplex3(&s.x[0], &s.y[0], &s.z[0], &s.out[0], n);
+    for (unsigned i = 0; i < n; ++i) {
+        float const expected = noise.simplex3(s.x[i], s.y[i], s.z[i]);
+        BOOST_CHECK_SMALL(s.out[i] - expected, 1e-4f);
+        BOOST_CHECK(expected >= -1.0f && expected <= 1.0f);
+    }
+
+    world::FbmParams const params(4, 1.0f / 64.0f);
+    noise.fbm2(&s.x[0], &s.y[0], &s.out[0], world::Noise::BATCH_MAX, params);
+    for (unsigned i = 0; i < world::Noise::BATCH_MAX; ++i) {
+        BOOST_CHECK_SMALL(s.out[i] - noise.fbm2(s.x[i], s.y[i], params), 1e-4f);
+    }
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(NoiseSeeded)
+{
+    world::Noise const a(1), b(1), c(2);
+
+    BOOST_CHECK_EQUAL(a.simplex3(0.3f, 1.7f, 2.9f), b.simplex3(0.3f, 1.7f, 2.9f));
+    BOOST_CHECK(a.simplex3(0.3f, 1.7f, 2.9f) != c.simplex3(0.3f, 1.7f, 2.9f));
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(NoiseBenchmark)
+{
+    unsigned const n      = 1 << 16;
+    unsigned const rounds = 32;
+    Samples s(n);
+
+    world::SimdLevel const levels[] = {world::SIMD_NONE, world::detectSimd()};
+    char const* const      names[]  = {"scalar", "sse4.1"};
+
+    for (unsigned l = 0; l < 2; ++l) {
+        world::Noise const noise(7, levels[l]);
+        if (noise.simd() != levels[l]) {
+            continue;
+        }
+
+        auto start = boost::chrono::steady_clock::now();
+        for (unsigned r = 0; r < rounds; ++r) {
+            noise.simplex2(&s.x[0], &s.y[0], &s.out[0], n);
+        }
+        double const time2 = secondsSince(start);
+
+        start = boost::chrono::steady_clock::now();
+        for (unsigned r = 0; r < rounds; ++r) {
+            noise.simplex3(&s.x[0], &s.y[0], &s.z[0], &s.out[0], n);
+        }
+        double const time3 = secondsSince(start);
+
+        BOOST_MESSAGE(boost::format("simplex2 %s: %.1f Msamples/sec") % names[l] % (n*rounds / time2 / 1e6));
+        BOOST_MESSAGE(boost::format("simplex3 %s: %.1f Msamples/sec") % names[l] % (n*rounds / time3 / 1e6));
+    }
+}
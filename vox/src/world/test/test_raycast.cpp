@@ -0,0 +1,155 @@
+#include "common.hpp"
+#include <boost/test/unit_test.hpp>
+#include <boost/chrono.hpp>
+#include <boost/random.hpp>
+
+#include "../raycast.hpp"
+#include "../../util/threadPool.hpp"
+
+namespace world = ::vox::world;
+
+namespace {
+    //rolling hills of stone under dirt, radius chunks around the origin
+    void makeTerrain(world::World& w, int radius) {
+        for (int cx = -radius; cx < radius; ++cx) {
+            for (int cz = -radius; cz < radius; ++cz) {
+                std::shared_ptr<world::Chunk> chunk(new world::Chunk(world::ChunkPos(cx, cz)));
+
+                for (unsigned x = 0; x < world::CHUNK_SIZE_X; ++x) {
+                    for (unsigned z = 0; z < world::CHUNK_SIZE_Z; ++z) {
+                        float const wx = static_cast<float>(chunk->position().blockX() + x);
+                        float const wz = static_cast<float>(chunk->position().blockZ() + z);
+                        unsigned const height = 48 + static_cast<unsigned>(
+                            8.0f*std::sin(wx*0.1f) + 8.0f*std::cos(wz*0.07f) + 16.0f
+                        );
+
+                        world::BlockId* const column = chunk->column(x, z);
+                        for (unsigned y = 0; y < height; ++y) {
+                            column[y] = y + 3 < height ? world::BLOCK_STONE : world::BLOCK_DIRT;
+                        }
+                    }
+                }
+
+                w.insert(chunk);
+            }
+        }
+    }
+
+    std::vector<world::Ray> randomRays(unsigned count, float extent) {
+        boost::mt19937 rng(1234);
+        boost::uniform_real<float> position(-extent, extent);
+        boost::uniform_real<float> height(60.0f, 120.0f);
+        boost::uniform_real<float> direction(-1.0f, 1.0f);
+
+        std::vector<world::Ray> result(count);
+        for (unsigned i = 0; i < count; ++i) {
+            result[i] = world::Ray(
+                Eigen::Vector3f(position(rng), height(rng), position(rng)),
+                Eigen::Vector3f(direction(rng), direction(rng) - 0.5f, direction(rng)),
+                128.0f
+            );
+        }
+
+        return result;
+    }
+
+    double secondsSince(boost::chrono::steady_clock::time_point start) {
+        return boost::chrono::duration<double>(boost::chrono::steady_clock::now() - start).count();
+    }
+} //namespace anon
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(RaycastHitsFace)
+{
+    world::World w;
+    std::shared_ptr<world::Chunk> chunk(new world::Chunk(world::ChunkPos(-1, 0)));
+    chunk->set(15, 10, 3, world::BLOCK_STONE); //world block (-1, 10, 3)
+    w.insert(chunk);
+
+    {   //straight down onto the top face
+        auto const hit = world::castRay(w, world::Ray(
+            Eigen::Vector3f(-0.5f, 20.5f, 3.5f), Eigen::Vector3f(0.0f, -1.0f, 0.0f), 64.0f
+        ));
+
+        BOOST_REQUIRE(hit.hit);
+        BOOST_CHECK(hit.block == Eigen::Vector3i(-1, 10, 3));
+        BOOST_CHECK(hit.normal == Eigen::Vector3i(0, 1, 0));
+        BOOST_CHECK_CLOSE(hit.distance, 9.5f, 0.001f);
+        BOOST_CHECK_EQUAL(hit.id, world::BLOCK_STONE);
+    }
+
+    {   //across the chunk border onto the -x face
+        auto const hit = world::castRay(w, world::Ray(
+            Eigen::Vector3f(-4.5f, 10.5f, 3.5f), Eigen::Vector3f(1.0f, 0.0f, 0.0f), 64.0f
+        ));
+
+        BOOST_REQUIRE(hit.hit);
+        BOOST_CHECK(hit.block == Eigen::Vector3i(-1, 10, 3));
+        BOOST_CHECK(hit.normal == Eigen::Vector3i(-1, 0, 0));
+        BOOST_CHECK_CLOSE(hit.distance, 3.5f, 0.001f);
+    }
+
+    {   //out of range
+        auto const hit = world::castRay(w, world::Ray(
+            Eigen::Vector3f(-0.5f, 20.5f, 3.5f), Eigen::Vector3f(0.0f, -1.0f, 0.0f), 5.0f
+        ));
+
+        BOOST_CHECK(!hit.hit);
+    }
+
+    {   //starting inside a block
+        auto const hit = world::castRay(w, world::Ray(
+            Eigen::Vector3f(-0.5f, 10.5f, 3.5f), Eigen::Vector3f(0.0f, 1.0f, 0.0f), 5.0f
+        ));
+
+        BOOST_CHECK(hit.hit);
+        BOOST_CHECK(hit.normal == Eigen::Vector3i(0, 0, 0));
+        BOOST_CHECK_EQUAL(hit.distance, 0.0f);
+    }
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(RaycastBatchMatchesSingle)
+{
+    world::World w;
+    makeTerrain(w, 2);
+
+    auto const rays = randomRays(4096, 32.0f);
+
+    vox::util::ThreadPool pool;
+    std::vector<world::RayHit> hits;
+    world::castRays(w, rays, hits, pool);
+
+    BOOST_REQUIRE_EQUAL(hits.size(), rays.size());
+
+    for (unsigned i = 0; i < rays.size(); ++i) {
+        auto const expected = world::castRay(w, rays[i]);
+        BOOST_CHECK_EQUAL(hits[i].hit, expected.hit);
+        BOOST_CHECK(hits[i].block == expected.block);
+    }
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(RaycastBenchmark)
+{
+    world::World w;
+    makeTerrain(w, 8);
+
+    auto const rays = randomRays(1 << 18, 128.0f);
+    std::vector<world::RayHit> hits(rays.size());
+
+    auto start = boost::chrono::steady_clock::now();
+    for (unsigned i = 0; i < rays.size(); ++i) {
+        hits[i] = world::castRay(w, rays[i]);
+    }
+    double const single = secondsSince(start);
+
+    vox::util::ThreadPool pool;
+
+    start = boost::chrono::steady_clock::now();
+    world::castRays(w, rays, hits, pool);
+    double const batched = secondsSince(start);
+
+    BOOST_MESSAGE(boost::format("castRay:  %.0f rays/sec") % (rays.size() / single));
+    BOOST_MESSAGE(boost::format("castRays: %.0f rays/sec (%u workers)") % (rays.size() / batched) % pool.size());
+}
@@ -0,0 +1,185 @@
+#include "common.hpp"
+#include <cstdio>
+#include <boost/test/unit_test.hpp>
+#include <boost/chrono.hpp>
+
+#include "../regionFile.hpp"
+#include "../terrainGenerator.hpp"
+
+namespace world = ::vox::world;
+
+namespace {
+    char const* const TEST_REGION = "test_region.vxr";
+
+    //removes the region file before and after a test
+    struct RegionFixture {
+        RegionFixture()  { std::remove(TEST_REGION); }
+        ~RegionFixture() { std::remove(TEST_REGION); }
+    };
+
+    bool sameChunk(world::Chunk const& a, world::Chunk const& b) {
+        return std::equal(a.blocks(), a.blocks() + world::CHUNK_VOLUME, b.blocks())
+            && std::equal(a.light(), a.light() + world::CHUNK_VOLUME, b.light());
+    }
+
+    //fill the first count light values with noise that doesn't compress
+    void fillNoisy(world::Chunk& chunk, unsigned seed, unsigned count = world::CHUNK_VOLUME) {
+        unsigned state = seed * 2654435761u + 1;
+        for (unsigned i = 0; i < count; ++i) {
+            state = state * 1664525u + 1013904223u;
+            chunk.light()[i] = static_cast<unsigned char>(state >> 24);
+        }
+    }
+
+    double secondsSince(boost::chrono::steady_clock::time_point start) {
+        return boost::chrono::duration<double>(boost::chrono::steady_clock::now() - start).count();
+    }
+} //namespace anon
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(RegionPosFromChunk)
+{
+    BOOST_CHECK(world::RegionPos::fromChunk(world::ChunkPos(0, 31)) == world::RegionPos(0, 0));
+    BOOST_CHECK(world::RegionPos::fromChunk(world::ChunkPos(32, -1)) == world::RegionPos(1, -1));
+    BOOST_CHECK(world::RegionPos::fromChunk(world::ChunkPos(-32, -33)) == world::RegionPos(-1, -2));
+}
+
+//____________________________________________________________________________//
+BOOST_FIXTURE_TEST_CASE(RegionRoundTrip, RegionFixture)
+{
+    world::TerrainGenerator const generator(3);
+
+    world::Chunk stored(world::ChunkPos(-3, 5));
+    generator.generate(stored);
+    stored.light()[100] = 0x5A;
+
+    {
+        world::RegionFile region(TEST_REGION);
+        BOOST_CHECK(!region.has(stored.position()));
+
+        region.save(stored);
+        BOOST_CHECK(region.has(stored.position()));
+
+        world::Chunk loaded(stored.position());
+        BOOST_REQUIRE(region.load(loaded));
+        BOOST_CHECK(sameChunk(stored, loaded));
+
+        world::Chunk missing(world::ChunkPos(-4, 5));
+        BOOST_CHECK(!region.load(missing));
+    }
+
+    //and again after reopening the file
+    world::RegionFile region(TEST_REGION);
+
+    world::Chunk loaded(stored.position());
+    BOOST_REQUIRE(region.load(loaded));
+    BOOST_CHECK(sameChunk(stored, loaded));
+}
+
+//____________________________________________________________________________//
+BOOST_FIXTURE_TEST_CASE(RegionSectorReuse, RegionFixture)
+{
+    world::RegionFile region(TEST_REGION);
+
+    world::Chunk big(world::ChunkPos(0, 0));
+    fillNoisy(big, 1);
+    region.save(big, world::RegionFile::CODEC_NONE);
+    unsigned const afterBig = region.sectorCount();
+
+    //a chunk that shrinks stays where it was
+    world::Chunk small(world::ChunkPos(0, 0));
+    region.save(small);
+    BOOST_CHECK_EQUAL(region.sectorCount(), afterBig);
+
+    //and the sectors it freed are reused by the next chunk that fits
+    world::Chunk other(world::ChunkPos(1, 0));
+    fillNoisy(other, 2, world::CHUNK_VOLUME / 4);
+    region.save(other);
+    BOOST_CHECK_EQUAL(region.sectorCount(), afterBig);
+
+    //growing the first chunk again has to move it to the end
+    region.save(big, world::RegionFile::CODEC_NONE);
+    BOOST_CHECK(region.sectorCount() > afterBig);
+
+    world::Chunk loaded(world::ChunkPos(0, 0));
+    BOOST_REQUIRE(region.load(loaded));
+    BOOST_CHECK(sameChunk(big, loaded));
+
+    world::Chunk loadedOther(world::ChunkPos(1, 0));
+    BOOST_REQUIRE(region.load(loadedOther));
+    BOOST_CHECK(sameChunk(other, loadedOther));
+}
+
+//____________________________________________________________________________//
+BOOST_FIXTURE_TEST_CASE(RegionCorrupt, RegionFixture)
+{
+    {
+        world::RegionFile region(TEST_REGION);
+        region.save(world::Chunk(world::ChunkPos(2, 2)));
+    }
+
+    {//point the chunk past the end of the file
+        std::fstream file(TEST_REGION, std::ios::binary | std::ios::in | std::ios::out);
+        unsigned const entry[2] = {1000, 100};
+        file.seekp((2 * world::REGION_SIZE + 2) * sizeof(entry));
+        file.write(reinterpret_cast<char const*>(entry), sizeof(entry));
+    }
+
+    BOOST_CHECK_THROW(world::RegionFile region(TEST_REGION), world::error::corrupt_region);
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(RegionStorageTiming)
+{
+    std::vector<std::string> files;
+
+    {//region files can't be removed while they are mapped
+        world::RegionStorage storage(".");
+
+        files.push_back(storage.fileName(world::RegionPos(-1, -1)));
+        files.push_back(storage.fileName(world::RegionPos(-1, 0)));
+        files.push_back(storage.fileName(world::RegionPos(0, -1)));
+        files.push_back(storage.fileName(world::RegionPos(0, 0)));
+
+        std::for_each(files.begin(), files.end(), [](std::string const& f) { std::remove(f.c_str()); });
+
+        world::TerrainGenerator const generator(11);
+
+        //spans the four regions around the origin
+        std::vector<world::World::chunk_ptr> chunks;
+        for (int x = -8; x < 8; ++x) {
+            for (int z = -8; z < 8; ++z) {
+                world::World::chunk_ptr chunk(new world::Chunk(world::ChunkPos(x, z)));
+                generator.generate(*chunk);
+                chunks.push_back(chunk);
+            }
+        }
+
+        auto start = boost::chrono::steady_clock::now();
+        std::for_each(chunks.begin(), chunks.end(), [&](world::World::chunk_ptr const& c) {
+            storage.save(*c);
+        });
+        double const saveTime = secondsSince(start);
+
+        unsigned mismatches = 0;
+
+        start = boost::chrono::steady_clock::now();
+        std::for_each(chunks.begin(), chunks.end(), [&](world::World::chunk_ptr const& c) {
+            auto const loaded = storage.load(c->position());
+            mismatches += !loaded || !sameChunk(*c, *loaded);
+        });
+        double const loadTime = secondsSince(start);
+
+        BOOST_CHECK_EQUAL(mismatches, 0u);
+
+        //loading from a region that was never written doesn't create it
+        BOOST_CHECK(!storage.load(world::ChunkPos(100, 100)));
+        BOOST_CHECK(!std::ifstream(storage.fileName(world::RegionPos(3, 3))));
+
+        double const mb = chunks.size() * world::CHUNK_VOLUME * 2 / (1024.0 * 1024.0);
+        BOOST_MESSAGE(boost::format("region save: %.0f chunks/sec (%.1f MB/s uncompressed)") % (chunks.size() / saveTime) % (mb / saveTime));
+        BOOST_MESSAGE(boost::format("region load: %.0f chunks/sec (%.1f MB/s uncompressed)") % (chunks.size() / loadTime) % (mb / loadTime));
+    }
+
+    std::for_each(files.begin(), files.end(), [](std::string const& f) { std::remove(f.c_str()); });
+}
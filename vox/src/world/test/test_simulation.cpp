@@ -0,0 +1,128 @@
+#include "common.hpp"
+#include <boost/test/unit_test.hpp>
+#include <boost/chrono.hpp>
+
+#include "../simulation.hpp"
+#include "../chunkStreamer.hpp"
+#include "../lighting.hpp"
+#include "../terrainGenerator.hpp"
+#include "../../util/threadPool.hpp"
+
+namespace world = ::vox::world;
+
+namespace {
+    float const PI = 3.14159265f;
+
+    //where view puts the camera's position; always the origin
+    Eigen::Vector4f eye(world::CameraState const& camera, Eigen::Matrix4f const& view) {
+        return view * Eigen::Vector4f(camera.position.x(), camera.position.y(), camera.position.z(), 1.0f);
+    }
+} //namespace anon
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(CameraStateView)
+{
+    world::CameraState camera;
+    camera.position = Eigen::Vector3f(10.0f, 80.0f, -4.0f);
+    camera.yaw      = PI / 2.0f;
+
+    //a quarter turn left looks down -x
+    Eigen::Vector3f const dir = camera.direction();
+    BOOST_CHECK_CLOSE(dir.x(), -1.0f, 0.01);
+    BOOST_CHECK_SMALL(dir.z(), 0.0001f);
+
+    Eigen::Matrix4f const view = camera.view();
+    BOOST_CHECK_SMALL(eye(camera, view).head<3>().norm(), 0.001f);
+
+    //a point ahead of the camera is at -z in view space
+    Eigen::Vector3f const ahead = camera.position + dir * 5.0f;
+    Eigen::Vector4f const v = view * Eigen::Vector4f(ahead.x(), ahead.y(), ahead.z(), 1.0f);
+    BOOST_CHECK_CLOSE(v.z(), -5.0f, 0.01);
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(CameraStateLerp)
+{
+    world::CameraState a;
+    world::CameraState b;
+    b.position = Eigen::Vector3f(4.0f, 0.0f, 0.0f);
+
+    //from just under a full turn to just over none: the short way is 0.2
+    a.yaw = 2.0f * PI - 0.1f;
+    b.yaw = 0.1f;
+
+    world::CameraState const half = world::CameraState::lerp(a, b, 0.5f);
+    BOOST_CHECK_CLOSE(half.position.x(), 2.0f, 0.01);
+    BOOST_CHECK_SMALL(std::sin(half.yaw), 0.0001f);
+    BOOST_CHECK_CLOSE(std::cos(half.yaw), 1.0f, 0.01);
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(SnapshotInterpolates)
+{
+    typedef world::RenderSnapshot::clock clock;
+
+    world::RenderSnapshot snapshot;
+    snapshot.tick       = 1;
+    snapshot.time       = clock::now();
+    snapshot.tickLength = boost::chrono::milliseconds(100);
+    snapshot.current.position = Eigen::Vector3f(10.0f, 0.0f, 0.0f);
+
+    //a tick behind: previous when the tick is new, current once it's a tick old
+    Eigen::Matrix4f const start = snapshot.view(snapshot.time);
+    Eigen::Matrix4f const mid   = snapshot.view(snapshot.time + boost::chrono::milliseconds(50));
+    Eigen::Matrix4f const late  = snapshot.view(snapshot.time + boost::chrono::milliseconds(500));
+
+    BOOST_CHECK_SMALL(start(0, 3), 0.001f);
+    BOOST_CHECK_CLOSE(mid(0, 3),  -5.0f,  0.01);
+    BOOST_CHECK_CLOSE(late(0, 3), -10.0f, 0.01);
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(SimulationPublishesTicks)
+{
+    world::World            w;
+    world::LightEngine      light(w);
+    world::TerrainGenerator generator(5);
+    vox::util::ThreadPool   pool(2);
+
+    world::StreamerParams params;
+    params.loadRadius = 1;
+
+    world::ChunkStreamer streamer(w, light, generator, nullptr, pool, params);
+
+    world::Simulation sim(streamer, 100.0f);
+
+    world::CameraState camera;
+    camera.position = Eigen::Vector3f(8.0f, 80.0f, 8.0f);
+    sim.setCamera(camera);
+    sim.setVelocity(Eigen::Vector3f(100.0f, 0.0f, 0.0f));
+
+    sim.start();
+
+    //stands in for the render thread
+    unsigned last  = 0;
+    unsigned reads = 0;
+    auto const until = boost::chrono::steady_clock::now() + boost::chrono::milliseconds(200);
+
+    while (boost::chrono::steady_clock::now() < until) {
+        if (sim.snapshots().acquire()) {
+            world::RenderSnapshot const& snapshot = sim.snapshots().front();
+
+            BOOST_REQUIRE_GT(snapshot.tick, last);
+            last = snapshot.tick;
+            ++reads;
+
+            //1 block a tick
+            BOOST_CHECK_CLOSE(snapshot.current.position.x() - snapshot.previous.position.x(), 1.0f, 0.01);
+        }
+
+        boost::this_thread::sleep_for(boost::chrono::milliseconds(3));
+    }
+
+    sim.stop();
+
+    BOOST_CHECK_GE(last, 10u);
+    BOOST_CHECK_GT(reads, 0u);
+    BOOST_CHECK(w.size() > 0);
+}
@@ -0,0 +1,86 @@
+#include "common.hpp"
+#include <boost/test/unit_test.hpp>
+#include <boost/chrono.hpp>
+
+#include "../terrainGenerator.hpp"
+#include "../../util/threadPool.hpp"
+
+namespace world = ::vox::world;
+
+namespace {
+    std::vector<world::ChunkPos> square(int radius) {
+        std::vector<world::ChunkPos> result;
+        for (int x = -radius; x < radius; ++x) {
+            for (int z = -radius; z < radius; ++z) {
+                result.push_back(world::ChunkPos(x, z));
+            }
+        }
+
+        return result;
+    }
+
+    double secondsSince(boost::chrono::steady_clock::time_point start) {
+        return boost::chrono::duration<double>(boost::chrono::steady_clock::now() - start).count();
+    }
+} //namespace anon
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(TerrainDeterministic)
+{
+    world::TerrainGenerator const scalar(99, world::TerrainParams(), world::SIMD_NONE);
+    world::TerrainGenerator const simd(99);
+
+    world::Chunk a(world::ChunkPos(3, -5));
+    world::Chunk b(world::ChunkPos(3, -5));
+
+    scalar.generate(a);
+    simd.generate(b);
+
+    unsigned differences = 0;
+    for (unsigned i = 0; i < world::CHUNK_VOLUME; ++i) {
+        differences += a.blocks()[i] != b.blocks()[i];
+    }
+
+    //the instruction sets only differ in rounding, so allow for the odd
+    //block landing on the other side of a threshold
+    BOOST_CHECK(differences < world::CHUNK_VOLUME / 1000);
+
+    //bedrock layer is never carved and the sky is always open
+    for (unsigned x = 0; x < world::CHUNK_SIZE_X; ++x) {
+        for (unsigned z = 0; z < world::CHUNK_SIZE_Z; ++z) {
+            BOOST_CHECK(world::isOpaque(a.get(x, 0, z)));
+            BOOST_CHECK_EQUAL(a.get(x, world::CHUNK_SIZE_Y - 1, z), world::BLOCK_AIR);
+        }
+    }
+}
+
+//____________________________________________________________________________//
+BOOST_AUTO_TEST_CASE(TerrainBenchmark)
+{
+    auto const positions = square(8);
+    world::TerrainGenerator const generator(1);
+
+    {
+        world::World w;
+        vox::util::ThreadPool pool(1);
+
+        auto const start = boost::chrono::steady_clock::now();
+        generator.generate(w, positions, pool);
+        double const time = secondsSince(start);
+
+        BOOST_CHECK_EQUAL(w.size(), positions.size());
+        BOOST_MESSAGE(boost::format("terrain, 1 worker: %.1f chunks/sec") % (positions.size() / time));
+    }
+
+    {
+        world::World w;
+        vox::util::ThreadPool pool;
+
+        auto const start = boost::chrono::steady_clock::now();
+        generator.generate(w, positions, pool);
+        double const time = secondsSince(start);
+
+        BOOST_CHECK_EQUAL(w.size(), positions.size());
+        BOOST_MESSAGE(boost::format("terrain, %u workers: %.1f chunks/sec") % pool.size() % (positions.size() / time));
+    }
+}
@@ -0,0 +1,68 @@
+#include "common.hpp"
+#include "world.hpp"
+
+namespace world = ::vox::world;
+
+world::World::chunk_ptr
+world::World::find(ChunkPos pos) const
+{
+    boost::shared_lock<boost::shared_mutex> lock(mutex_);
+
+    auto const it = chunks_.find(pos);
+    return it != chunks_.end() ? it->second : chunk_ptr();
+}
+
+void
+world::World::insert(chunk_ptr chunk)
+{
+    assert(chunk);
+
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    chunks_[chunk->position()] = chunk;
+}
+
+void
+world::World::erase(ChunkPos pos)
+{
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    chunks_.erase(pos);
+}
+
+std::vector<world::ChunkPos>
+world::World::positions() const
+{
+    boost::shared_lock<boost::shared_mutex> lock(mutex_);
+
+    std::vector<ChunkPos> result;
+    result.reserve(chunks_.size());
+
+    for (auto it = chunks_.begin(); it != chunks_.end(); ++it) {
+        result.push_back(it->first);
+    }
+
+    return result;
+}
+
+unsigned
+world::World::size() const
+{
+    boost::shared_lock<boost::shared_mutex> lock(mutex_);
+    return chunks_.size();
+}
+
+world::BlockId
+world::World::getBlock(int x, int y, int z) const
+{
+    if (y < 0 || y >= static_cast<int>(CHUNK_SIZE_Y)) {
+        return BLOCK_AIR;
+    }
+
+    auto const pos   = ChunkPos::fromBlock(x, z);
+    auto const chunk = find(pos);
+
+    if (!chunk) {
+        return BLOCK_AIR;
+    }
+
+    return chunk->get(x - pos.blockX(), y, z - pos.blockZ());
+}
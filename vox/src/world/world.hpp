@@ -0,0 +1,47 @@
+#pragma once
+#ifndef VOX_WORLD_WORLD_HPP
+#define VOX_WORLD_WORLD_HPP
+
+#include <map>
+#include <vector>
+#include <memory>
+#include <boost/thread.hpp>
+
+#include "chunk.hpp"
+
+namespace vox {
+    namespace world {
+
+    ////////////////////////////////////////////////////////////////////////////
+    // The set of loaded chunks. Lookups may happen from any thread; hot loops
+    // should hold on to the returned chunk rather than looking up per block.
+    ////////////////////////////////////////////////////////////////////////////
+    class World : private boost::noncopyable {
+    public:
+        typedef std::shared_ptr<Chunk>       chunk_ptr;
+        typedef std::shared_ptr<Chunk const> const_chunk_ptr;
+
+        //nullptr if the chunk isn't loaded
+        chunk_ptr find(ChunkPos pos) const;
+
+        //insert chunk, replacing any chunk already at its position
+        void insert(chunk_ptr chunk);
+        void erase(ChunkPos pos);
+
+        std::vector<ChunkPos> positions() const;
+        unsigned size() const;
+
+        //block at world position (x, y, z); air if the chunk isn't loaded or
+        //y is outside the world
+        BlockId getBlock(int x, int y, int z) const;
+    private:
+        typedef std::map<ChunkPos, chunk_ptr> chunks_container_t;
+
+        mutable boost::shared_mutex mutex_;
+        chunks_container_t          chunks_;
+    };
+
+    } //namespace world
+} //namespace vox
+
+#endif //VOX_WORLD_WORLD_HPP